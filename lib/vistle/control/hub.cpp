@@ -1407,6 +1407,9 @@ bool Hub::hubReady()
 
         params.setCurrentParameterGroup("");
 
+        params.addIntParameter("trace_pipeline", "record timing of pipeline executions on all ranks", false,
+                               Parameter::Boolean);
+
         for (auto s: m_slavesToConnect) {
             auto set = make.message<message::SetId>(s->id);
             sendMessage(s->sock, set);
@@ -235,4 +235,45 @@ std::shared_ptr<ArrayLoader::ArrayOwner> ArrayLoader::owner() const
     return m_unreffer;
 }
 
+namespace {
+
+struct ArrayReferencer {
+    ArrayReferencer(const std::string &name, unsigned type): m_name(name), m_type(type) {}
+
+    template<typename T>
+    void operator()(T)
+    {
+        if (shm_array<T, typename shm<T>::allocator>::typeId() != m_type)
+            return;
+        auto arr = Shm::the().getArrayFromName<T>(m_name);
+        if (arr)
+            m_owner.reset(new ArrayLoader::Unreffer<T>(arr));
+    }
+
+    std::string m_name;
+    unsigned m_type;
+    std::shared_ptr<ArrayLoader::ArrayOwner> m_owner;
+};
+
+} // namespace
+
+bool ArrayLoader::findByHash(const std::string &hash, int type, std::string &name, std::shared_ptr<ArrayOwner> &owner)
+{
+    if (hash.empty())
+        return false;
+    std::string local = Shm::the().findArrayByHash(hash);
+    if (local.empty())
+        return false;
+
+    // keep array referenced, as it might be deleted before it has been attached to an object
+    ArrayReferencer ref(local, type);
+    boost::mpl::for_each<VectorTypes>(boost::reference_wrapper<ArrayReferencer>(ref));
+    if (!ref.m_owner)
+        return false;
+
+    name = local;
+    owner = ref.m_owner;
+    return true;
+}
+
 } // namespace vistle
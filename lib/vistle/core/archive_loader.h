@@ -71,6 +71,8 @@ struct V_COREEXPORT ArrayLoader {
     bool load();
     const std::string &name() const;
     std::shared_ptr<ArrayOwner> owner() const;
+    //! look up a local array with the same content hash instead of loading it from archive
+    static bool findByHash(const std::string &hash, int type, std::string &name, std::shared_ptr<ArrayOwner> &owner);
 
     bool m_ok;
     std::string m_arname; //<! name in archive
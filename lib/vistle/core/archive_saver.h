@@ -66,6 +66,45 @@ struct V_COREEXPORT ArraySaver {
     const void *m_array = nullptr;
 };
 
+//! compute the content hash of an array identified by name and type id, cf. Shm::arrayHash
+struct V_COREEXPORT ArrayHasher {
+    ArrayHasher(const std::string &name, int type): m_ok(false), m_name(name), m_type(type), m_size(0) {}
+    ArrayHasher() = delete;
+    ArrayHasher(const ArrayHasher &other) = delete;
+
+    template<typename T>
+    void operator()(T)
+    {
+        if (shm_array<T, typename shm<T>::allocator>::typeId() != m_type)
+            return;
+
+        auto arr = Shm::the().getArrayFromName<T>(m_name);
+        if (!arr) {
+            std::cerr << "ArrayHasher: did not find data array " << m_name << std::endl;
+            return;
+        }
+        m_size = arr->size() * sizeof(T);
+        m_hash = Shm::the().arrayHash(m_name, m_type, arr->data(), m_size);
+        m_ok = true;
+    }
+
+    bool compute()
+    {
+        boost::mpl::for_each<VectorTypes>(boost::reference_wrapper<ArrayHasher>(*this));
+        return m_ok;
+    }
+
+    const std::string &hash() const { return m_hash; }
+    //! size of array contents in bytes
+    size_t size() const { return m_size; }
+
+    bool m_ok;
+    std::string m_name;
+    unsigned m_type;
+    size_t m_size;
+    std::string m_hash;
+};
+
 class V_COREEXPORT DeepArchiveSaver: public Saver, public std::enable_shared_from_this<DeepArchiveSaver> {
 public:
     void saveArray(const std::string &name, int type, const void *array) override;
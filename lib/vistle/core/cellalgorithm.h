@@ -6,6 +6,11 @@
 #include "celltree.h"
 #include "grid.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
 namespace vistle {
 
 V_COREEXPORT Vector3 trilinearInverse(const Vector3 &p0, const Vector3 p[8]);
@@ -225,5 +230,196 @@ public:
     std::vector<Intersection> intersections;
 };
 
+//! SoA packet of up to PacketSize query points for Celltree::traversePacket
+template<typename Scalar, typename Index>
+class PointPacketVisitationFunctor {
+    typedef vistle::Celltree<Scalar, Index> Celltree;
+
+public:
+    static const int PacketSize = 16;
+
+    PointPacketVisitationFunctor(): m_size(0) {}
+
+    int size() const { return m_size; }
+    void clear() { m_size = 0; }
+    //! add point to packet, return its bit in the packet mask
+    uint32_t add(const Vector3 &point)
+    {
+        assert(m_size < PacketSize);
+        for (int c = 0; c < 3; ++c)
+            m_coord[c][m_size] = point[c];
+        return uint32_t(1) << m_size++;
+    }
+    Vector3 point(int i) const { return Vector3(m_coord[0][i], m_coord[1][i], m_coord[2][i]); }
+
+    bool operator()(const typename Celltree::Node &node, uint32_t mask, uint32_t &left, uint32_t &right) const
+    {
+        // branch-free comparisons over all points of the packet, so that these loops can be vectorized
+        const Scalar *c = m_coord[node.dim];
+        const Scalar Lmax = node.Lmax, Rmin = node.Rmin;
+        const Scalar mean = Scalar(0.5) * (Lmax + Rmin);
+        uint32_t l = 0, r = 0, above = 0;
+        for (int i = 0; i < PacketSize; ++i) {
+            l |= uint32_t(c[i] <= Lmax) << i;
+            r |= uint32_t(c[i] >= Rmin) << i;
+            above |= uint32_t(c[i] >= mean) << i;
+        }
+        left = l & mask;
+        right = r & mask;
+        // visit subtree first that is preferred by the majority of points
+        return 2 * popcount(above & mask) > popcount(mask);
+    }
+
+private:
+    static int popcount(uint32_t m)
+    {
+        int n = 0;
+        for (; m; m &= m - 1)
+            ++n;
+        return n;
+    }
+
+    int m_size;
+    Scalar m_coord[3][PacketSize] = {};
+};
+
+template<class Grid, typename Scalar, typename Index>
+class PointPacketInclusionFunctor {
+public:
+    PointPacketInclusionFunctor(const Grid *grid, const PointPacketVisitationFunctor<Scalar, Index> &packet,
+                                Index *cells, bool acceptGhost = false)
+    : m_grid(grid), m_packet(packet), m_cells(cells), m_acceptGhost(acceptGhost)
+    {}
+
+    uint32_t operator()(Index elem)
+    {
+        return (*this)(elem, (uint32_t(1) << m_packet.size()) - 1);
+    }
+
+    uint32_t operator()(Index elem, uint32_t mask)
+    {
+        if (!m_acceptGhost && m_grid->isGhostCell(elem))
+            return mask;
+        for (uint32_t m = mask; m; m &= m - 1) {
+            int i = 0;
+            while (!(m & (uint32_t(1) << i)))
+                ++i;
+            if (m_grid->Grid::inside(elem, m_packet.point(i))) {
+                m_cells[i] = elem;
+                mask &= ~(uint32_t(1) << i);
+            }
+        }
+        return mask;
+    }
+
+private:
+    const Grid *m_grid;
+    const PointPacketVisitationFunctor<Scalar, Index> &m_packet;
+    Index *m_cells;
+    bool m_acceptGhost;
+};
+
+//! interleave the lower 10 bits of x, y and z
+inline uint32_t mortonCode(uint32_t x, uint32_t y, uint32_t z)
+{
+    auto spread = [](uint32_t v) -> uint32_t {
+        v &= 0x3ff;
+        v = (v | (v << 16)) & 0x030000ff;
+        v = (v | (v << 8)) & 0x0300f00f;
+        v = (v | (v << 4)) & 0x030c30c3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+}
+
+//! locate many points within grid with the help of its celltree
+/*! points are processed in Morton order, so that consecutive queries are close in space:
+ *  the cell found for a point is tried first for its successors,
+ *  and the remaining points are grouped into packets which traverse the celltree together */
+template<class Grid>
+void findCellsWithCelltree(const Grid *grid, const Celltree<Scalar, Index> &celltree, Index numPoints,
+                           const Vector3 *points, Index *cells, bool acceptGhost)
+{
+    typedef PointPacketVisitationFunctor<Scalar, Index> Packet;
+
+    const Scalar *gmin = celltree.min(), *gmax = celltree.max();
+    Vector3 scale(0, 0, 0);
+    for (int c = 0; c < 3; ++c) {
+        if (gmax[c] > gmin[c])
+            scale[c] = Scalar(1023) / (gmax[c] - gmin[c]);
+    }
+
+    std::vector<std::pair<uint32_t, Index>> order;
+    order.reserve(numPoints);
+    for (Index i = 0; i < numPoints; ++i) {
+        cells[i] = InvalidIndex;
+        const auto &p = points[i];
+        bool outside = false;
+        uint32_t q[3];
+        for (int c = 0; c < 3; ++c) {
+            // also rejects NaN, which would make the conversion to integer undefined
+            if (!(p[c] >= gmin[c] && p[c] <= gmax[c])) {
+                outside = true;
+                break;
+            }
+            q[c] = uint32_t((p[c] - gmin[c]) * scale[c]);
+        }
+        if (!outside)
+            order.emplace_back(mortonCode(q[0], q[1], q[2]), i);
+    }
+    std::sort(order.begin(), order.end());
+
+    Packet packet;
+    Index packetIndex[Packet::PacketSize];
+    Index packetCells[Packet::PacketSize];
+    PointPacketInclusionFunctor<Grid, Scalar, Index> elemFunc(grid, packet, packetCells, acceptGhost);
+    Index lastCell = InvalidIndex;
+    auto flush = [&]() {
+        if (packet.size() == 0)
+            return;
+        const uint32_t active = (uint32_t(1) << packet.size()) - 1;
+        for (int i = 0; i < packet.size(); ++i)
+            packetCells[i] = InvalidIndex;
+        celltree.traversePacket(packet, elemFunc, active);
+        for (int i = 0; i < packet.size(); ++i) {
+            cells[packetIndex[i]] = packetCells[i];
+            if (packetCells[i] != InvalidIndex)
+                lastCell = packetCells[i];
+        }
+        packet.clear();
+    };
+
+    for (const auto &o: order) {
+        const Index i = o.second;
+        if (lastCell != InvalidIndex && grid->Grid::inside(lastCell, points[i])) {
+            cells[i] = lastCell;
+            continue;
+        }
+        packetIndex[packet.size()] = i;
+        packet.add(points[i]);
+        if (packet.size() == Packet::PacketSize)
+            flush();
+    }
+    flush();
+}
+
+//! implementation of GridInterface::findCells for grids with a celltree
+/*! calls to Grid::inside are resolved statically */
+template<class Grid>
+void findCells(const Grid *grid, Index numPoints, const Vector3 *points, Index *cells, int flags)
+{
+    const bool acceptGhost = flags & GridInterface::AcceptGhost;
+    const bool useCelltree =
+        (flags & GridInterface::ForceCelltree) || (grid->hasCelltree() && !(flags & GridInterface::NoCelltree));
+
+    if (!useCelltree) {
+        grid->GridInterface::findCells(numPoints, points, cells, flags);
+        return;
+    }
+
+    findCellsWithCelltree(grid, *grid->getCelltree(), numPoints, points, cells, acceptGhost);
+}
+
 } // namespace vistle
 #endif
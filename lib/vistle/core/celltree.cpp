@@ -4,8 +4,41 @@
 #include "shm_reference_impl.h"
 #include "archives.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
 namespace vistle {
 
+template<typename Scalar, typename Index, int NumDimensions>
+std::atomic<int> Celltree<Scalar, Index, NumDimensions>::s_defaultSplitMode{-1};
+
+template<typename Scalar, typename Index, int NumDimensions>
+typename Celltree<Scalar, Index, NumDimensions>::SplitMode Celltree<Scalar, Index, NumDimensions>::defaultSplitMode()
+{
+    int mode = s_defaultSplitMode;
+    if (mode < 0) {
+        mode = SplitBuckets;
+        if (const char *env = getenv("VISTLE_CELLTREE_SPLIT")) {
+            std::string split(env);
+            std::transform(split.begin(), split.end(), split.begin(), [](unsigned char c) { return std::tolower(c); });
+            if (split == "sah") {
+                mode = SplitSAH;
+            } else if (split != "buckets") {
+                std::cerr << "Celltree: ignoring unknown VISTLE_CELLTREE_SPLIT=" << env << std::endl;
+            }
+        }
+        s_defaultSplitMode = mode;
+    }
+    return SplitMode(mode);
+}
+
+template<typename Scalar, typename Index, int NumDimensions>
+void Celltree<Scalar, Index, NumDimensions>::setDefaultSplitMode(SplitMode mode)
+{
+    s_defaultSplitMode = mode;
+}
+
 #define COMMA ,
 template<typename Scalar, typename Index, int NumDimensions>
 V_OBJECT_IMPL_LOAD(Celltree<Scalar COMMA Index COMMA NumDimensions>)
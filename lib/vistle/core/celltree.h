@@ -12,6 +12,11 @@
 
 #include "celltreenode_decl.h"
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
 namespace vistle {
 
 // a bounding volume hierarchy, cf. C. Garth and K. I. Joy:
@@ -86,9 +91,19 @@ public:
         }
     };
 
+    //! strategy for choosing split planes while building the tree
+    enum SplitMode {
+        SplitBuckets, //< minimize extents of children, favor equally sized subtrees
+        SplitSAH, //< minimize surface area heuristic
+    };
+    //! split mode used if none is specified, initialized from VISTLE_CELLTREE_SPLIT ("buckets" or "sah")
+    static SplitMode defaultSplitMode();
+    static void setDefaultSplitMode(SplitMode mode);
+
     Celltree(const size_t numCells, const Meta &meta = Meta());
 
-    void init(const AABB *bounds, const CTVector &gmin, const CTVector &gmax);
+    //! build tree from cell bounds, in parallel for large numbers of cells
+    void init(const AABB *bounds, const CTVector &gmin, const CTVector &gmax, SplitMode mode = defaultSplitMode());
     template<class BoundsFunctor>
     bool validateTree(BoundsFunctor &func) const;
 
@@ -109,10 +124,64 @@ public:
         traverseNode(0, nodes().data(), cells().data(), visitNode, visitElement);
     }
 
+    //! traverse tree for a packet of queries at once, bit i of a mask corresponds to query i
+    /*! masks limit packets to 32 queries, point location uses PointPacketVisitationFunctor::PacketSize */
+    /*! visitNode(node, mask, leftMask, rightMask) computes which queries have to descend into which subtree
+     *  and returns whether the right subtree should be visited first,
+     *  visitElement(cell, mask) returns the subset of mask that has not been resolved by cell,
+     *  traversal stops as soon as all queries have been resolved */
+    template<class PacketNodeFunctor, class PacketElementFunctor>
+    void traversePacket(PacketNodeFunctor &visitNode, PacketElementFunctor &visitElement, uint32_t active) const
+    {
+        const Node *nodes = this->nodes().data();
+        const Index *cells = this->cells().data();
+
+        std::vector<std::pair<Index, uint32_t>> stack;
+        stack.reserve(64);
+        stack.emplace_back(0, active);
+        while (active && !stack.empty()) {
+            const Index cur = stack.back().first;
+            uint32_t mask = stack.back().second & active;
+            stack.pop_back();
+            if (!mask)
+                continue;
+
+            const Node &node = nodes[cur];
+            if (node.isLeaf()) {
+                for (Index i = node.start; mask && i < node.start + node.size; ++i) {
+                    const uint32_t remaining = visitElement(cells[i], mask);
+                    active &= ~(mask & ~remaining);
+                    mask &= remaining;
+                }
+                continue;
+            }
+
+            uint32_t left = 0, right = 0;
+            const bool rightFirst = visitNode(node, mask, left, right);
+            // stack: push subtree to be visited last first
+            if (rightFirst) {
+                if (left)
+                    stack.emplace_back(node.child, left);
+                if (right)
+                    stack.emplace_back(node.child + 1, right);
+            } else {
+                if (right)
+                    stack.emplace_back(node.child + 1, right);
+                if (left)
+                    stack.emplace_back(node.child, left);
+            }
+        }
+    }
+
 private:
     struct GlobalData;
     struct NodeData;
-    void refine(const AABB *bounds, NodeData &node, GlobalData &data);
+    struct Bins;
+    void refineSubtree(const NodeData &node, GlobalData &data);
+    void refine(const AABB *bounds, NodeData &node, GlobalData &data, std::deque<NodeData> &nodesToSplit);
+    void split(const NodeData &nodeData, int dim, Scalar Lmax, Scalar Rmin, Index nleft, GlobalData &data,
+               std::deque<NodeData> &nodesToSplit);
+    static std::atomic<int> s_defaultSplitMode;
 
     template<class BoundsFunctor>
     bool validateNode(BoundsFunctor &func, Index nodenum, const CTVector &min, const CTVector &max) const;
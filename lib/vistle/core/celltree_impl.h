@@ -4,24 +4,80 @@
 #include "shm_array_impl.h"
 #include "vector.h"
 #include <deque>
+#include <vector>
 
 #define CT_PARALLEL_BUILD
 //#define CT_DEBUG
 
 
 #ifdef CT_PARALLEL_BUILD
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vistle/util/threadpool.h>
 #endif
 
 #include "validate.h"
 
 namespace vistle {
 
+class ThreadPool;
+
 namespace {
 const int NumBuckets = 7;
+const int NumBucketsSAH = 16;
+const int MaxBuckets = NumBucketsSAH;
 const unsigned MaxLeafSize = 32;
 const float FavorEqualSplits = 2.f;
+const Index MinCellsParallelBuild = 100000; // build serially for fewer cells
+const Index MinCellsParallelTask = 8192; // refine smaller subtrees within the task of their parent
+const Index MinCellsParallelBinning = 1 << 18; // split computation of extents and buckets for larger nodes
+
+// call func(chunk, begin, end) for nchunks consecutive sub-ranges of [begin, end), concurrently on pool if not null
+template<class Func>
+void forEachChunk(ThreadPool *pool, Index begin, Index end, unsigned nchunks, Func func)
+{
+    const size_t n = end - begin;
+    auto chunkBegin = [begin, n, nchunks](unsigned c) -> Index {
+        return begin + Index(n * c / nchunks);
+    };
+#ifdef CT_PARALLEL_BUILD
+    if (pool && nchunks > 1) {
+        // the calling thread is a worker of pool, so instead of blocking on the other chunks
+        // it processes all chunks that have not been claimed by other workers
+        struct State {
+            std::atomic<unsigned> next{0};
+            std::mutex mutex;
+            std::condition_variable done;
+            unsigned numDone = 0;
+            std::function<void(unsigned)> work;
+        };
+        auto state = std::make_shared<State>();
+        state->work = [&func, &chunkBegin](unsigned c) {
+            func(c, chunkBegin(c), chunkBegin(c + 1));
+        };
+        auto process = [nchunks](State &s) {
+            for (unsigned c = s.next++; c < nchunks; c = s.next++) {
+                s.work(c);
+                std::lock_guard<std::mutex> guard(s.mutex);
+                if (++s.numDone == nchunks)
+                    s.done.notify_all();
+            }
+        };
+        for (unsigned c = 1; c < nchunks; ++c)
+            pool->enqueue([state, process]() { process(*state); });
+        process(*state);
+        std::unique_lock<std::mutex> guard(state->mutex);
+        state->done.wait(guard, [&state, nchunks]() { return state->numDone == nchunks; });
+        return;
+    }
+#endif
+    for (unsigned c = 0; c < nchunks; ++c)
+        func(c, chunkBegin(c), chunkBegin(c + 1));
+}
 } // namespace
 
 template<typename Scalar, typename Index, int NumDimensions>
@@ -38,12 +94,51 @@ struct Celltree<Scalar, Index, NumDimensions>::NodeData {
 
 template<typename Scalar, typename Index, int NumDimensions>
 struct Celltree<Scalar, Index, NumDimensions>::GlobalData {
+    GlobalData(const AABB *bounds, SplitMode mode): bounds(bounds), mode(mode) {}
+    const AABB *bounds = nullptr;
+    const SplitMode mode = SplitBuckets;
 #ifdef CT_PARALLEL_BUILD
-    std::mutex mutex;
-    std::atomic<unsigned> numRunning = 0;
-    std::atomic<unsigned> numWorking = 0;
+    std::mutex mutex; // protects nodes
+    std::condition_variable done;
+    std::atomic<Index> numPending{0}; // subtrees queued or being refined
+    ThreadPool *pool = nullptr;
 #endif
-    std::deque<NodeData> nodesToSplit;
+};
+
+// cells binned by their centers for each possible split dimension,
+// bmin/bmax[b][d] are the bounds of the cells in bucket b when splitting along dimension d
+template<typename Scalar, typename Index, int NumDimensions>
+struct Celltree<Scalar, Index, NumDimensions>::Bins {
+    Index count[MaxBuckets][NumDimensions];
+    Scalar bmin[MaxBuckets][NumDimensions][NumDimensions];
+    Scalar bmax[MaxBuckets][NumDimensions][NumDimensions];
+
+    Bins()
+    {
+        const Scalar smax = std::numeric_limits<Scalar>::max();
+        for (int b = 0; b < MaxBuckets; ++b) {
+            for (int d = 0; d < NumDimensions; ++d) {
+                count[b][d] = 0;
+                for (int c = 0; c < NumDimensions; ++c) {
+                    bmin[b][d][c] = smax;
+                    bmax[b][d][c] = -smax;
+                }
+            }
+        }
+    }
+
+    void merge(const Bins &o)
+    {
+        for (int b = 0; b < MaxBuckets; ++b) {
+            for (int d = 0; d < NumDimensions; ++d) {
+                count[b][d] += o.count[b][d];
+                for (int c = 0; c < NumDimensions; ++c) {
+                    bmin[b][d][c] = std::min(bmin[b][d][c], o.bmin[b][d][c]);
+                    bmax[b][d][c] = std::max(bmax[b][d][c], o.bmax[b][d][c]);
+                }
+            }
+        }
+    }
 };
 
 template<typename Scalar, typename Index, int NumDimensions>
@@ -68,7 +163,8 @@ V_COREEXPORT void Celltree<Scalar, Index, NumDimensions>::print(std::ostream &os
 }
 
 template<typename Scalar, typename Index, int NumDimensions>
-void Celltree<Scalar, Index, NumDimensions>::init(const AABB *bounds, const CTVector &gmin, const CTVector &gmax)
+void Celltree<Scalar, Index, NumDimensions>::init(const AABB *bounds, const CTVector &gmin, const CTVector &gmax,
+                                                  SplitMode mode)
 {
     assert(nodes().size() == 1);
     for (int i = 0; i < NumDimensions; ++i)
@@ -76,66 +172,51 @@ void Celltree<Scalar, Index, NumDimensions>::init(const AABB *bounds, const CTVe
     for (int i = 0; i < NumDimensions; ++i)
         this->max()[i] = gmax[i];
     nodes().reserve(cells().size() / MaxLeafSize);
-    GlobalData data;
+    GlobalData data(bounds, mode);
     NodeData node(0, 0, nodes()[0].start, nodes()[0].size);
-    data.nodesToSplit.emplace_front(node);
 
     size_t nthreads = 1;
 #ifdef CT_PARALLEL_BUILD
-    std::deque<std::thread> threads;
-    std::unique_lock guard(data.mutex);
-    while (data.numWorking > 0 || !data.nodesToSplit.empty()) {
-        guard.unlock();
-        if (data.numRunning < (std::thread::hardware_concurrency() + 1) / 2) {
-            threads.push_back(std::thread([this, &bounds, &data]() mutable {
-                static const unsigned maxidlecount = 5;
-                unsigned idlecount = 0;
-                ++data.numRunning;
-                do {
-                    std::unique_lock guard(data.mutex);
-                    while (!data.nodesToSplit.empty()) {
-                        idlecount = 0;
-                        auto n = data.nodesToSplit.front();
-                        data.nodesToSplit.pop_front();
-                        ++data.numWorking;
-                        guard.unlock();
-                        refine(bounds, n, data);
-                        guard.lock();
-                        --data.numWorking;
-                    }
-                    guard.unlock();
-                    ++idlecount;
-                    if (data.numWorking == 0)
-                        continue;
-                    usleep(10000 * idlecount);
-                } while (idlecount < maxidlecount && data.numWorking > 0);
-                --data.numRunning;
-            }));
-        }
-        usleep(10000);
-        guard.lock();
+    if (node.size >= MinCellsParallelBuild) {
+        ThreadPool pool((std::thread::hardware_concurrency() + 1) / 2, "celltree");
+        nthreads = pool.size();
+        data.pool = &pool;
+        data.numPending = 1;
+        pool.enqueue([this, node, &data]() { refineSubtree(node, data); });
+        std::unique_lock<std::mutex> guard(data.mutex);
+        data.done.wait(guard, [&data]() { return data.numPending == 0; });
+    } else
+#endif
+    {
+        refineSubtree(node, data);
     }
-    guard.unlock();
-    nthreads += threads.size();
-    while (!threads.empty()) {
-        threads.front().join();
-        threads.pop_front();
+
+    std::cerr << "created celltree: " << nodes().size() << " nodes, " << cells().size() << " cells, used " << nthreads
+              << " threads" << (mode == SplitSAH ? ", SAH" : "") << std::endl;
+}
+
+template<typename Scalar, typename Index, int NumDimensions>
+void Celltree<Scalar, Index, NumDimensions>::refineSubtree(const NodeData &nodeData, GlobalData &data)
+{
+    std::deque<NodeData> nodesToSplit;
+    nodesToSplit.emplace_front(nodeData);
+    while (!nodesToSplit.empty()) {
+        auto n = nodesToSplit.front();
+        nodesToSplit.pop_front();
+        refine(data.bounds, n, data, nodesToSplit);
     }
-#else
-    while (!data.nodesToSplit.empty()) {
-        auto n = data.nodesToSplit.front();
-        data.nodesToSplit.pop_front();
-        refine(bounds, n, data);
+
+#ifdef CT_PARALLEL_BUILD
+    if (data.pool && --data.numPending == 0) {
+        std::lock_guard<std::mutex> guard(data.mutex);
+        data.done.notify_all();
     }
 #endif
-
-    std::cerr << "created celltree: " << nodes().size() << " nodes, " << cells().size() << " cells, used " << nthreads
-              << " threads" << std::endl;
 }
 
 template<typename Scalar, typename Index, int NumDimensions>
 void Celltree<Scalar, Index, NumDimensions>::refine(const AABB *bounds, Celltree::NodeData &nodeData,
-                                                    Celltree::GlobalData &data)
+                                                    Celltree::GlobalData &data, std::deque<NodeData> &nodesToSplit)
 {
     static const Scalar smax = std::numeric_limits<Scalar>::max();
 
@@ -149,6 +230,21 @@ void Celltree<Scalar, Index, NumDimensions>::refine(const AABB *bounds, Celltree
     // cell index array, contains runs of cells belonging to nodes
     Index *cells = d()->m_cells->data();
 
+    const bool sah = data.mode == SplitSAH;
+    const int numBuckets = sah ? NumBucketsSAH : NumBuckets;
+
+    // large nodes are only encountered close to the root, when most threads of the pool are idle
+    unsigned nchunks = 1;
+    ThreadPool *pool = nullptr;
+#ifdef CT_PARALLEL_BUILD
+    pool = data.pool;
+    if (data.pool && nodeSize >= MinCellsParallelBinning) {
+        const unsigned pending = std::max(Index(1), Index(data.numPending));
+        nchunks = std::max(1u, data.pool->size() / pending);
+        nchunks = std::min(nchunks, unsigned(nodeSize / (MinCellsParallelBinning / 4)));
+    }
+#endif
+
     // sort cells into buckets for each possible split dimension
     auto center = [&bounds](int d, Index cell) {
         const auto &c = bounds[cell];
@@ -156,64 +252,105 @@ void Celltree<Scalar, Index, NumDimensions>::refine(const AABB *bounds, Celltree
     };
 
     // find min/max extents of cell centers
+    std::vector<AABB> cextent(nchunks);
+    forEachChunk(pool, nodeStart, nodeStart + nodeSize, nchunks, [&](unsigned chunk, Index begin, Index end) {
+        auto &e = cextent[chunk];
+        for (int d = 0; d < NumDimensions; ++d) {
+            e.mmin[d] = smax;
+            e.mmax[d] = -smax;
+        }
+        for (Index i = begin; i < end; ++i) {
+            const Index cell = cells[i];
+            for (int d = 0; d < NumDimensions; ++d) {
+                const auto cent = center(d, cell);
+                e.mmin[d] = std::min(e.mmin[d], cent);
+                e.mmax[d] = std::max(e.mmax[d], cent);
+            }
+        }
+    });
     CTVector cmin, cmax;
     cmin.fill(smax);
     cmax.fill(-smax);
-    for (Index i = nodeStart; i < nodeStart + nodeSize; ++i) {
-        const Index cell = cells[i];
+    for (const auto &e: cextent) {
         for (int d = 0; d < NumDimensions; ++d) {
-            const auto cent = center(d, cell);
-            cmin[d] = std::min(cmin[d], cent);
-            cmax[d] = std::max(cmax[d], cent);
+            cmin[d] = std::min(cmin[d], e.min(d));
+            cmax[d] = std::max(cmax[d], e.max(d));
         }
     }
 
     // sort cells into buckets
     const CTVector crange = (cmax - cmin);
-    const CTVector crangeI = crange.cwiseInverse() * NumBuckets;
-    auto getBucket = [cmin, cmax, crangeI](Scalar center, int d) -> int {
-        return std::min(int((center - cmin[d]) * crangeI[d]), NumBuckets - 1);
+    const CTVector crangeI = crange.cwiseInverse() * numBuckets;
+    auto getBucket = [cmin, crangeI, numBuckets](Scalar center, int d) -> int {
+        return std::min(int((center - cmin[d]) * crangeI[d]), numBuckets - 1);
     };
 
-    // initialize min/max extents of buckets
-    Index bucket[NumBuckets][NumDimensions];
-    CTVector bmin[NumBuckets]{CTVector::Constant(smax)}, bmax[NumBuckets]{CTVector::Constant(-smax)};
-    for (int i = 0; i < NumBuckets; ++i) {
-        for (int d = 0; d < NumDimensions; ++d)
-            bucket[i][d] = 0;
-        bmin[i].fill(smax);
-        bmax[i].fill(-smax);
-    }
-
-    for (Index i = nodeStart; i < nodeStart + nodeSize; ++i) {
-        const Index cell = cells[i];
-        for (int d = 0; d < NumDimensions; ++d) {
-            if (crange[d] == 0)
-                continue;
-            const int b = getBucket(center(d, cell), d);
-            assert(b >= 0);
-            assert(b < NumBuckets);
-            ++bucket[b][d];
+    std::vector<Bins> chunkBins(nchunks);
+    forEachChunk(pool, nodeStart, nodeStart + nodeSize, nchunks, [&](unsigned chunk, Index begin, Index end) {
+        auto &bins = chunkBins[chunk];
+        for (Index i = begin; i < end; ++i) {
+            const Index cell = cells[i];
             const auto &bound = bounds[cell];
-            bmin[b][d] = std::min(bmin[b][d], bound.min(d));
-            bmax[b][d] = std::max(bmax[b][d], bound.max(d));
+            for (int d = 0; d < NumDimensions; ++d) {
+                if (crange[d] == 0)
+                    continue;
+                const int b = getBucket(center(d, cell), d);
+                assert(b >= 0);
+                assert(b < numBuckets);
+                ++bins.count[b][d];
+                if (sah) {
+                    for (int c = 0; c < NumDimensions; ++c) {
+                        bins.bmin[b][d][c] = std::min(bins.bmin[b][d][c], bound.min(c));
+                        bins.bmax[b][d][c] = std::max(bins.bmax[b][d][c], bound.max(c));
+                    }
+                } else {
+                    bins.bmin[b][d][d] = std::min(bins.bmin[b][d][d], bound.min(d));
+                    bins.bmax[b][d][d] = std::max(bins.bmax[b][d][d], bound.max(d));
+                }
+            }
         }
-    }
+    });
+    auto &bins = chunkBins[0];
+    for (unsigned c = 1; c < nchunks; ++c)
+        bins.merge(chunkBins[c]);
 
-    // adjust bucket bounds for empty buckets
+    // accumulate bounds of buckets 0..b (left) and b..numBuckets-1 (right), also adjusts for empty buckets
+    Bins left(bins), right(bins);
     for (int d = 0; d < NumDimensions; ++d) {
         if (crange[d] == 0)
             continue;
-        for (int b = NumBuckets - 2; b >= 0; --b) {
-            if (bmin[b][d] > bmin[b + 1][d])
-                bmin[b][d] = bmin[b + 1][d];
+        for (int b = 1; b < numBuckets; ++b) {
+            for (int c = 0; c < NumDimensions; ++c) {
+                left.bmin[b][d][c] = std::min(left.bmin[b][d][c], left.bmin[b - 1][d][c]);
+                left.bmax[b][d][c] = std::max(left.bmax[b][d][c], left.bmax[b - 1][d][c]);
+            }
         }
-        for (int b = 1; b < NumBuckets; ++b) {
-            if (bmax[b][d] < bmax[b - 1][d])
-                bmax[b][d] = bmax[b - 1][d];
+        for (int b = numBuckets - 2; b >= 0; --b) {
+            for (int c = 0; c < NumDimensions; ++c) {
+                right.bmin[b][d][c] = std::min(right.bmin[b][d][c], right.bmin[b + 1][d][c]);
+                right.bmax[b][d][c] = std::max(right.bmax[b][d][c], right.bmax[b + 1][d][c]);
+            }
         }
     }
 
+    // surface area for SAH: length in 1D, perimeter in 2D
+    auto area = [](const Scalar *bmin, const Scalar *bmax) -> Scalar {
+        Scalar e[NumDimensions];
+        for (int c = 0; c < NumDimensions; ++c)
+            e[c] = std::max(Scalar(0), bmax[c] - bmin[c]);
+        if (NumDimensions <= 2) {
+            Scalar a = 0;
+            for (int c = 0; c < NumDimensions; ++c)
+                a += e[c];
+            return a;
+        }
+        Scalar a = 0;
+        for (int c = 0; c < NumDimensions; ++c)
+            for (int cc = c + 1; cc < NumDimensions; ++cc)
+                a += e[c] * e[cc];
+        return a;
+    };
+
     // find best split dimension and plane
     Scalar min_weight(smax);
     int best_dim = -1, best_bucket = -1;
@@ -221,15 +358,21 @@ void Celltree<Scalar, Index, NumDimensions>::refine(const AABB *bounds, Celltree
         if (crange[d] == 0)
             continue;
         Index nleft = 0;
-        for (int split_b = 0; split_b < NumBuckets - 1; ++split_b) {
-            nleft += bucket[split_b][d];
+        for (int split_b = 0; split_b < numBuckets - 1; ++split_b) {
+            nleft += bins.count[split_b][d];
             assert(nodeSize >= nleft);
             const Index nright = nodeSize - nleft;
-            Scalar weight =
-                std::pow(float(nleft) / float(nodeSize), FavorEqualSplits) * (bmax[split_b][d] - bmin[0][d]) +
-                std::pow(float(nright) / float(nodeSize), FavorEqualSplits) *
-                    (bmax[NumBuckets - 1][d] - bmin[split_b + 1][d]);
-            weight /= crange[d];
+            Scalar weight = smax;
+            if (sah) {
+                weight = Scalar(nleft) * area(left.bmin[split_b][d], left.bmax[split_b][d]) +
+                         Scalar(nright) * area(right.bmin[split_b + 1][d], right.bmax[split_b + 1][d]);
+            } else {
+                weight = std::pow(float(nleft) / float(nodeSize), FavorEqualSplits) *
+                             (left.bmax[split_b][d][d] - right.bmin[0][d][d]) +
+                         std::pow(float(nright) / float(nodeSize), FavorEqualSplits) *
+                             (left.bmax[numBuckets - 1][d][d] - right.bmin[split_b + 1][d][d]);
+                weight /= crange[d];
+            }
             //std::cerr << "d=" << d << ", b=" << split_b << ", weight=" << weight << std::endl;
             if (nleft > 0 && nright > 0 && weight < min_weight) {
                 min_weight = weight;
@@ -237,18 +380,16 @@ void Celltree<Scalar, Index, NumDimensions>::refine(const AABB *bounds, Celltree
                 best_bucket = split_b;
             }
         }
-        assert(nleft + bucket[NumBuckets - 1][d] == nodeSize);
+        assert(nleft + bins.count[numBuckets - 1][d] == nodeSize);
     }
 
     // split index lists...
     const Index size = nodeSize;
     const Index start = nodeStart;
 
-    Index nleft = 0;
-    Scalar Lmax, Rmin;
     if (best_dim == -1) {
         crange.maxCoeff(&best_dim);
-        nleft = size / 2;
+        const Index nleft = size / 2;
         std::cerr << "abandoning split with " << nodeSize << " children, fall back to @" << best_dim << " after "
                   << nleft << " cells" << std::endl;
         std::nth_element(&cells[start], &cells[start + nleft], &cells[start + size],
@@ -271,58 +412,57 @@ void Celltree<Scalar, Index, NumDimensions>::refine(const AABB *bounds, Celltree
 
         auto Lbounds = findBounds(start, start + nleft);
         auto Rbounds = findBounds(start + nleft, start + size);
-        auto Lmax = Lbounds.second[best_dim];
-        auto Rmin = Rbounds.first[best_dim];
+        split(nodeData, best_dim, Lbounds.second[best_dim], Rbounds.first[best_dim], nleft, data, nodesToSplit);
+        return;
+    }
+
+    auto mid = std::partition(&cells[start], &cells[start + size], [getBucket, center, best_dim, best_bucket](Index c) {
+        return getBucket(center(best_dim, c), best_dim) <= best_bucket;
+    });
+    const Index nleft = mid - &cells[start];
+    const Scalar Lmax = left.bmax[best_bucket][best_dim][best_dim];
+    const Scalar Rmin = right.bmin[best_bucket + 1][best_dim][best_dim];
+    split(nodeData, best_dim, Lmax, Rmin, nleft, data, nodesToSplit);
+}
 
+template<typename Scalar, typename Index, int NumDimensions>
+void Celltree<Scalar, Index, NumDimensions>::split(const NodeData &nodeData, int dim, Scalar Lmax, Scalar Rmin,
+                                                   Index nleft, GlobalData &data, std::deque<NodeData> &nodesToSplit)
+{
+    const Index size = nodeData.size;
+    const Index start = nodeData.start;
+    NodeData left(nodeData, InvalidIndex, start, nleft);
+    NodeData right(nodeData, InvalidIndex, start + nleft, size - nleft);
+
+    // record children into node being split
+    {
 #ifdef CT_PARALLEL_BUILD
-        std::unique_lock guard(data.mutex);
+        std::lock_guard<std::mutex> guard(data.mutex);
 #endif
         Node *node = &(nodes()[nodeData.node]);
         // promote to inner node
-        *node = Node(best_dim, Lmax, Rmin, nodes().size());
-        Index l = nodes().size();
-        nodes().push_back(Node(start, nleft));
-
-        Index r = nodes().size();
-        nodes().push_back(Node(start + nleft, size - nleft));
+        *node = Node(dim, Lmax, Rmin, nodes().size());
+        left.node = nodes().size();
+        nodes().push_back(Node(left.start, left.size));
 
-        assert(nodes()[l].size < size);
-        assert(nodes()[r].size < size);
-        assert(nodes()[l].size + nodes()[r].size == size);
+        right.node = nodes().size();
+        nodes().push_back(Node(right.start, right.size));
 
-        data.nodesToSplit.emplace_front(nodeData, l, start, nleft);
-        data.nodesToSplit.emplace_front(nodeData, r, start + nleft, size - nleft);
-        return;
-    } else {
-        auto mid =
-            std::partition(&cells[start], &cells[start + size], [getBucket, center, best_dim, best_bucket](Index c) {
-                return getBucket(center(best_dim, c), best_dim) <= best_bucket;
-            });
-        nleft = mid - &cells[start];
-        Lmax = bmax[best_bucket][best_dim];
-        Rmin = bmin[best_bucket + 1][best_dim];
+        assert(nodes()[left.node].size < size);
+        assert(nodes()[right.node].size < size);
+        assert(nodes()[left.node].size + nodes()[right.node].size == size);
     }
 
-    // record children into node being split
-
+    for (auto &child: {left, right}) {
 #ifdef CT_PARALLEL_BUILD
-    std::unique_lock guard(data.mutex);
+        if (data.pool && child.size >= MinCellsParallelTask) {
+            ++data.numPending;
+            data.pool->enqueue([this, child, &data]() { refineSubtree(child, data); });
+            continue;
+        }
 #endif
-    Node *node = &(nodes()[nodeData.node]);
-    // promote to inner node
-    *node = Node(best_dim, Lmax, Rmin, nodes().size());
-    Index l = nodes().size();
-    nodes().push_back(Node(start, nleft));
-
-    Index r = nodes().size();
-    nodes().push_back(Node(start + nleft, size - nleft));
-
-    assert(nodes()[l].size < size);
-    assert(nodes()[r].size < size);
-    assert(nodes()[l].size + nodes()[r].size == size);
-
-    data.nodesToSplit.emplace_front(nodeData, l, start, nleft);
-    data.nodesToSplit.emplace_front(nodeData, r, start + nleft, size - nleft);
+        nodesToSplit.emplace_front(child);
+    }
 }
 
 template<typename Scalar, typename Index, int NumDimensions>
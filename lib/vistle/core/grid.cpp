@@ -5,6 +5,80 @@
 
 namespace vistle {
 
+void GridInterface::findCells(Index numPoints, const Vector3 *points, Index *cells, int flags) const
+{
+    // consecutive points are often close to each other, so try previous result first
+    Index hint = InvalidIndex;
+    for (Index i = 0; i < numPoints; ++i) {
+        cells[i] = findCell(points[i], hint, flags);
+        if (cells[i] != InvalidIndex)
+            hint = cells[i];
+    }
+}
+
+GridInterface::Interpolators GridInterface::getInterpolators(Index numPoints, const Index *cells,
+                                                             const Vector3 *points, DataBase::Mapping mapping,
+                                                             InterpolationMode mode) const
+{
+    Interpolators result;
+    result.reserve(numPoints, 0);
+    for (Index i = 0; i < numPoints; ++i) {
+        if (cells[i] == InvalidIndex) {
+            result.add(0);
+            continue;
+        }
+        result.add(getInterpolator(cells[i], points[i], mapping, mode));
+    }
+    return result;
+}
+
+void GridInterface::Interpolators::reserve(Index numPoints, Index numWeights)
+{
+    offsets.reserve(numPoints + 1);
+    weights.reserve(numWeights);
+    indices.reserve(numWeights);
+}
+
+Index GridInterface::Interpolators::add(Index numWeights)
+{
+    const Index end = offsets.back() + numWeights;
+    offsets.push_back(end);
+    weights.resize(end);
+    indices.resize(end);
+    return size() - 1;
+}
+
+Index GridInterface::Interpolators::add(const Interpolator &interpolator)
+{
+    offsets.push_back(offsets.back() + interpolator.weights.size());
+    weights.insert(weights.end(), interpolator.weights.begin(), interpolator.weights.end());
+    indices.insert(indices.end(), interpolator.indices.begin(), interpolator.indices.end());
+    return size() - 1;
+}
+
+void GridInterface::Interpolators::apply(const Scalar *field, Scalar *result) const
+{
+    const Index n = size();
+    for (Index i = 0; i < n; ++i) {
+        if (valid(i))
+            result[i] = (*this)(i, field);
+    }
+}
+
+void GridInterface::Interpolators::apply(const Scalar *f0, const Scalar *f1, const Scalar *f2, Scalar *r0,
+                                         Scalar *r1, Scalar *r2) const
+{
+    const Index n = size();
+    for (Index i = 0; i < n; ++i) {
+        if (valid(i)) {
+            const Vector3 v = (*this)(i, f0, f1, f2);
+            r0[i] = v[0];
+            r1[i] = v[1];
+            r2[i] = v[2];
+        }
+    }
+}
+
 bool GridInterface::Interpolator::check() const
 {
 #ifndef NDEBUG
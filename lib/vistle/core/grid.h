@@ -22,6 +22,8 @@ public:
 
     virtual bool isGhostCell(Index elem) const = 0;
     virtual Index findCell(const Vector3 &point, Index hint = InvalidIndex, int flags = NoFlags) const = 0;
+    //! locate numPoints points at once, store index of containing cell (or InvalidIndex) for each point in cells
+    virtual void findCells(Index numPoints, const Vector3 *points, Index *cells, int flags = NoFlags) const;
     virtual bool inside(Index elem, const Vector3 &point) const = 0;
     virtual std::pair<Vector3, Vector3> cellBounds(Index elem) const = 0;
     virtual Vector3 cellCenter(Index elem) const = 0; //< a point inside the convex hull of the cell
@@ -30,7 +32,10 @@ public:
     virtual std::vector<Index> getNeighborElements(Index elem)
         const = 0; //! return at least those elements sharing faces with elem, but might also contain those just sharing vertices
 
+    class Interpolators;
+
     class Interpolator {
+        friend class Interpolators;
         std::vector<Scalar> weights;
         std::vector<Index> indices;
 
@@ -66,6 +71,52 @@ public:
         bool check() const;
     };
 
+    //! interpolation weights for many points, stored contiguously
+    class Interpolators {
+        std::vector<Index> offsets{0}; // weights for point i are stored in [offsets[i], offsets[i+1])
+        std::vector<Scalar> weights;
+        std::vector<Index> indices;
+
+    public:
+        Index size() const { return offsets.size() - 1; }
+        //! whether weights are available for point i
+        bool valid(Index i) const { return offsets[i + 1] > offsets[i]; }
+        Index numWeights(Index i) const { return offsets[i + 1] - offsets[i]; }
+
+        void reserve(Index numPoints, Index numWeights);
+        //! add storage for numWeights weights for another point, return index of point
+        Index add(Index numWeights);
+        //! add weights for another point, return index of point
+        Index add(const Interpolator &interpolator);
+
+        Scalar *weightsOf(Index i) { return weights.data() + offsets[i]; }
+        const Scalar *weightsOf(Index i) const { return weights.data() + offsets[i]; }
+        Index *indicesOf(Index i) { return indices.data() + offsets[i]; }
+        const Index *indicesOf(Index i) const { return indices.data() + offsets[i]; }
+
+        Scalar operator()(Index i, const Scalar *field) const
+        {
+            Scalar ret(0);
+            for (Index k = offsets[i]; k < offsets[i + 1]; ++k)
+                ret += field[indices[k]] * weights[k];
+            return ret;
+        }
+
+        Vector3 operator()(Index i, const Scalar *f0, const Scalar *f1, const Scalar *f2) const
+        {
+            Vector3 ret(0, 0, 0);
+            for (Index k = offsets[i]; k < offsets[i + 1]; ++k) {
+                const Index ind(indices[k]);
+                ret += Vector3(f0[ind], f1[ind], f2[ind]) * weights[k];
+            }
+            return ret;
+        }
+
+        //! interpolate field for all points into result, entries for points without weights are not modified
+        void apply(const Scalar *field, Scalar *result) const;
+        void apply(const Scalar *f0, const Scalar *f1, const Scalar *f2, Scalar *r0, Scalar *r1, Scalar *r2) const;
+    };
+
     DEFINE_ENUM_WITH_STRING_CONVERSIONS(InterpolationMode, (First) // value of first vertex
                                         (Mean) // mean value of all vertices
                                         (Nearest) // value of nearest vertex
@@ -83,6 +134,18 @@ public:
         }
         return getInterpolator(elem, point, mapping, mode);
     }
+    //! compute weights for numPoints points at once, cells[i] is the cell containing points[i] or InvalidIndex
+    virtual Interpolators getInterpolators(Index numPoints, const Index *cells, const Vector3 *points,
+                                           DataBase::Mapping mapping = DataBase::Vertex,
+                                           InterpolationMode mode = Linear) const;
+    //! locate numPoints points with findCells and compute their weights with getInterpolators
+    Interpolators findCellsAndInterpolators(Index numPoints, const Vector3 *points, Index *cells,
+                                            DataBase::Mapping mapping = DataBase::Vertex,
+                                            InterpolationMode mode = Linear, int flags = NoFlags) const
+    {
+        findCells(numPoints, points, cells, flags);
+        return getInterpolators(numPoints, cells, points, mapping, mode);
+    }
 };
 
 } // namespace vistle
@@ -358,6 +358,11 @@ Index LayerGrid::findCell(const Vector3 &point, Index hint, int flags) const
     return InvalidIndex;
 }
 
+void LayerGrid::findCells(Index numPoints, const Vector3 *points, Index *cells, int flags) const
+{
+    vistle::findCells(this, numPoints, points, cells, flags);
+}
+
 // INSIDE CHECK
 //-------------------------------------------------------------------------
 bool LayerGrid::inside(Index elem, const Vector3 &point) const
@@ -80,6 +80,8 @@ DEFINE_ENUM_WITH_STRING_CONVERSIONS(
     (REMOTERENDERING)
     (COVER)
     (INSITU)
+    (SHMINFO)
+    (TRACEDATA)
     (NumMessageTypes) // keep last
 )
 V_ENUM_OUTPUT_OP(Type, ::vistle::message)
@@ -74,6 +74,8 @@ void Router::initRoutingTable()
     rt[FILEQUERYRESULT] = Special;
     rt[COVER] = Special;
     rt[INSITU] = Special;
+    rt[SHMINFO] = Track | DestUi | DestMasterHub;
+    rt[TRACEDATA] = Track | DestUi | DestMasterHub;
 
     for (int i = ANY + 1; i < NumMessageTypes; ++i) {
         if (rt[i] == 0) {
@@ -1,6 +1,8 @@
 #include <vistle/util/tools.h>
 
 #include "availablemodule.h"
+#include "database.h"
+#include "geometry.h"
 #include "message.h"
 #include "messages.h"
 #include "parameter.h"
@@ -43,12 +45,16 @@ template V_COREEXPORT buffer addPayload<SendText::Payload>(Message &message, con
 template V_COREEXPORT buffer addPayload<ItemInfo::Payload>(Message &message, const ItemInfo::Payload &payload);
 template V_COREEXPORT buffer addPayload<SetParameterChoices::Payload>(Message &message,
                                                                       const SetParameterChoices::Payload &payload);
+template V_COREEXPORT buffer addPayload<ShmInfo::Payload>(Message &message, const ShmInfo::Payload &payload);
+template V_COREEXPORT buffer addPayload<TraceData::Payload>(Message &message, const TraceData::Payload &payload);
 
 
 template V_COREEXPORT std::string getPayload(const buffer &data);
 template V_COREEXPORT SendText::Payload getPayload(const buffer &data);
 template V_COREEXPORT ItemInfo::Payload getPayload(const buffer &data);
 template V_COREEXPORT SetParameterChoices::Payload getPayload(const buffer &data);
+template V_COREEXPORT ShmInfo::Payload getPayload(const buffer &data);
+template V_COREEXPORT TraceData::Payload getPayload(const buffer &data);
 
 Identify::Identify(const std::string &name)
 : m_identity(Identity::REQUEST)
@@ -765,9 +771,29 @@ Port RemovePort::getPort() const
     return Port(senderId(), m_name.data(), Port::ANY);
 }
 
+namespace {
+
+uint64_t estimateCost(Object::const_ptr obj)
+{
+    uint64_t cost = 0;
+    if (auto elem = obj->getInterface<ElementInterface>())
+        cost += elem->getNumElements();
+    if (auto data = DataBase::as(obj)) {
+        cost += data->getSize();
+        if (auto grid = data->grid()) {
+            if (auto elem = grid->getInterface<ElementInterface>())
+                cost += elem->getNumElements();
+        }
+    }
+    return cost;
+}
+
+} // namespace
+
 AddObject::AddObject(const std::string &sender, vistle::Object::const_ptr obj, const std::string &dest)
 : m_meta(obj->meta())
 , m_objectType(obj->getType())
+, m_cost(estimateCost(obj))
 , m_name(obj->getName())
 , handle(obj->getHandle())
 , m_handleValid(true)
@@ -785,6 +811,7 @@ AddObject::AddObject(const AddObject &o)
 : MessageBase<AddObject, ADDOBJECT>(o)
 , m_meta(o.m_meta)
 , m_objectType(o.m_objectType)
+, m_cost(o.m_cost)
 , senderPort(o.senderPort)
 , destPort(o.destPort)
 , m_name(o.m_name)
@@ -876,6 +903,11 @@ Object::Type AddObject::objectType() const
     return static_cast<Object::Type>(m_objectType);
 }
 
+uint64_t AddObject::cost() const
+{
+    return m_cost;
+}
+
 void AddObject::setObject(Object::const_ptr obj)
 {
     if (m_handleValid) {
@@ -1814,6 +1846,13 @@ RequestObject::RequestObject(int destId, int destRank, const std::string &arrayI
     setDestRank(destRank);
 }
 
+RequestObject::RequestObject(int destId, int destRank, unsigned numArrays, const std::string &referrer)
+: m_objectId(""), m_referrer(referrer), m_array(true), m_arrayType(-1), m_numArrays(numArrays)
+{
+    setDestId(destId);
+    setDestRank(destRank);
+}
+
 const char *RequestObject::objectId() const
 {
     return m_objectId;
@@ -1834,9 +1873,25 @@ int RequestObject::arrayType() const
     return m_arrayType;
 }
 
+unsigned RequestObject::numArrays() const
+{
+    return m_numArrays;
+}
+
+void RequestObject::setContentRequired(bool required)
+{
+    m_contentRequired = required;
+}
+
+bool RequestObject::contentRequired() const
+{
+    return m_contentRequired;
+}
+
 
 SendObject::SendObject(const RequestObject &request, Object::const_ptr obj, size_t payloadSize)
 : m_array(false)
+, m_contentHash{}
 , m_objectId(obj->getName())
 , m_referrer(request.referrer())
 , m_objectType(obj->getType())
@@ -1859,7 +1914,11 @@ SendObject::SendObject(const RequestObject &request, Object::const_ptr obj, size
 }
 
 SendObject::SendObject(const RequestObject &request, size_t payloadSize)
-: m_array(true), m_objectId(request.objectId()), m_referrer(request.referrer()), m_objectType(request.arrayType())
+: m_array(true)
+, m_contentHash{}
+, m_objectId(request.objectId())
+, m_referrer(request.referrer())
+, m_objectType(request.arrayType())
 {
     setUuid(request.uuid());
     m_payloadSize = payloadSize;
@@ -1901,6 +1960,26 @@ bool SendObject::isArray() const
     return m_array;
 }
 
+void SendObject::setContentHash(const std::string &hash)
+{
+    COPY_STRING(m_contentHash, hash);
+}
+
+const char *SendObject::contentHash() const
+{
+    return m_contentHash.data();
+}
+
+void SendObject::setHashOnly(bool hashOnly)
+{
+    m_hashOnly = hashOnly;
+}
+
+bool SendObject::isHashOnly() const
+{
+    return m_hashOnly;
+}
+
 FileQuery::FileQuery(int moduleId, const std::string &path, Command command, size_t payloadsize)
 : m_command(command), m_moduleId(moduleId)
 {
@@ -1971,6 +2050,27 @@ size_t DataTransferState::numTransferring() const
     return m_numTransferring;
 }
 
+ShmInfo::ShmInfo(uint64_t bytes, uint64_t segmentSize): m_bytes(bytes), m_segmentSize(segmentSize)
+{}
+
+uint64_t ShmInfo::bytes() const
+{
+    return m_bytes;
+}
+
+uint64_t ShmInfo::segmentSize() const
+{
+    return m_segmentSize;
+}
+
+TraceData::TraceData(uint64_t numSpans): m_numSpans(numSpans)
+{}
+
+uint64_t TraceData::numSpans() const
+{
+    return m_numSpans;
+}
+
 std::ostream &operator<<(std::ostream &s, const Message &m)
 {
     using namespace vistle::message;
@@ -2116,13 +2216,21 @@ std::ostream &operator<<(std::ostream &s, const Message &m)
     }
     case REQUESTOBJECT: {
         auto &mm = static_cast<const RequestObject &>(m);
-        s << ", " << (mm.isArray() ? "array" : "object") << ": " << mm.objectId() << ", ref: " << mm.referrer();
+        if (mm.numArrays() > 0) {
+            s << ", " << mm.numArrays() << " arrays, ref: " << mm.referrer();
+        } else {
+            s << ", " << (mm.isArray() ? "array" : "object") << ": " << mm.objectId() << ", ref: " << mm.referrer();
+        }
+        if (mm.contentRequired())
+            s << ", content required";
         break;
     }
     case SENDOBJECT: {
         auto &mm = static_cast<const SendObject &>(m);
         s << ", " << (mm.isArray() ? "array" : "object") << ": " << mm.objectId() << ", ref: " << mm.referrer()
           << ", payload size: " << mm.payloadSize();
+        if (mm.isHashOnly())
+            s << ", hash only: " << mm.contentHash();
         break;
     }
     case FILEQUERY: {
@@ -2135,6 +2243,16 @@ std::ostream &operator<<(std::ostream &s, const Message &m)
         s << ", status: " << mm.status() << ", path: " << mm.path() << ", filebrowser: " << mm.filebrowserId();
         break;
     }
+    case SHMINFO: {
+        auto &mm = static_cast<const ShmInfo &>(m);
+        s << ", bytes: " << mm.bytes() << ", segment size: " << mm.segmentSize();
+        break;
+    }
+    case TRACEDATA: {
+        auto &mm = static_cast<const TraceData &>(m);
+        s << ", spans: " << mm.numSpans();
+        break;
+    }
     case COVER: {
         auto &mm = static_cast<const Cover &>(m);
         s << ", mirror: " << mm.mirrorId() << ", sender: " << mm.sender() << ", sender type: " << mm.senderType()
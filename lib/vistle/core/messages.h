@@ -16,8 +16,10 @@
 #include "object.h"
 #include "parameter.h"
 #include "paramvector.h"
+#include "pipelinetrace.h"
 #include "scalar.h"
 #include "shmname.h"
+#include "shm_statistics.h"
 #include "uuid.h"
 
 #pragma pack(push)
@@ -440,6 +442,8 @@ public:
     bool ref() const; //!< may only be called once
     const Meta &meta() const;
     Object::Type objectType() const;
+    //! estimate of memory and work required by object: number of cells of its grid and of its data values
+    uint64_t cost() const;
     const shm_handle_t &getHandle() const;
     bool handleValid() const;
 
@@ -451,6 +455,7 @@ public:
 private:
     Meta m_meta;
     int m_objectType = Object::UNKNOWN;
+    uint64_t m_cost = 0;
     port_name_t senderPort;
     port_name_t destPort;
     shm_name_t m_name;
@@ -944,19 +949,42 @@ private:
 //! request remote data object
 class V_COREEXPORT RequestObject: public MessageBase<RequestObject, REQUESTOBJECT> {
 public:
+    //! names and types of arrays requested with a single message
+    struct Payload {
+        std::vector<std::string> arrayIds;
+        std::vector<int> arrayTypes;
+
+        ARCHIVE_ACCESS
+        template<class Archive>
+        void serialize(Archive &ar)
+        {
+            ar &arrayIds;
+            ar &arrayTypes;
+        }
+    };
+
     RequestObject(const AddObject &add, const std::string &objId, const std::string &referrer = "");
     RequestObject(int destId, int destRank, const std::string &objId, const std::string &referrer);
     RequestObject(int destId, int destRank, const std::string &arrayId, int type, const std::string &referrer);
+    //! request numArrays arrays at once, their names and types have to be attached as Payload
+    RequestObject(int destId, int destRank, unsigned numArrays, const std::string &referrer);
     const char *objectId() const;
     const char *referrer() const;
     bool isArray() const;
     int arrayType() const;
+    //! number of arrays requested via Payload, 0 if a single array or object is requested
+    unsigned numArrays() const;
+    //! request array contents even if the receiver is assumed to have an array with the same content hash
+    void setContentRequired(bool required);
+    bool contentRequired() const;
 
 private:
     shm_name_t m_objectId;
     shm_name_t m_referrer;
     bool m_array;
     int m_arrayType;
+    uint32_t m_numArrays = 0;
+    bool m_contentRequired = false;
 };
 
 //! header for data object transmission
@@ -970,9 +998,19 @@ public:
     Object::Type objectType() const;
     Meta objectMeta() const;
     bool isArray() const;
+    //! content hash of the array, empty if not computed
+    void setContentHash(const std::string &hash);
+    const char *contentHash() const;
+    //! only the content hash of the array is sent, the receiver is expected to have an array with the same content
+    void setHashOnly(bool hashOnly);
+    bool isHashOnly() const;
 
 private:
+    typedef std::array<char, 72> content_hash_t;
+
     bool m_array;
+    bool m_hashOnly = false;
+    content_hash_t m_contentHash;
     shm_name_t m_objectId;
     shm_name_t m_referrer;
     int m_objectType;
@@ -1030,6 +1068,33 @@ private:
     size_t m_numTransferring;
 };
 
+//! periodic report on usage of the shared memory segment of a rank, details are in payload
+class V_COREEXPORT ShmInfo: public MessageBase<ShmInfo, SHMINFO> {
+public:
+    typedef ShmUsage Payload;
+
+    ShmInfo(uint64_t bytes, uint64_t segmentSize);
+    //! bytes currently allocated
+    uint64_t bytes() const;
+    uint64_t segmentSize() const;
+
+private:
+    uint64_t m_bytes;
+    uint64_t m_segmentSize;
+};
+
+//! spans recorded by PipelineTracer on a rank, spans are in payload
+class V_COREEXPORT TraceData: public MessageBase<TraceData, TRACEDATA> {
+public:
+    typedef std::vector<TraceSpan> Payload;
+
+    explicit TraceData(uint64_t numSpans);
+    uint64_t numSpans() const;
+
+private:
+    uint64_t m_numSpans;
+};
+
 //! wrap a COVISE message sent by COVER
 class V_COREEXPORT Cover: public MessageBase<Cover, COVER> {
 public:
@@ -1057,10 +1122,14 @@ extern template V_COREEXPORT buffer addPayload<std::string>(Message &message, co
 extern template V_COREEXPORT buffer addPayload<SendText::Payload>(Message &message, const SendText::Payload &payload);
 extern template V_COREEXPORT buffer
 addPayload<SetParameterChoices::Payload>(Message &message, const SetParameterChoices::Payload &payload);
+extern template V_COREEXPORT buffer addPayload<ShmInfo::Payload>(Message &message, const ShmInfo::Payload &payload);
+extern template V_COREEXPORT buffer addPayload<TraceData::Payload>(Message &message, const TraceData::Payload &payload);
 
 extern template V_COREEXPORT std::string getPayload(const buffer &data);
 extern template V_COREEXPORT SendText::Payload getPayload(const buffer &data);
 extern template V_COREEXPORT SetParameterChoices::Payload getPayload(const buffer &data);
+extern template V_COREEXPORT ShmInfo::Payload getPayload(const buffer &data);
+extern template V_COREEXPORT TraceData::Payload getPayload(const buffer &data);
 
 V_COREEXPORT std::ostream &operator<<(std::ostream &s, const Message &msg);
 
@@ -224,7 +224,9 @@ ObjectData::ObjectData(const Object::Type type, const std::string &n, const Meta
 , meta(m)
 , attributes(std::less<Key>(), Shm::the().allocator())
 , attachments(std::less<Key>(), Shm::the().allocator())
-{}
+{
+    Shm::the().statistics().created(ShmStatistics::ObjectType, type);
+}
 
 ObjectData::ObjectData(const Object::Data &o, const std::string &name, Object::Type id)
 : ShmData(ShmData::OBJECT, name)
@@ -236,6 +238,7 @@ ObjectData::ObjectData(const Object::Data &o, const std::string &name, Object::T
 {
     copyAttributes(&o, true);
     copyAttachments(&o, true);
+    Shm::the().statistics().created(ShmStatistics::ObjectType, type);
 }
 
 ObjectData::~ObjectData()
@@ -248,6 +251,8 @@ ObjectData::~ObjectData()
         // referenced in addAttachment
         objd.second->unref();
     }
+
+    Shm::the().statistics().destroyed(ShmStatistics::ObjectType, type);
 }
 
 bool Object::Data::isComplete() const
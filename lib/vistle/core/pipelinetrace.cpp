@@ -0,0 +1,363 @@
+#include "pipelinetrace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <tuple>
+
+namespace vistle {
+
+namespace {
+
+std::atomic<int> s_nextThread{1};
+thread_local int t_thread = 0;
+
+bool isModuleSpan(int kind)
+{
+    return kind == TraceSpan::Prepare || kind == TraceSpan::Compute || kind == TraceSpan::Block ||
+           kind == TraceSpan::Reduce;
+}
+
+typedef std::tuple<int, int, int> RunKey; // module, hub, rank
+
+// execution of a module on a rank that ended last at or before limit
+struct Run {
+    bool valid = false;
+    double begin = 0., end = 0.;
+    double busy = 0., waiting = 0., transfer = 0.;
+};
+
+Run findRun(const std::vector<const TraceSpan *> &spans, double limit)
+{
+    // an execution starts with prepare, so disregard everything before the last prepare
+    double start = std::numeric_limits<double>::lowest();
+    for (const auto *s: spans) {
+        if (s->kind == TraceSpan::Prepare && s->begin <= limit && s->begin > start)
+            start = s->begin;
+    }
+
+    Run run;
+    std::vector<std::pair<double, double>> intervals;
+    for (const auto *s: spans) {
+        if (s->end > limit)
+            continue;
+        if (s->kind == TraceSpan::Transfer) {
+            if (s->end >= start)
+                run.transfer += s->duration();
+            continue;
+        }
+        if (s->begin < start)
+            continue;
+        if (s->kind == TraceSpan::Wait) {
+            run.waiting += s->duration();
+            continue;
+        }
+        if (!isModuleSpan(s->kind))
+            continue;
+        if (!run.valid) {
+            run.valid = true;
+            run.begin = s->begin;
+            run.end = s->end;
+        }
+        run.begin = std::min(run.begin, s->begin);
+        run.end = std::max(run.end, s->end);
+        intervals.emplace_back(s->begin, s->end);
+    }
+
+    // block spans overlap each other and compute, so count their union
+    std::sort(intervals.begin(), intervals.end());
+    double covered = std::numeric_limits<double>::lowest();
+    for (const auto &i: intervals) {
+        double b = std::max(i.first, covered);
+        if (i.second > b)
+            run.busy += i.second - b;
+        covered = std::max(covered, i.second);
+    }
+
+    return run;
+}
+
+void writeEscaped(std::ostream &str, const std::string &s)
+{
+    str << '"';
+    for (char c: s) {
+        if (c == '"' || c == '\\') {
+            str << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            str << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec << std::setfill(' ');
+        } else {
+            str << c;
+        }
+    }
+    str << '"';
+}
+
+// group spans by module so that concurrent block tasks and transfers end up on separate tracks
+int threadId(const TraceSpan &span)
+{
+    if (span.module < 0)
+        return 0;
+    switch (span.kind) {
+    case TraceSpan::Block:
+        return span.module * 100 + 1 + span.thread % 98;
+    case TraceSpan::Transfer:
+        return span.module * 100 + 99;
+    default:
+        return span.module * 100;
+    }
+}
+
+} // namespace
+
+std::atomic<bool> PipelineTracer::s_enabled{false};
+
+const char *TraceSpan::toString(Kind kind)
+{
+    switch (kind) {
+    case Prepare:
+        return "prepare";
+    case Compute:
+        return "compute";
+    case Block:
+        return "block";
+    case Reduce:
+        return "reduce";
+    case Transfer:
+        return "transfer";
+    case Wait:
+        return "wait";
+    case NumKinds:
+        break;
+    }
+    return "unknown";
+}
+
+PipelineTracer &PipelineTracer::the()
+{
+    static PipelineTracer tracer;
+    return tracer;
+}
+
+void PipelineTracer::enable(bool on)
+{
+    s_enabled = on;
+}
+
+double PipelineTracer::now()
+{
+    auto now = std::chrono::system_clock::now();
+    return 1e-9 * std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+}
+
+int PipelineTracer::threadNumber()
+{
+    if (t_thread == 0)
+        t_thread = s_nextThread++;
+    return t_thread;
+}
+
+void PipelineTracer::record(TraceSpan &&span)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_spans.size() >= MaxSpans) {
+        ++m_dropped;
+        return;
+    }
+    m_spans.emplace_back(std::move(span));
+}
+
+std::vector<TraceSpan> PipelineTracer::take()
+{
+    std::vector<TraceSpan> spans;
+    std::lock_guard<std::mutex> guard(m_mutex);
+    std::swap(spans, m_spans);
+    return spans;
+}
+
+bool PipelineTracer::empty() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_spans.empty();
+}
+
+size_t PipelineTracer::numDropped() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_dropped;
+}
+
+TraceScope::TraceScope(TraceSpan::Kind kind, int module, int rank, int block, int timestep)
+: m_active(PipelineTracer::enabled())
+{
+    if (!m_active)
+        return;
+    m_span.kind = kind;
+    m_span.module = module;
+    m_span.rank = rank;
+    m_span.block = block;
+    m_span.timestep = timestep;
+    m_span.thread = PipelineTracer::threadNumber();
+    m_span.begin = PipelineTracer::now();
+}
+
+TraceScope::~TraceScope()
+{
+    end();
+}
+
+void TraceScope::end()
+{
+    if (!m_active)
+        return;
+    m_active = false;
+    m_span.end = PipelineTracer::now();
+    PipelineTracer::the().record(std::move(m_span));
+}
+
+void TraceScope::cancel()
+{
+    m_active = false;
+}
+
+void TraceScope::setBlock(int block, int timestep)
+{
+    m_span.block = block;
+    m_span.timestep = timestep;
+}
+
+std::vector<CriticalStep> criticalPath(const std::vector<TraceSpan> &spans,
+                                       const std::function<std::set<int>(int)> &upstreamModules)
+{
+    std::vector<CriticalStep> path;
+
+    std::map<RunKey, std::vector<const TraceSpan *>> byRun;
+    std::map<int, std::set<RunKey>> byModule;
+    const TraceSpan *last = nullptr;
+    for (const auto &s: spans) {
+        RunKey key(s.module, s.hub, s.rank);
+        byRun[key].push_back(&s);
+        byModule[s.module].insert(key);
+        if (isModuleSpan(s.kind) && (!last || s.end > last->end))
+            last = &s;
+    }
+    if (!last)
+        return path;
+
+    // the rank of module that finished last before limit
+    auto gatingRun = [&byRun, &byModule](int module, double limit, CriticalStep &step) -> bool {
+        bool found = false;
+        for (const auto &key: byModule[module]) {
+            auto run = findRun(byRun[key], limit);
+            if (!run.valid || (found && run.end <= step.end))
+                continue;
+            found = true;
+            step.module = module;
+            step.hub = std::get<1>(key);
+            step.rank = std::get<2>(key);
+            step.begin = run.begin;
+            step.end = run.end;
+            step.busy = run.busy;
+            step.waiting = run.waiting;
+            step.transfer = run.transfer;
+        }
+        return found;
+    };
+
+    std::set<int> visited;
+    int module = last->module;
+    double limit = last->end;
+    while (visited.insert(module).second) {
+        CriticalStep step;
+        if (!gatingRun(module, limit, step))
+            break;
+        path.push_back(step);
+
+        // continue with the upstream module that was the last to finish
+        CriticalStep up;
+        bool found = false;
+        for (int m: upstreamModules(module)) {
+            CriticalStep candidate;
+            if (gatingRun(m, step.end, candidate) && (!found || candidate.end > up.end)) {
+                found = true;
+                up = candidate;
+            }
+        }
+        if (!found)
+            break;
+        module = up.module;
+        limit = step.end;
+    }
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::string toChromeTrace(const std::vector<TraceSpan> &spans, const std::map<int, std::string> &moduleNames)
+{
+    double t0 = std::numeric_limits<double>::max();
+    std::map<std::pair<int, int>, int> pids;
+    std::map<std::pair<int, int>, std::string> threads;
+    for (const auto &s: spans) {
+        t0 = std::min(t0, s.begin);
+        pids.emplace(std::make_pair(s.hub, s.rank), 0);
+    }
+    int nextPid = 0;
+    for (auto &p: pids)
+        p.second = ++nextPid;
+
+    auto moduleName = [&moduleNames](int id) {
+        auto it = moduleNames.find(id);
+        std::string name = it == moduleNames.end() ? "Module" : it->second;
+        return name + "_" + std::to_string(id);
+    };
+
+    std::stringstream str;
+    str << std::fixed << std::setprecision(3);
+    str << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto &s: spans) {
+        int pid = pids[std::make_pair(s.hub, s.rank)];
+        int tid = threadId(s);
+        auto &thread = threads[std::make_pair(pid, tid)];
+        if (thread.empty()) {
+            if (s.module < 0)
+                thread = "manager";
+            else if (s.kind == TraceSpan::Block)
+                thread = moduleName(s.module) + " blocks";
+            else if (s.kind == TraceSpan::Transfer)
+                thread = moduleName(s.module) + " transfers";
+            else
+                thread = moduleName(s.module);
+        }
+
+        str << (first ? "\n" : ",\n");
+        first = false;
+        str << "{\"name\":";
+        writeEscaped(str, s.name.empty() ? TraceSpan::toString(TraceSpan::Kind(s.kind)) : s.name);
+        str << ",\"cat\":\"" << TraceSpan::toString(TraceSpan::Kind(s.kind)) << "\",\"ph\":\"X\"";
+        str << ",\"ts\":" << (s.begin - t0) * 1e6 << ",\"dur\":" << s.duration() * 1e6;
+        str << ",\"pid\":" << pid << ",\"tid\":" << tid;
+        str << ",\"args\":{\"module\":" << s.module << ",\"block\":" << s.block << ",\"timestep\":" << s.timestep
+            << "}}";
+    }
+
+    for (const auto &p: pids) {
+        str << (first ? "\n" : ",\n");
+        first = false;
+        str << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << p.second << ",\"args\":{\"name\":\"hub "
+            << p.first.first << " rank " << p.first.second << "\"}}";
+    }
+    for (const auto &t: threads) {
+        str << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << t.first.first << ",\"tid\":" << t.first.second
+            << ",\"args\":{\"name\":";
+        writeEscaped(str, t.second);
+        str << "}}";
+    }
+    str << "\n]}\n";
+
+    return str.str();
+}
+
+} // namespace vistle
@@ -0,0 +1,129 @@
+#ifndef VISTLE_PIPELINETRACE_H
+#define VISTLE_PIPELINETRACE_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "archives_config.h"
+#include "export.h"
+
+namespace vistle {
+
+//! a timed section of a pipeline execution on one rank
+struct V_COREEXPORT TraceSpan {
+    enum Kind {
+        Prepare,
+        Compute, //!< call of compute() by module's event loop
+        Block, //!< compute(BlockTask) on a worker thread
+        Reduce,
+        Transfer, //!< retrieval of an object from a remote hub, from request until completion
+        Wait, //!< module blocked waiting for messages while executing
+        NumKinds,
+    };
+    static const char *toString(Kind kind);
+
+    int kind = Compute;
+    int module = -1; //!< module id, for transfers the receiving module
+    int hub = 0; //!< filled in when received by state tracker
+    int rank = -1;
+    int thread = 0; //!< small per-process thread number
+    int block = -1;
+    int timestep = -1;
+    double begin = 0.; //!< seconds since epoch of system clock, comparable across hosts if their clocks are in sync
+    double end = 0.;
+    std::string name; //!< optional detail, e.g. object name
+
+    double duration() const { return end - begin; }
+
+    ARCHIVE_ACCESS
+    template<class Archive>
+    void serialize(Archive &ar)
+    {
+        ar &kind;
+        ar &module;
+        ar &hub;
+        ar &rank;
+        ar &thread;
+        ar &block;
+        ar &timestep;
+        ar &begin;
+        ar &end;
+        ar &name;
+    }
+};
+
+//! collects trace spans within a process until they are sent to the hub
+/*! recording is switched on and off at run-time with the session parameter trace_pipeline,
+    when off, the cost of a TraceScope is a single relaxed atomic load */
+class V_COREEXPORT PipelineTracer {
+public:
+    static const size_t MaxSpans = 100000; //!< further spans are dropped until buffer is taken
+
+    static PipelineTracer &the();
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void enable(bool on);
+    static double now();
+    static int threadNumber();
+
+    void record(TraceSpan &&span);
+    //! remove and return all spans recorded so far
+    std::vector<TraceSpan> take();
+    bool empty() const;
+    size_t numDropped() const;
+
+private:
+    static std::atomic<bool> s_enabled;
+    mutable std::mutex m_mutex;
+    std::vector<TraceSpan> m_spans;
+    size_t m_dropped = 0;
+};
+
+//! record a span for the enclosing scope, if tracing is enabled
+class V_COREEXPORT TraceScope {
+public:
+    TraceScope(TraceSpan::Kind kind, int module, int rank, int block = -1, int timestep = -1);
+    ~TraceScope();
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+    bool active() const { return m_active; }
+    void setBlock(int block, int timestep = -1);
+    //! record span now instead of when leaving scope
+    void end();
+    //! do not record this span at all
+    void cancel();
+
+private:
+    bool m_active = false;
+    TraceSpan m_span;
+};
+
+//! one module on one rank gating the completion of a pipeline execution
+struct V_COREEXPORT CriticalStep {
+    int module = -1;
+    int hub = 0;
+    int rank = -1;
+    double begin = 0.; //!< start of module's execution on rank
+    double end = 0.; //!< end of module's execution on rank
+    double busy = 0.; //!< time covered by prepare, compute, block and reduce spans
+    double waiting = 0.; //!< time spent waiting for messages
+    double transfer = 0.; //!< time spent retrieving inputs from remote hubs
+};
+
+//! find the chain of modules and ranks determining when the most recent pipeline execution finished
+/*! starting from the module execution that ended last, repeatedly step to the upstream module execution
+    that ended last before: the first element is the start of the pipeline, the last its end */
+V_COREEXPORT std::vector<CriticalStep> criticalPath(const std::vector<TraceSpan> &spans,
+                                                    const std::function<std::set<int>(int)> &upstreamModules);
+
+//! convert spans to Chrome trace event format, as read by Perfetto or chrome://tracing
+V_COREEXPORT std::string toChromeTrace(const std::vector<TraceSpan> &spans,
+                                       const std::map<int, std::string> &moduleNames);
+
+} // namespace vistle
+#endif
@@ -9,8 +9,20 @@
 //#include <boost/mpl/transform.hpp>
 
 #include <climits>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/mempolicy.h>
+#endif
 
 #include <vistle/util/valgrind.h>
+#include <vistle/util/stopwatch.h>
+#include <vistle/util/crypto.h>
 #include "messagequeue.h"
 //#include "scalars.h"
 #include <cassert>
@@ -54,6 +66,14 @@ size_t memorySize<8>()
     }
 }
 
+#ifndef NO_SHMEM
+//! page placement chosen by the creator of a segment, honored by all processes attaching to it
+struct Shm::Placement {
+    bool hugePages = false;
+    NumaPlacement numa = NumaDefault;
+};
+#endif
+
 Shm *Shm::s_singleton = nullptr;
 #ifndef NO_SHMEM
 bool Shm::s_perRank = false;
@@ -98,6 +118,7 @@ Shm::Shm(const std::string &instanceName, const int m, const int r, size_t size)
 
 #ifdef NO_SHMEM
     (void)size;
+    m_statistics = new ShmStatistics;
     m_allocator = new void_allocator();
     m_shmDeletionMutex = new std::recursive_mutex;
     m_objectDictionaryMutex = new std::recursive_mutex;
@@ -108,7 +129,13 @@ Shm::Shm(const std::string &instanceName, const int m, const int r, size_t size)
         m_shm = new managed_shm(interprocess::open_only, name().c_str());
     }
 
-    m_allocator = new void_allocator(shm().get_segment_manager());
+    m_placement = m_shm->find_or_construct<Placement>("vistle_placement")();
+    applyPlacement(size > 0);
+
+    m_statistics = m_shm->find_or_construct<ShmStatistics>("vistle_statistics")();
+    m_heap = m_shm->find_or_construct<ShmHeap>("vistle_heap")(m_shm->get_segment_manager(), m_statistics);
+    ShmHeap::setOwner(m_id);
+    m_allocator = new void_allocator(m_heap);
 
     m_shmDeletionMutex = m_shm->find_or_construct<interprocess::interprocess_recursive_mutex>("shmdelete_mutex")();
     m_objectDictionaryMutex =
@@ -132,6 +159,8 @@ Shm::~Shm()
         std::cerr << "removed shm " << name() << std::endl;
     }
     delete m_shm;
+#else
+    delete m_statistics;
 #endif
 
     delete m_allocator;
@@ -140,6 +169,9 @@ Shm::~Shm()
 void Shm::setId(int id)
 {
     m_id = id;
+#ifndef NO_SHMEM
+    ShmHeap::setOwner(id);
+#endif
 }
 
 void Shm::detach()
@@ -153,6 +185,128 @@ void Shm::setRemoveOnDetach()
     m_remove = true;
 }
 
+bool Shm::hugePages() const
+{
+#ifdef NO_SHMEM
+    return false;
+#else
+    return m_placement->hugePages;
+#endif
+}
+
+Shm::NumaPlacement Shm::numaPlacement() const
+{
+#ifdef NO_SHMEM
+    return NumaDefault;
+#else
+    return m_placement->numa;
+#endif
+}
+
+ShmStatistics &Shm::statistics() const
+{
+    return *m_statistics;
+}
+
+void Shm::setThreadOwner(int id)
+{
+#ifdef NO_SHMEM
+    (void)id;
+#else
+    ShmHeap::setThreadOwner(id);
+#endif
+}
+
+ShmStatistics *shmStatistics()
+{
+    return Shm::isAttached() ? &Shm::the().statistics() : nullptr;
+}
+
+ShmUsage Shm::usage() const
+{
+    ShmUsage usage;
+    usage.rank = m_owningRank;
+    usage.time = Clock::time();
+#ifndef NO_SHMEM
+    usage.segmentSize = m_shm->get_size();
+    usage.segmentFree = m_shm->get_free_memory();
+#endif
+    m_statistics->fill(usage);
+    return usage;
+}
+
+void Shm::applyPlacement(bool create)
+{
+#ifndef NO_SHMEM
+    if (create) {
+        if (const char *huge = getenv("VISTLE_SHM_HUGEPAGES")) {
+            m_placement->hugePages = atoi(huge) != 0;
+        }
+        if (const char *numa = getenv("VISTLE_SHM_NUMA")) {
+            std::string policy(numa);
+            if (policy == "local") {
+                m_placement->numa = NumaLocal;
+                if (!s_perRank) {
+                    std::cerr << "Shm: segment is shared by all ranks on node, interleaving instead of binding to "
+                                 "local NUMA node"
+                              << std::endl;
+                    m_placement->numa = NumaInterleave;
+                }
+            } else if (policy == "interleave") {
+                m_placement->numa = NumaInterleave;
+            } else if (!policy.empty() && policy != "default") {
+                std::cerr << "Shm: unknown NUMA placement " << policy << ", using default" << std::endl;
+            }
+        }
+    }
+
+#ifdef __linux__
+    void *addr = m_shm->get_address();
+    const size_t len = m_shm->get_size();
+
+    // the advice applies to a single mapping, so every process has to set it
+    if (m_placement->hugePages) {
+        if (madvise(addr, len, MADV_HUGEPAGE) != 0) {
+            std::cerr << "Shm: failed to enable transparent huge pages: " << strerror(errno) << std::endl;
+        }
+    }
+
+    // the memory policy is shared by all mappings of the segment, so set it once - pages touched already are not moved
+    if (!create || m_placement->numa == NumaDefault)
+        return;
+
+    const unsigned long bits = sizeof(unsigned long) * CHAR_BIT;
+    unsigned long nodemask[1024 / bits] = {};
+    const unsigned long maxnode = sizeof(nodemask) * CHAR_BIT;
+    int mode = MPOL_INTERLEAVE;
+    if (m_placement->numa == NumaLocal) {
+        unsigned cpu = 0, node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0 || node >= maxnode) {
+            std::cerr << "Shm: failed to determine NUMA node: " << strerror(errno) << std::endl;
+            return;
+        }
+        nodemask[node / bits] |= 1ul << (node % bits);
+        mode = MPOL_PREFERRED;
+    } else {
+        int current = 0;
+        if (syscall(SYS_get_mempolicy, &current, nodemask, maxnode, nullptr, MPOL_F_MEMS_ALLOWED) != 0) {
+            std::cerr << "Shm: failed to query allowed NUMA nodes: " << strerror(errno) << std::endl;
+            return;
+        }
+    }
+    if (syscall(SYS_mbind, addr, len, mode, nodemask, maxnode, 0) != 0) {
+        std::cerr << "Shm: failed to set NUMA placement: " << strerror(errno) << std::endl;
+    }
+#else
+    if (m_placement->hugePages || m_placement->numa != NumaDefault) {
+        std::cerr << "Shm: huge pages and NUMA placement are only supported on Linux" << std::endl;
+    }
+#endif
+#else
+    (void)create;
+#endif
+}
+
 std::string Shm::shmIdFilename()
 {
     std::stringstream name;
@@ -312,6 +466,13 @@ const Shm::void_allocator &Shm::allocator() const
     return *m_allocator;
 }
 
+#ifndef NO_SHMEM
+ShmHeap &Shm::heap() const
+{
+    return *m_heap;
+}
+#endif
+
 Shm &Shm::the()
 {
 #ifndef MODULE_THREAD
@@ -521,6 +682,82 @@ void Shm::addArray(const std::string &name, const ShmData *array)
 #endif
 }
 
+std::string Shm::arrayHash(const std::string &name, unsigned type, const void *data, size_t size)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_arrayHashMutex);
+        auto it = m_hashByArray.find(name);
+        if (it != m_hashByArray.end())
+            return it->second;
+    }
+
+    // type and size are part of the hash, so that arrays of different type cannot be confused
+    uint64_t header[2] = {type, size};
+    auto hash = crypto::hash_new();
+    crypto::hash_update(hash, header, sizeof(header));
+    if (size > 0)
+        crypto::hash_update(hash, data, size);
+    std::string hex = crypto::hex_encode(crypto::hash_final(hash));
+
+    std::lock_guard<std::mutex> guard(m_arrayHashMutex);
+    m_hashByArray[name] = hex;
+    pruneArrayHashes();
+    return hex;
+}
+
+void Shm::registerArrayHash(const std::string &name, const std::string &hash)
+{
+    if (name.empty() || hash.empty())
+        return;
+
+    std::lock_guard<std::mutex> guard(m_arrayHashMutex);
+    m_hashByArray[name] = hash;
+    m_arrayByHash[hash] = name;
+    pruneArrayHashes();
+}
+
+std::string Shm::findArrayByHash(const std::string &hash)
+{
+    std::lock_guard<std::mutex> guard(m_arrayHashMutex);
+    auto it = m_arrayByHash.find(hash);
+    if (it == m_arrayByHash.end())
+        return std::string();
+    if (!arrayExists(it->second)) {
+        m_hashByArray.erase(it->second);
+        m_arrayByHash.erase(it);
+        return std::string();
+    }
+    return it->second;
+}
+
+bool Shm::arrayExists(const std::string &name) const
+{
+    return vistle::shm<char>::find(name) != nullptr;
+}
+
+void Shm::pruneArrayHashes()
+{
+    // drop entries for arrays that have been deleted in the meantime, amortized over insertions
+    if (m_hashByArray.size() + m_arrayByHash.size() < m_arrayHashPruneSize)
+        return;
+
+    for (auto it = m_hashByArray.begin(); it != m_hashByArray.end();) {
+        if (arrayExists(it->first)) {
+            ++it;
+        } else {
+            it = m_hashByArray.erase(it);
+        }
+    }
+    for (auto it = m_arrayByHash.begin(); it != m_arrayByHash.end();) {
+        if (m_hashByArray.find(it->second) != m_hashByArray.end()) {
+            ++it;
+        } else {
+            it = m_arrayByHash.erase(it);
+        }
+    }
+    m_arrayHashPruneSize = std::max(size_t(1024), 2 * (m_hashByArray.size() + m_arrayByHash.size()));
+}
+
 shm_handle_t Shm::getHandleFromObject(Object::const_ptr object) const
 {
 #ifdef NO_SHMEM
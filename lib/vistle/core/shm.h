@@ -37,6 +37,7 @@
 #include "shmname.h"
 #include "shmdata.h"
 #include "shm_config.h"
+#include "shm_statistics.h"
 
 #if defined(BOOST_INTERPROCESS_POSIX_BARRIERS) && defined(BOOST_INTERPROCESS_POSIX_PROCESS_SHARED)
 #define SHMBARRIER
@@ -148,6 +149,25 @@ public:
     void detach();
     void setRemoveOnDetach();
 
+    //! placement of the pages of the shared memory segment on NUMA nodes
+    enum NumaPlacement {
+        NumaDefault, //!< first touch
+        NumaLocal, //!< prefer node of creating rank
+        NumaInterleave, //!< interleave across all nodes the creating rank may use
+    };
+    //! whether segment is backed by transparent huge pages - set VISTLE_SHM_HUGEPAGES=1 before creating shm
+    bool hugePages() const;
+    //! NUMA placement of segment - set VISTLE_SHM_NUMA=local or VISTLE_SHM_NUMA=interleave before creating shm
+    NumaPlacement numaPlacement() const;
+
+    //! usage counters shared by all processes attached to segment
+    ShmStatistics &statistics() const;
+    //! snapshot of memory usage of segment
+    ShmUsage usage() const;
+    //! attribute memory allocated by the calling thread to module id instead of the owner of this process
+    /*! for modules running as threads of the hub process, i.e. with VISTLE_MULTI_PROCESS=OFF */
+    static void setThreadOwner(int id);
+
     std::string name() const;
     const std::string &instanceName() const;
     int owningRank() const;
@@ -159,9 +179,10 @@ public:
 #ifdef NO_SHMEM
     typedef vistle::default_init_allocator<void> void_allocator;
 #else
-    typedef boost::interprocess::allocator<void, managed_shm::segment_manager> void_allocator;
+    typedef shm_allocator<void> void_allocator;
     managed_shm &shm();
     const managed_shm &shm() const;
+    ShmHeap &heap() const;
 #endif
     const void_allocator &allocator() const;
 
@@ -194,6 +215,13 @@ public:
     void markAsRemoved(const std::string &name);
     void addObject(const std::string &name, const shm_handle_t &handle);
     void addArray(const std::string &name, const ShmData *array);
+
+    //! compute content hash of an array of type with size bytes at data, cached as long as array with name exists
+    std::string arrayHash(const std::string &name, unsigned type, const void *data, size_t size);
+    //! record that array with name has content hash, so that it can be found by findArrayByHash
+    void registerArrayHash(const std::string &name, const std::string &hash);
+    //! return name of an existing array with content hash, empty if there is none
+    std::string findArrayByHash(const std::string &hash);
 #ifdef SHMDEBUG
 #ifdef NO_SHMEM
     static std::vector<ShmDebugInfo, vistle::shm<ShmDebugInfo>::allocator> *s_shmdebug;
@@ -215,6 +243,7 @@ private:
     ~Shm();
     std::string createId(const std::string &id, int internalId, const std::string &suffix);
     void setId(int id);
+    void applyPlacement(bool create);
     void_allocator *m_allocator;
     std::string m_name;
     bool m_remove;
@@ -225,6 +254,7 @@ private:
     int m_ranksPerNode = -1;
     std::vector<int> m_nodeRanks; // mapping of global rank to ranks on each node
     std::atomic<int> m_objectId, m_arrayId;
+    ShmStatistics *m_statistics = nullptr;
     static Shm *s_singleton;
 #ifdef NO_SHMEM
     mutable std::recursive_mutex *m_shmDeletionMutex;
@@ -235,8 +265,17 @@ private:
     mutable boost::interprocess::interprocess_recursive_mutex *m_shmDeletionMutex;
     mutable boost::interprocess::interprocess_recursive_mutex *m_objectDictionaryMutex;
     managed_shm *m_shm;
+    ShmHeap *m_heap = nullptr;
+    struct Placement;
+    Placement *m_placement = nullptr;
 #endif
     mutable std::atomic<int> m_lockCount;
+    std::mutex m_arrayHashMutex;
+    std::map<std::string, std::string> m_arrayByHash; // content hash -> array name
+    std::map<std::string, std::string> m_hashByArray; // array name -> content hash
+    size_t m_arrayHashPruneSize = 1024;
+    bool arrayExists(const std::string &name) const;
+    void pruneArrayHashes();
 #ifdef SHMBARRIER
 #ifndef NO_SHMEM
     std::map<std::string, boost::interprocess::ipcdetail::barrier_initializer> m_barriers;
@@ -72,6 +72,8 @@ public:
 #else
     const vtkm::cont::ArrayHandle<handle_type> handle() const;
 #endif
+    //! resize to size and return a handle referring to the array's memory, for filling it from VTK-m without copies
+    vtkm::cont::ArrayHandleBasic<handle_type> writeHandle(size_t size);
     void updateFromHandle(bool invalidate = false);
     void updateFromHandle(bool invalidate = false) const;
 
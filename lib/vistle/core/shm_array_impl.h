@@ -13,6 +13,7 @@
 #include "index.h"
 #include "archives_config.h"
 #include "shmdata.h"
+#include "shm_statistics.h"
 #include <vtkm/cont/ArrayRangeCompute.h>
 
 namespace vistle {
@@ -128,6 +129,27 @@ void shm_array<T, allocator>::setHandle(const ArrayHandle &h)
 #endif
 }
 
+template<typename T, class allocator>
+vtkm::cont::ArrayHandleBasic<typename shm_array<T, allocator>::handle_type>
+shm_array<T, allocator>::writeHandle(size_t size)
+{
+#ifdef NO_SHMEM
+    updateFromHandle(true);
+    // contents will be overwritten, and many vtk-m algorithms check that array sizes are exact
+    m_handle.Allocate(size, vtkm::CopyFlag::Off);
+    m_size = m_capacity = size;
+    m_memoryValid = false;
+    clearDimensionHint();
+    invalidate_bounds();
+    return m_handle;
+#else
+    resize(size);
+    invalidate_bounds();
+    return vtkm::cont::ArrayHandleBasic<handle_type>(reinterpret_cast<handle_type *>(m_data.get()), m_size,
+                                                     [](void *) {});
+#endif
+}
+
 template<typename T, class allocator>
 bool shm_array<T, allocator>::check(std::ostream &os) const
 {
@@ -282,6 +304,8 @@ void shm_array<T, allocator>::reserve_or_shrink(const size_t capacity)
         return;
 
     PROF_SCOPE("shm_array::reserve_or_shrink()");
+    if (auto *statistics = shmStatistics())
+        statistics->resized(ShmStatistics::ArrayType, m_type, sizeof(T) * m_capacity, sizeof(T) * capacity);
 #ifdef NO_SHMEM
     m_capacity = capacity;
     updateFromHandle(true);
@@ -9,6 +9,7 @@
 #else
 #include <boost/interprocess/managed_shared_memory.hpp>
 #endif
+#include "shm_heap.h"
 #endif
 
 
@@ -27,7 +28,7 @@ typedef boost::interprocess::managed_shared_memory managed_shm;
 
 typedef managed_shm::handle_t shm_handle_t;
 template<typename T>
-using shm_allocator = boost::interprocess::allocator<T, managed_shm::segment_manager>;
+using shm_allocator = shm_heap_allocator<T>;
 #endif
 
 } // namespace vistle
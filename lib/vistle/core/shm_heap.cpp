@@ -0,0 +1,181 @@
+#include "shm_heap.h"
+
+#ifndef NO_SHMEM
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace vistle {
+
+namespace {
+
+constexpr size_t ClassSize[ShmHeap::NumSizeClasses] = {16,   32,   48,   64,   80,    96,    112,   128,
+                                                       192,  256,  384,  512,  768,   1024,  1536,  2048,
+                                                       3072, 4096, 6144, 8192, 12288, 16384, 24576, ShmHeap::MaxSmallSize};
+static_assert(ClassSize[ShmHeap::NumSizeClasses - 1] == ShmHeap::MaxSmallSize, "largest size class has to be limit");
+
+// unit in which arenas obtain memory from the segment manager
+const size_t ChunkSize = size_t(1) << 18;
+const unsigned LargeBlock = ShmHeap::NumSizeClasses;
+const uint8_t Magic = 0xa5;
+
+thread_local unsigned t_arena = ~0u;
+const int NoOwner = INT_MIN;
+thread_local int t_owner = NoOwner;
+
+static_assert(ShmHeap::NumArenas == ShmStatistics::NumShards, "allocations are counted per arena");
+
+} // namespace
+
+// precedes every block, keeps payload aligned as if allocated by the segment manager
+struct alignas(16) ShmHeap::Header {
+    uint64_t size; // as requested
+    int32_t owner; // module id of allocating process
+    uint16_t arena;
+    uint8_t cls;
+    uint8_t magic;
+};
+
+int ShmHeap::s_owner = 0;
+
+ShmHeap::ShmHeap(managed_shm::segment_manager *segmentManager, ShmStatistics *statistics)
+: m_segmentManager(segmentManager), m_statistics(statistics)
+{
+    static_assert(sizeof(Header) == 16, "block header has to preserve alignment");
+    if (const char *arenas = getenv("VISTLE_SHM_ARENAS")) {
+        m_arenasEnabled = atoi(arenas) != 0;
+    }
+}
+
+managed_shm::segment_manager *ShmHeap::segmentManager() const
+{
+    return m_segmentManager.get();
+}
+
+ShmStatistics &ShmHeap::statistics() const
+{
+    return *m_statistics;
+}
+
+void ShmHeap::setOwner(int id)
+{
+    s_owner = id;
+}
+
+void ShmHeap::setThreadOwner(int id)
+{
+    t_owner = id;
+}
+
+bool ShmHeap::arenasEnabled() const
+{
+    return m_arenasEnabled;
+}
+
+unsigned ShmHeap::sizeClass(size_t size)
+{
+    return std::lower_bound(ClassSize, ClassSize + NumSizeClasses, size) - ClassSize;
+}
+
+unsigned ShmHeap::currentArena()
+{
+    // threads are distributed over arenas round-robin, across all processes attached to the segment
+    if (t_arena >= NumArenas)
+        t_arena = m_nextArena.fetch_add(1) % NumArenas;
+    return t_arena;
+}
+
+bool ShmHeap::refill(Arena &arena, unsigned arenaIdx, unsigned cls)
+{
+    // carve a batch of up to 64 blocks from a fresh chunk, writing a header into each of them
+    const size_t blockSize = sizeof(Header) + ClassSize[cls];
+    const size_t count = std::max<size_t>(1, std::min<size_t>(ChunkSize / blockSize, 64));
+    char *chunk = static_cast<char *>(m_segmentManager->allocate(count * blockSize, std::nothrow));
+    if (!chunk)
+        return false;
+    for (size_t i = 0; i < count; ++i) {
+        auto *header = reinterpret_cast<Header *>(chunk + i * blockSize);
+        header->magic = Magic;
+        header->arena = arenaIdx;
+        header->cls = cls;
+        auto *block = reinterpret_cast<FreeBlock *>(header + 1);
+        new (block) FreeBlock;
+        block->next = arena.free[cls];
+        arena.free[cls] = block;
+    }
+    m_statistics->cached(arenaIdx, count * ClassSize[cls]);
+    return true;
+}
+
+void *ShmHeap::allocate(size_t size)
+{
+    const int owner = t_owner == NoOwner ? s_owner : t_owner;
+    const unsigned idx = currentArena();
+    auto &arena = m_arenas[idx];
+
+    if (!m_arenasEnabled || size > MaxSmallSize) {
+        auto *header = static_cast<Header *>(m_segmentManager->allocate(sizeof(Header) + size));
+        header->size = size;
+        header->owner = owner;
+        header->magic = Magic;
+        header->arena = idx;
+        header->cls = LargeBlock;
+        // accounting is serialized per arena, also for blocks not taken from the arena
+        std::lock_guard<boost::interprocess::interprocess_mutex> guard(arena.mutex);
+        m_statistics->allocated(idx, owner, size);
+        return header + 1;
+    }
+
+    const unsigned cls = sizeClass(size);
+    std::lock_guard<boost::interprocess::interprocess_mutex> guard(arena.mutex);
+    if (!arena.free[cls] && !refill(arena, idx, cls)) {
+        throw boost::interprocess::bad_alloc();
+    }
+    FreeBlock *block = arena.free[cls].get();
+    arena.free[cls] = block->next;
+    block->~FreeBlock();
+    auto *header = reinterpret_cast<Header *>(block) - 1;
+    header->size = size;
+    header->owner = owner;
+    m_statistics->allocated(idx, owner, size);
+    m_statistics->cached(idx, -int64_t(ClassSize[cls]));
+    return block;
+}
+
+void ShmHeap::deallocate(void *p)
+{
+    if (!p)
+        return;
+
+    auto *header = static_cast<Header *>(p) - 1;
+    assert(header->magic == Magic);
+    assert(header->arena < NumArenas);
+    const unsigned idx = header->arena;
+    auto &arena = m_arenas[idx];
+    if (header->cls == LargeBlock) {
+        {
+            std::lock_guard<boost::interprocess::interprocess_mutex> guard(arena.mutex);
+            m_statistics->deallocated(idx, header->owner, header->size);
+        }
+        m_segmentManager->deallocate(header);
+        return;
+    }
+
+    // blocks are returned to the arena they were carved from, even when freed by another thread or process
+    assert(header->cls < NumSizeClasses);
+    std::lock_guard<boost::interprocess::interprocess_mutex> guard(arena.mutex);
+    m_statistics->deallocated(idx, header->owner, header->size);
+    const unsigned cls = header->cls;
+    auto *block = new (p) FreeBlock;
+    block->next = arena.free[cls];
+    arena.free[cls] = block;
+    m_statistics->cached(idx, ClassSize[cls]);
+}
+
+} // namespace vistle
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef VISTLE_SHM_HEAP_H
+#define VISTLE_SHM_HEAP_H
+
+#ifndef NO_SHMEM
+
+#include <vistle/util/boost_interprocess_config.h>
+#ifdef _WIN32
+#include <boost/interprocess/managed_windows_shared_memory.hpp>
+#else
+#include <boost/interprocess/managed_shared_memory.hpp>
+#endif
+#include <boost/interprocess/offset_ptr.hpp>
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "export.h"
+#include "shm_statistics.h"
+
+namespace vistle {
+
+#ifdef _WIN32
+typedef boost::interprocess::managed_windows_shared_memory managed_shm;
+#else
+typedef boost::interprocess::managed_shared_memory managed_shm;
+#endif
+
+//! allocator for vistle's shared memory segment, constructed within the segment and shared by all processes
+/*! small blocks are served from size-class free lists in one of several arenas, so that concurrent allocations
+    from different threads and processes do not serialize on the segment manager's mutex,
+    large blocks are passed through to the segment manager */
+class V_COREEXPORT ShmHeap {
+public:
+    //! blocks cached in the arenas' free lists are never returned to the segment manager:
+    /*! each refill caches up to 256 KiB (64 blocks, but at most one chunk of 1<<18 bytes), so refills alone may leave
+        up to NumArenas * NumSizeClasses * 256 KiB = 384 MiB of the segment cached, on top of freed blocks that
+        are kept for reuse in their size class */
+    static constexpr unsigned NumArenas = 64;
+    static constexpr size_t MaxSmallSize = 32768; //!< larger blocks bypass the arenas
+    static constexpr unsigned NumSizeClasses = 24;
+
+    ShmHeap(managed_shm::segment_manager *segmentManager, ShmStatistics *statistics);
+    ShmHeap(const ShmHeap &) = delete;
+    ShmHeap &operator=(const ShmHeap &) = delete;
+
+    void *allocate(size_t size);
+    void deallocate(void *p);
+
+    managed_shm::segment_manager *segmentManager() const;
+    ShmStatistics &statistics() const;
+    //! module id to which allocations from this process are attributed
+    static void setOwner(int id);
+    //! module id to which allocations from the calling thread are attributed, overrides setOwner
+    /*! for modules running as threads within the hub process (VISTLE_MULTI_PROCESS=OFF):
+        allocations from threads started by a module itself are still attributed to the process owner */
+    static void setThreadOwner(int id);
+    //! whether small blocks are taken from arenas - can be disabled with VISTLE_SHM_ARENAS=0 before creating shm
+    bool arenasEnabled() const;
+
+private:
+    struct Header;
+    struct FreeBlock {
+        boost::interprocess::offset_ptr<FreeBlock> next;
+    };
+    struct Arena {
+        boost::interprocess::interprocess_mutex mutex;
+        boost::interprocess::offset_ptr<FreeBlock> free[NumSizeClasses];
+    };
+
+    static unsigned sizeClass(size_t size);
+    unsigned currentArena();
+    bool refill(Arena &arena, unsigned arenaIdx, unsigned cls);
+
+    static int s_owner;
+
+    boost::interprocess::offset_ptr<managed_shm::segment_manager> m_segmentManager;
+    boost::interprocess::offset_ptr<ShmStatistics> m_statistics;
+    bool m_arenasEnabled = true;
+    std::atomic<unsigned> m_nextArena{0};
+    Arena m_arenas[NumArenas];
+};
+
+//! allocator for objects and arrays in shared memory, obtains memory from the segment's ShmHeap
+template<typename T>
+class shm_heap_allocator {
+    template<typename U>
+    friend class shm_heap_allocator;
+
+public:
+    typedef T value_type;
+    typedef boost::interprocess::offset_ptr<T> pointer;
+    typedef boost::interprocess::offset_ptr<const T> const_pointer;
+    typedef boost::interprocess::offset_ptr<void> void_pointer;
+    typedef boost::interprocess::offset_ptr<const void> const_void_pointer;
+    typedef typename std::add_lvalue_reference<T>::type reference;
+    typedef typename std::add_lvalue_reference<const T>::type const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind {
+        typedef shm_heap_allocator<U> other;
+    };
+
+    explicit shm_heap_allocator(ShmHeap *heap = nullptr): m_heap(heap) {}
+    template<typename U>
+    shm_heap_allocator(const shm_heap_allocator<U> &other): m_heap(other.m_heap)
+    {}
+
+    pointer allocate(size_type n) { return pointer(static_cast<T *>(m_heap->allocate(n * sizeof(T)))); }
+    void deallocate(const pointer &p, size_type) { m_heap->deallocate(p.get()); }
+    size_type max_size() const { return std::numeric_limits<size_type>::max() / sizeof(T); }
+
+    ShmHeap *heap() const { return m_heap.get(); }
+
+    template<typename U>
+    bool operator==(const shm_heap_allocator<U> &other) const
+    {
+        return m_heap == other.m_heap;
+    }
+    template<typename U>
+    bool operator!=(const shm_heap_allocator<U> &other) const
+    {
+        return m_heap != other.m_heap;
+    }
+
+private:
+    boost::interprocess::offset_ptr<ShmHeap> m_heap;
+};
+
+} // namespace vistle
+
+#endif
+#endif
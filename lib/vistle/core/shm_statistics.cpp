@@ -0,0 +1,218 @@
+#include "shm_statistics.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <map>
+
+namespace vistle {
+
+namespace {
+
+const int EmptyKey = INT_MIN;
+
+// for counters that are only modified by one thread at a time
+template<typename T>
+void add(std::atomic<T> &counter, T delta)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+} // namespace
+
+double ShmUsage::fragmentation() const
+{
+    if (segmentSize <= segmentFree)
+        return 0.;
+    const double reserved = double(segmentSize - segmentFree);
+    if (reserved <= double(bytes))
+        return 0.;
+    return (reserved - double(bytes)) / reserved;
+}
+
+ShmStatistics::ShmStatistics()
+{
+    for (auto &shard: m_shards) {
+        for (auto &entry: shard.modules) {
+            entry.key = EmptyKey;
+        }
+    }
+    for (auto &cat: m_slots) {
+        for (auto &slot: cat) {
+            slot.key = EmptyKey;
+        }
+    }
+}
+
+void ShmStatistics::Counter::add(int64_t delta, int64_t deltaCount)
+{
+    count += deltaCount;
+    const int64_t current = bytes += delta;
+    int64_t high = highWater;
+    while (current > high && !highWater.compare_exchange_weak(high, current)) {
+    }
+}
+
+void ShmStatistics::Counter::fill(ShmUsageEntry &entry) const
+{
+    entry.bytes = std::max<int64_t>(0, bytes);
+    entry.highWater = std::max<int64_t>(0, highWater);
+    entry.count = count;
+}
+
+ShmStatistics::Shard::Entry *ShmStatistics::Shard::find(int key)
+{
+    // open addressing without removal, no competing claims as shards are modified by one thread at a time
+    const unsigned start = unsigned(key) % MaxShardKeys;
+    for (unsigned i = 0; i < MaxShardKeys; ++i) {
+        auto &entry = modules[(start + i) % MaxShardKeys];
+        int k = entry.key.load(std::memory_order_relaxed);
+        if (k == key)
+            return &entry;
+        if (k == EmptyKey) {
+            entry.key.store(key, std::memory_order_relaxed);
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+ShmStatistics::Counter *ShmStatistics::find(Category cat, int key)
+{
+    // open addressing without removal, so slots can be claimed concurrently from all processes
+    auto &slots = m_slots[cat];
+    const unsigned start = unsigned(key) % MaxKeys;
+    for (unsigned i = 0; i < MaxKeys; ++i) {
+        auto &slot = slots[(start + i) % MaxKeys];
+        int k = slot.key;
+        if (k == key)
+            return &slot.counter;
+        if (k == EmptyKey) {
+            if (slot.key.compare_exchange_strong(k, key) || k == key)
+                return &slot.counter;
+        }
+    }
+    return nullptr;
+}
+
+void ShmStatistics::resized(Category cat, int key, size_t oldBytes, size_t newBytes)
+{
+    if (oldBytes == newBytes)
+        return;
+    if (auto *counter = find(cat, key)) {
+        counter->add(int64_t(newBytes) - int64_t(oldBytes), int64_t(newBytes > 0) - int64_t(oldBytes > 0));
+    }
+}
+
+void ShmStatistics::created(Category cat, int key, size_t bytes)
+{
+    if (auto *counter = find(cat, key)) {
+        counter->add(bytes, 1);
+    }
+}
+
+void ShmStatistics::destroyed(Category cat, int key, size_t bytes)
+{
+    if (auto *counter = find(cat, key)) {
+        counter->add(-int64_t(bytes), -1);
+    }
+}
+
+void ShmStatistics::allocated(unsigned shard, int module, size_t bytes)
+{
+    assert(shard < NumShards);
+    auto &s = m_shards[shard];
+    add<uint64_t>(s.numAllocations, 1);
+    add<uint64_t>(s.allocatedBytes, bytes);
+    add<int64_t>(s.bytes, bytes);
+    add<int64_t>(s.count, 1);
+    if (auto *entry = s.find(module)) {
+        add<int64_t>(entry->bytes, bytes);
+        add<int64_t>(entry->count, 1);
+    }
+}
+
+void ShmStatistics::deallocated(unsigned shard, int module, size_t bytes)
+{
+    assert(shard < NumShards);
+    auto &s = m_shards[shard];
+    add<int64_t>(s.bytes, -int64_t(bytes));
+    add<int64_t>(s.count, -1);
+    if (auto *entry = s.find(module)) {
+        add<int64_t>(entry->bytes, -int64_t(bytes));
+        add<int64_t>(entry->count, -1);
+    }
+}
+
+void ShmStatistics::cached(unsigned shard, int64_t bytes)
+{
+    assert(shard < NumShards);
+    add<int64_t>(m_shards[shard].cached, bytes);
+}
+
+void ShmStatistics::fill(ShmUsage &usage)
+{
+    // totals are summed over shards, each shard is updated concurrently with taking this snapshot
+    int64_t bytes = 0, cached = 0;
+    uint64_t numAllocations = 0, allocatedBytes = 0;
+    std::map<int, ShmUsageEntry> modules;
+    for (const auto &shard: m_shards) {
+        bytes += shard.bytes.load(std::memory_order_relaxed);
+        cached += shard.cached.load(std::memory_order_relaxed);
+        numAllocations += shard.numAllocations.load(std::memory_order_relaxed);
+        allocatedBytes += shard.allocatedBytes.load(std::memory_order_relaxed);
+        for (const auto &e: shard.modules) {
+            int key = e.key.load(std::memory_order_relaxed);
+            if (key == EmptyKey)
+                continue;
+            auto &entry = modules[key];
+            entry.key = key;
+            entry.bytes += e.bytes.load(std::memory_order_relaxed);
+            entry.count += e.count.load(std::memory_order_relaxed);
+        }
+    }
+    int64_t high = m_highWater;
+    while (bytes > high && !m_highWater.compare_exchange_weak(high, bytes)) {
+    }
+    usage.bytes = std::max<int64_t>(0, bytes);
+    usage.highWater = std::max<int64_t>(0, m_highWater);
+    usage.cachedBytes = std::max<int64_t>(0, cached);
+    usage.numAllocations = numAllocations;
+    usage.allocatedBytes = allocatedBytes;
+
+    usage.modules.clear();
+    for (auto &m: modules) {
+        auto &entry = m.second;
+        entry.bytes = std::max<int64_t>(0, int64_t(entry.bytes));
+        if (auto *counter = find(Module, entry.key)) {
+            int64_t moduleHigh = counter->highWater;
+            while (int64_t(entry.bytes) > moduleHigh &&
+                   !counter->highWater.compare_exchange_weak(moduleHigh, entry.bytes)) {
+            }
+            entry.highWater = std::max<int64_t>(moduleHigh, entry.bytes);
+        }
+        if (entry.count == 0 && entry.highWater == 0)
+            continue;
+        usage.modules.push_back(entry);
+    }
+
+    std::vector<ShmUsageEntry> *entries[NumCategories] = {nullptr, &usage.objectTypes, &usage.arrayTypes};
+    for (unsigned c = 0; c < NumCategories; ++c) {
+        if (!entries[c])
+            continue;
+        entries[c]->clear();
+        for (const auto &slot: m_slots[c]) {
+            int key = slot.key;
+            if (key == EmptyKey)
+                continue;
+            ShmUsageEntry entry;
+            entry.key = key;
+            slot.counter.fill(entry);
+            if (entry.count == 0 && entry.highWater == 0)
+                continue;
+            entries[c]->push_back(entry);
+        }
+    }
+}
+
+} // namespace vistle
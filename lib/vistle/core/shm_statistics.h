@@ -0,0 +1,145 @@
+#ifndef VISTLE_SHM_STATISTICS_H
+#define VISTLE_SHM_STATISTICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "archives_config.h"
+#include "export.h"
+
+namespace vistle {
+
+//! memory attributed to a module, an object type or an array type
+struct V_COREEXPORT ShmUsageEntry {
+    int key = 0; //!< module id, Object::Type or array type id
+    uint64_t bytes = 0; //!< bytes currently allocated
+    uint64_t highWater = 0; //!< maximum of bytes, for modules as observed by snapshots
+    int64_t count = 0; //!< number of live allocations, objects or arrays
+
+    ARCHIVE_ACCESS
+    template<class Archive>
+    void serialize(Archive &ar)
+    {
+        ar &key;
+        ar &bytes;
+        ar &highWater;
+        ar &count;
+    }
+};
+
+//! snapshot of the usage of a shared memory segment
+struct V_COREEXPORT ShmUsage {
+    int rank = -1; //!< rank owning the segment
+    double time = 0.; //!< when snapshot was taken
+    uint64_t segmentSize = 0; //!< size of segment
+    uint64_t segmentFree = 0; //!< bytes not yet handed out by the segment manager
+    uint64_t bytes = 0; //!< bytes currently allocated through the vistle allocator
+    uint64_t highWater = 0; //!< maximum of bytes as observed by snapshots
+    uint64_t cachedBytes = 0; //!< freed small blocks kept for reuse in arenas
+    uint64_t numAllocations = 0; //!< allocations since segment creation
+    uint64_t allocatedBytes = 0; //!< bytes allocated since segment creation
+    double allocationRate = 0.; //!< bytes/s allocated since previous snapshot, filled in by publisher
+    std::vector<ShmUsageEntry> modules, objectTypes, arrayTypes;
+
+    //! share of memory taken from the segment that does not hold live allocations
+    /*! covers arena caches, size class rounding, named objects and the segment manager's bookkeeping */
+    double fragmentation() const;
+
+    ARCHIVE_ACCESS
+    template<class Archive>
+    void serialize(Archive &ar)
+    {
+        ar &rank;
+        ar &time;
+        ar &segmentSize;
+        ar &segmentFree;
+        ar &bytes;
+        ar &highWater;
+        ar &cachedBytes;
+        ar &numAllocations;
+        ar &allocatedBytes;
+        ar &allocationRate;
+        ar &modules;
+        ar &objectTypes;
+        ar &arrayTypes;
+    }
+};
+
+//! usage counters for a shared memory segment, shared by all processes attaching to it
+class V_COREEXPORT ShmStatistics {
+public:
+    enum Category {
+        Module,
+        ObjectType,
+        ArrayType,
+        NumCategories,
+    };
+    static constexpr unsigned MaxKeys = 512; //!< further keys within a category are not tracked
+    static constexpr unsigned NumShards = 64; //!< allocations are counted per shard, i.e. per ShmHeap arena
+    static constexpr unsigned MaxShardKeys = 128; //!< further modules allocating from a shard are not tracked
+
+    ShmStatistics();
+    ShmStatistics(const ShmStatistics &) = delete;
+    ShmStatistics &operator=(const ShmStatistics &) = delete;
+
+    //! record change of memory held by key from oldBytes to newBytes, count is adjusted when switching from/to 0
+    void resized(Category cat, int key, size_t oldBytes, size_t newBytes);
+    //! record creation of an item without known size (e.g. an object)
+    void created(Category cat, int key, size_t bytes = 0);
+    void destroyed(Category cat, int key, size_t bytes = 0);
+
+    //! record allocation through the vistle allocator by module
+    /*! calls for the same shard have to be serialized by the caller,
+        thus they do not need atomic read-modify-write operations on counters shared between processes */
+    void allocated(unsigned shard, int module, size_t bytes);
+    void deallocated(unsigned shard, int module, size_t bytes);
+    //! record memory moved to or taken from arena caches, serialized per shard like allocated()
+    void cached(unsigned shard, int64_t bytes);
+
+    //! fill counters into usage, leaves segment information alone
+    /*! high-water marks of total and per-module allocations are updated from the current values */
+    void fill(ShmUsage &usage);
+
+private:
+    struct Counter {
+        std::atomic<int64_t> bytes{0};
+        std::atomic<int64_t> highWater{0};
+        std::atomic<int64_t> count{0};
+
+        void add(int64_t delta, int64_t deltaCount);
+        void fill(ShmUsageEntry &entry) const;
+    };
+    struct Slot {
+        std::atomic<int> key;
+        Counter counter;
+    };
+
+    //! allocation counters modified by only one thread at a time
+    struct Shard {
+        struct Entry {
+            std::atomic<int> key;
+            std::atomic<int64_t> bytes{0};
+            std::atomic<int64_t> count{0};
+        };
+        std::atomic<int64_t> bytes{0}, count{0}, cached{0};
+        std::atomic<uint64_t> numAllocations{0}, allocatedBytes{0};
+        Entry modules[MaxShardKeys];
+        char padding[64]; //!< keep shards on separate cache lines
+
+        Entry *find(int key);
+    };
+
+    Counter *find(Category cat, int key);
+
+    std::atomic<int64_t> m_highWater{0};
+    Shard m_shards[NumShards];
+    Slot m_slots[NumCategories][MaxKeys];
+};
+
+//! statistics of the shared memory segment this process is attached to, nullptr if not attached
+V_COREEXPORT ShmStatistics *shmStatistics();
+
+} // namespace vistle
+#endif
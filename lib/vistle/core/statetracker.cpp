@@ -718,6 +718,16 @@ bool StateTracker::handle(const message::Message &msg, const char *payload, size
         handled = handlePriv(info, pl);
         break;
     }
+    case SHMINFO: {
+        const auto &info = msg.as<ShmInfo>();
+        handled = handlePriv(info, pl);
+        break;
+    }
+    case TRACEDATA: {
+        const auto &trace = msg.as<TraceData>();
+        handled = handlePriv(trace, pl);
+        break;
+    }
     case UPDATESTATUS: {
         const auto &status = msg.as<UpdateStatus>();
         handled = handlePriv(status);
@@ -869,6 +879,10 @@ bool StateTracker::handlePriv(const message::RemoveHub &rm)
     }
 
     runningMap.erase(id);
+    {
+        mutex_locker guard(m_stateMutex);
+        m_shmUsage.erase(id);
+    }
 
     auto it = std::find_if(m_hubs.begin(), m_hubs.end(), [id](const HubData &hub) { return hub.id == id; });
 
@@ -1497,6 +1511,31 @@ bool StateTracker::handlePriv(const message::ItemInfo &info, const buffer &paylo
     return true;
 }
 
+bool StateTracker::handlePriv(const message::ShmInfo &info, const buffer &payload)
+{
+    auto pl = message::getPayload<message::ShmInfo::Payload>(payload);
+    mutex_locker guard(m_stateMutex);
+    m_shmUsage[info.senderId()][pl.rank] = pl;
+    return true;
+}
+
+bool StateTracker::handlePriv(const message::TraceData &trace, const buffer &payload)
+{
+    // keep memory bounded if nobody collects the trace
+    static const size_t MaxTraceSpans = 1000000;
+
+    auto pl = message::getPayload<message::TraceData::Payload>(payload);
+    mutex_locker guard(m_stateMutex);
+    int hub = getHub(trace.senderId());
+    for (auto &span: pl) {
+        span.hub = hub;
+        m_traceSpans.emplace_back(std::move(span));
+    }
+    while (m_traceSpans.size() > MaxTraceSpans)
+        m_traceSpans.pop_front();
+    return true;
+}
+
 bool StateTracker::handlePriv(const message::SendText &info, const buffer &payload)
 {
     auto pl = message::getPayload<message::SendText::Payload>(payload);
@@ -2040,6 +2079,29 @@ std::string StateTracker::sessionUrl() const
     return m_sessionUrl;
 }
 
+std::map<int, std::map<int, ShmUsage>> StateTracker::shmUsage() const
+{
+    mutex_locker guard(m_stateMutex);
+    return m_shmUsage;
+}
+
+std::vector<TraceSpan> StateTracker::pipelineTrace() const
+{
+    mutex_locker guard(m_stateMutex);
+    return std::vector<TraceSpan>(m_traceSpans.begin(), m_traceSpans.end());
+}
+
+void StateTracker::clearPipelineTrace()
+{
+    mutex_locker guard(m_stateMutex);
+    m_traceSpans.clear();
+}
+
+std::vector<CriticalStep> StateTracker::pipelineCriticalPath() const
+{
+    return criticalPath(pipelineTrace(), [this](int id) { return getConnectedModules(Previous, id); });
+}
+
 std::string StateTracker::statusText() const
 {
     return m_currentStatus;
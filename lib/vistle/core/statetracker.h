@@ -1,6 +1,7 @@
 #ifndef STATETRACKER_H
 #define STATETRACKER_H
 
+#include <deque>
 #include <vector>
 #include <map>
 #include <set>
@@ -185,6 +186,15 @@ public:
     int workflowLoader() const;
     std::string sessionUrl() const;
 
+    //! most recent shared memory usage reports, indexed by hub id and rank
+    std::map<int, std::map<int, ShmUsage>> shmUsage() const;
+
+    //! spans of pipeline executions received while session parameter trace_pipeline was set
+    std::vector<TraceSpan> pipelineTrace() const;
+    void clearPipelineTrace();
+    //! modules and ranks that determined the duration of the most recent pipeline execution in the trace
+    std::vector<CriticalStep> pipelineCriticalPath() const;
+
     void printModules(bool withConnections = false) const;
 
     enum ConnectionKind {
@@ -299,6 +309,8 @@ private:
     bool handlePriv(const message::BarrierReached &barrierReached);
     bool handlePriv(const message::SendText &info, const buffer &payload);
     bool handlePriv(const message::ItemInfo &info, const buffer &payload);
+    bool handlePriv(const message::ShmInfo &info, const buffer &payload);
+    bool handlePriv(const message::TraceData &trace, const buffer &payload);
     bool handlePriv(const message::UpdateStatus &status);
     bool handlePriv(const message::ReplayFinished &reset);
     bool handlePriv(const message::Quit &quit);
@@ -342,6 +354,8 @@ private:
     int m_workflowLoader = message::Id::Invalid;
     std::string m_loadedWorkflowFile;
     std::string m_sessionUrl;
+    std::map<int, std::map<int, ShmUsage>> m_shmUsage;
+    std::deque<TraceSpan> m_traceSpans;
 };
 
 } // namespace vistle
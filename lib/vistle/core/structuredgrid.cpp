@@ -309,6 +309,11 @@ Index StructuredGrid::findCell(const Vector3 &point, Index hint, int flags) cons
     return InvalidIndex;
 }
 
+void StructuredGrid::findCells(Index numPoints, const Vector3 *points, Index *cells, int flags) const
+{
+    vistle::findCells(this, numPoints, points, cells, flags);
+}
+
 // INSIDE CHECK
 //-------------------------------------------------------------------------
 bool StructuredGrid::inside(Index elem, const Vector3 &point) const
@@ -49,6 +49,7 @@ public:
     void setNormals(Normals::const_ptr normals) override;
     std::pair<Vector3, Vector3> cellBounds(Index elem) const override;
     Index findCell(const Vector3 &point, Index hint = InvalidIndex, int flags = NoFlags) const override;
+    void findCells(Index numPoints, const Vector3 *points, Index *cells, int flags = NoFlags) const override;
     bool inside(Index elem, const Vector3 &point) const override;
     Interpolator getInterpolator(Index elem, const Vector3 &point, DataBase::Mapping mapping = DataBase::Vertex,
                                  InterpolationMode mode = Linear) const override;
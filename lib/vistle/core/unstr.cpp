@@ -107,6 +107,11 @@ Index UnstructuredGrid::findCell(const Vector3 &point, Index hint, int flags) co
     return InvalidIndex;
 }
 
+void UnstructuredGrid::findCells(Index numPoints, const Vector3 *points, Index *cells, int flags) const
+{
+    vistle::findCells(this, numPoints, points, cells, flags);
+}
+
 namespace {
 
 
@@ -135,6 +140,291 @@ Vector2 bilinearInverse(const Vector3 &p0, const Vector3 p[4])
     return ss;
 }
 
+// interpolation weights for linear interpolation within simple cell types:
+// the kernels process N points within cells of the same type at once,
+// with coordinates as structure of arrays, so that each point occupies a SIMD lane
+
+const int InterpolationLanes = 8;
+
+template<int N>
+void trilinearInverse(const Scalar (&c)[8][3][N], const Scalar (&p)[3][N], Scalar (&ss)[3][N])
+{
+    // lane-wise version of trilinearInverse from cellalgorithm.cpp,
+    // converged lanes are not updated anymore instead of terminating the iteration
+    const int iter = 5;
+    const double tol = 1e-10;
+    const double tol2 = tol * tol;
+
+#pragma omp simd
+    for (int l = 0; l < N; ++l) {
+        double s = 0.5, t = 0.5, w = 0.5;
+        bool done = false;
+        for (int k = 0; k < iter; ++k) {
+            const double f[8] = {(1 - s) * (1 - t) * (1 - w), s * (1 - t) * (1 - w), s * t * (1 - w),
+                                 (1 - s) * t * (1 - w),       (1 - s) * (1 - t) * w, s * (1 - t) * w,
+                                 s * t * w,                   (1 - s) * t * w};
+            const double fs[8] = {-(1 - t) * (1 - w), (1 - t) * (1 - w), t * (1 - w), -t * (1 - w),
+                                  -(1 - t) * w,       (1 - t) * w,       t * w,       -t * w};
+            const double ft[8] = {-(1 - s) * (1 - w), -s * (1 - w), s * (1 - w), (1 - s) * (1 - w),
+                                  -(1 - s) * w,       -s * w,       s * w,       (1 - s) * w};
+            const double fw[8] = {-(1 - s) * (1 - t), -s * (1 - t), -s * t, -(1 - s) * t,
+                                  (1 - s) * (1 - t),  s * (1 - t),  s * t,  (1 - s) * t};
+            double res[3], Js[3], Jt[3], Jw[3];
+            for (int d = 0; d < 3; ++d) {
+                res[d] = -p[d][l];
+                Js[d] = Jt[d] = Jw[d] = 0;
+                for (int v = 0; v < 8; ++v) {
+                    res[d] += c[v][d][l] * f[v];
+                    Js[d] += c[v][d][l] * fs[v];
+                    Jt[d] += c[v][d][l] * ft[v];
+                    Jw[d] += c[v][d][l] * fw[v];
+                }
+            }
+            done = done || res[0] * res[0] + res[1] * res[1] + res[2] * res[2] < tol2;
+
+            // solve J * delta = res by Cramer's rule
+            const double tw[3] = {Jt[1] * Jw[2] - Jt[2] * Jw[1], Jt[2] * Jw[0] - Jt[0] * Jw[2],
+                                  Jt[0] * Jw[1] - Jt[1] * Jw[0]};
+            const double rw[3] = {res[1] * Jw[2] - res[2] * Jw[1], res[2] * Jw[0] - res[0] * Jw[2],
+                                  res[0] * Jw[1] - res[1] * Jw[0]};
+            const double tr[3] = {Jt[1] * res[2] - Jt[2] * res[1], Jt[2] * res[0] - Jt[0] * res[2],
+                                  Jt[0] * res[1] - Jt[1] * res[0]};
+            const double det = Js[0] * tw[0] + Js[1] * tw[1] + Js[2] * tw[2];
+            const bool update = !done && std::abs(det) > 1e-30;
+            const double idet = update ? 1 / det : 0;
+            const double ds = (res[0] * tw[0] + res[1] * tw[1] + res[2] * tw[2]) * idet;
+            const double dt = (Js[0] * rw[0] + Js[1] * rw[1] + Js[2] * rw[2]) * idet;
+            const double dw = (Js[0] * tr[0] + Js[1] * tr[1] + Js[2] * tr[2]) * idet;
+            s = std::min(std::max(s - ds, 0.), 1.);
+            t = std::min(std::max(t - dt, 0.), 1.);
+            w = std::min(std::max(w - dw, 0.), 1.);
+        }
+        ss[0][l] = s;
+        ss[1][l] = t;
+        ss[2][l] = w;
+    }
+}
+
+template<int N>
+void bilinearInverse(const Scalar (&c)[4][3][N], const Scalar (&p)[3][N], Scalar (&ss)[2][N])
+{
+    // lane-wise version of bilinearInverse
+    const int iter = 5;
+    const Scalar tol = 1e-6f;
+    const Scalar tol2 = tol * tol;
+
+#pragma omp simd
+    for (int l = 0; l < N; ++l) {
+        Scalar s = 0.5, t = 0.5;
+        bool done = false;
+        for (int k = 0; k < iter; ++k) {
+            Scalar res[3], Js[3], Jt[3];
+            for (int d = 0; d < 3; ++d) {
+                res[d] = c[0][d][l] * (1 - s) * (1 - t) + c[1][d][l] * s * (1 - t) + c[2][d][l] * s * t +
+                         c[3][d][l] * (1 - s) * t - p[d][l];
+                Js[d] = -c[0][d][l] * (1 - t) + c[1][d][l] * (1 - t) + c[2][d][l] * t - c[3][d][l] * t;
+                Jt[d] = -c[0][d][l] * (1 - s) - c[1][d][l] * s + c[2][d][l] * s + c[3][d][l] * (1 - s);
+            }
+            done = done || res[0] * res[0] + res[1] * res[1] + res[2] * res[2] < tol2;
+
+            // solve normal equations J^T J * delta = J^T res
+            const Scalar a11 = Js[0] * Js[0] + Js[1] * Js[1] + Js[2] * Js[2];
+            const Scalar a12 = Js[0] * Jt[0] + Js[1] * Jt[1] + Js[2] * Jt[2];
+            const Scalar a22 = Jt[0] * Jt[0] + Jt[1] * Jt[1] + Jt[2] * Jt[2];
+            const Scalar b1 = Js[0] * res[0] + Js[1] * res[1] + Js[2] * res[2];
+            const Scalar b2 = Jt[0] * res[0] + Jt[1] * res[1] + Jt[2] * res[2];
+            const Scalar det = a11 * a22 - a12 * a12;
+            const bool update = !done && det > 0;
+            const Scalar idet = update ? 1 / det : 0;
+            s -= (a22 * b1 - a12 * b2) * idet;
+            t -= (a11 * b2 - a12 * b1) * idet;
+        }
+        ss[0][l] = s;
+        ss[1][l] = t;
+    }
+}
+
+struct TetrahedronWeights {
+    static const int NumVert = 4;
+
+    template<int N>
+    static void compute(const Scalar (&c)[NumVert][3][N], const Scalar (&p)[3][N], Scalar (&w)[NumVert][N])
+    {
+        // barycentric coordinates with respect to last vertex by Cramer's rule
+#pragma omp simd
+        for (int l = 0; l < N; ++l) {
+            Scalar a[3], b[3], e[3], r[3];
+            for (int d = 0; d < 3; ++d) {
+                a[d] = c[0][d][l] - c[3][d][l];
+                b[d] = c[1][d][l] - c[3][d][l];
+                e[d] = c[2][d][l] - c[3][d][l];
+                r[d] = p[d][l] - c[3][d][l];
+            }
+            const Scalar be[3] = {b[1] * e[2] - b[2] * e[1], b[2] * e[0] - b[0] * e[2], b[0] * e[1] - b[1] * e[0]};
+            const Scalar re[3] = {r[1] * e[2] - r[2] * e[1], r[2] * e[0] - r[0] * e[2], r[0] * e[1] - r[1] * e[0]};
+            const Scalar br[3] = {b[1] * r[2] - b[2] * r[1], b[2] * r[0] - b[0] * r[2], b[0] * r[1] - b[1] * r[0]};
+            const Scalar idet = 1 / (a[0] * be[0] + a[1] * be[1] + a[2] * be[2]);
+            w[0][l] = (r[0] * be[0] + r[1] * be[1] + r[2] * be[2]) * idet;
+            w[1][l] = (a[0] * re[0] + a[1] * re[1] + a[2] * re[2]) * idet;
+            w[2][l] = (a[0] * br[0] + a[1] * br[1] + a[2] * br[2]) * idet;
+            w[3][l] = 1 - w[0][l] - w[1][l] - w[2][l];
+        }
+    }
+};
+
+struct PyramidWeights {
+    static const int NumVert = 5;
+
+    template<int N>
+    static void compute(const Scalar (&c)[NumVert][3][N], const Scalar (&p)[3][N], Scalar (&w)[NumVert][N])
+    {
+        // height above base determines weight of apex, base is interpolated bilinearly
+        Scalar base[4][3][N], q[3][N], ss[2][N];
+#pragma omp simd
+        for (int l = 0; l < N; ++l) {
+            Scalar first[3], normal[3] = {0, 0, 0};
+            for (int d = 0; d < 3; ++d)
+                first[d] = c[1][d][l] - c[0][d][l];
+            for (int i = 2; i < 4; ++i) {
+                Scalar e[3];
+                for (int d = 0; d < 3; ++d)
+                    e[d] = c[i][d][l] - c[i - 1][d][l];
+                normal[0] += first[1] * e[2] - first[2] * e[1];
+                normal[1] += first[2] * e[0] - first[0] * e[2];
+                normal[2] += first[0] * e[1] - first[1] * e[0];
+            }
+            Scalar h = 0, hp = 0;
+            for (int d = 0; d < 3; ++d) {
+                h += normal[d] * (c[4][d][l] - c[0][d][l]);
+                hp += normal[d] * (p[d][l] - c[0][d][l]);
+            }
+            w[4][l] = hp / h;
+            const Scalar scale = 1 - w[4][l];
+            for (int d = 0; d < 3; ++d) {
+                q[d][l] = (p[d][l] - w[4][l] * c[4][d][l]) / scale;
+                for (int i = 0; i < 4; ++i)
+                    base[i][d][l] = c[i][d][l];
+            }
+        }
+        bilinearInverse<N>(base, q, ss);
+#pragma omp simd
+        for (int l = 0; l < N; ++l) {
+            const Scalar scale = 1 - w[4][l];
+            w[0][l] = (1 - ss[0][l]) * (1 - ss[1][l]) * scale;
+            w[1][l] = ss[0][l] * (1 - ss[1][l]) * scale;
+            w[2][l] = ss[0][l] * ss[1][l] * scale;
+            w[3][l] = (1 - ss[0][l]) * ss[1][l] * scale;
+        }
+    }
+};
+
+struct PrismWeights {
+    static const int NumVert = 6;
+
+    template<int N>
+    static void compute(const Scalar (&c)[NumVert][3][N], const Scalar (&p)[3][N], Scalar (&w)[NumVert][N])
+    {
+        // we interpolate in a hexahedron with coinciding corners
+        Scalar hex[8][3][N], ss[3][N];
+        for (int d = 0; d < 3; ++d) {
+#pragma omp simd
+            for (int l = 0; l < N; ++l) {
+                for (int i = 0; i < 3; ++i) {
+                    hex[i][d][l] = c[i][d][l];
+                    hex[i + 4][d][l] = c[i + 3][d][l];
+                }
+                hex[3][d][l] = c[2][d][l];
+                hex[7][d][l] = c[5][d][l];
+            }
+        }
+        trilinearInverse<N>(hex, p, ss);
+#pragma omp simd
+        for (int l = 0; l < N; ++l) {
+            const Scalar s = ss[0][l], t = ss[1][l], u = ss[2][l];
+            w[0][l] = (1 - s) * (1 - t) * (1 - u);
+            w[1][l] = s * (1 - t) * (1 - u);
+            w[2][l] = t * (1 - u);
+            w[3][l] = (1 - s) * (1 - t) * u;
+            w[4][l] = s * (1 - t) * u;
+            w[5][l] = t * u;
+        }
+    }
+};
+
+struct HexahedronWeights {
+    static const int NumVert = 8;
+
+    template<int N>
+    static void compute(const Scalar (&c)[NumVert][3][N], const Scalar (&p)[3][N], Scalar (&w)[NumVert][N])
+    {
+        Scalar ss[3][N];
+        trilinearInverse<N>(c, p, ss);
+#pragma omp simd
+        for (int l = 0; l < N; ++l) {
+            const Scalar s = ss[0][l], t = ss[1][l], u = ss[2][l];
+            w[0][l] = (1 - s) * (1 - t) * (1 - u);
+            w[1][l] = s * (1 - t) * (1 - u);
+            w[2][l] = s * t * (1 - u);
+            w[3][l] = (1 - s) * t * (1 - u);
+            w[4][l] = (1 - s) * (1 - t) * u;
+            w[5][l] = s * (1 - t) * u;
+            w[6][l] = s * t * u;
+            w[7][l] = (1 - s) * t * u;
+        }
+    }
+};
+
+// weights for a single point
+template<class Kernel>
+void cellWeights(const Index *cl, const Scalar *const x[3], const Vector3 &point, Index *indices, Scalar *weights)
+{
+    Scalar c[Kernel::NumVert][3][1], p[3][1], w[Kernel::NumVert][1];
+    for (int i = 0; i < Kernel::NumVert; ++i) {
+        indices[i] = cl[i];
+        for (int d = 0; d < 3; ++d)
+            c[i][d][0] = x[d][cl[i]];
+    }
+    for (int d = 0; d < 3; ++d)
+        p[d][0] = point[d];
+    Kernel::template compute<1>(c, p, w);
+    for (int i = 0; i < Kernel::NumVert; ++i)
+        weights[i] = w[i][0];
+}
+
+// weights for all points, that have been assigned to cells of the same type, in packets of InterpolationLanes points
+template<class Kernel>
+void cellWeights(const std::vector<Index> &points, const Index *cells, const Vector3 *coords, const Index *el,
+                 const Index *cl, const Scalar *const x[3], GridInterface::Interpolators &result)
+{
+    const int N = InterpolationLanes;
+    Scalar c[Kernel::NumVert][3][N], p[3][N], w[Kernel::NumVert][N];
+    for (size_t start = 0; start < points.size(); start += N) {
+        const int n = std::min(size_t(N), points.size() - start);
+        for (int l = 0; l < N; ++l) {
+            // fill up incomplete packets with last point
+            const Index pt = points[start + std::min(l, n - 1)];
+            const Index *verts = &cl[el[cells[pt]]];
+            for (int i = 0; i < Kernel::NumVert; ++i) {
+                for (int d = 0; d < 3; ++d)
+                    c[i][d][l] = x[d][verts[i]];
+            }
+            for (int d = 0; d < 3; ++d)
+                p[d][l] = coords[pt][d];
+        }
+        Kernel::template compute<N>(c, p, w);
+        for (int l = 0; l < n; ++l) {
+            const Index pt = points[start + l];
+            const Index *verts = &cl[el[cells[pt]]];
+            Index *indices = result.indicesOf(pt);
+            Scalar *weights = result.weightsOf(pt);
+            for (int i = 0; i < Kernel::NumVert; ++i) {
+                indices[i] = verts[i];
+                weights[i] = w[i][l];
+            }
+        }
+    }
+}
+
 } // namespace
 
 Scalar UnstructuredGrid::cellDiameter(Index elem) const
@@ -363,96 +653,22 @@ GridInterface::Interpolator UnstructuredGrid::getInterpolator(Index elem, const
         switch (tl[elem]) {
         case TETRAHEDRON: {
             assert(nvert == 4);
-            Vector3 coord[4];
-            for (int i = 0; i < 4; ++i) {
-                const Index ind = cl[i];
-                indices[i] = ind;
-                for (int c = 0; c < 3; ++c) {
-                    coord[i][c] = x[c][ind];
-                }
-            }
-            Matrix3 T;
-            T << coord[0] - coord[3], coord[1] - coord[3], coord[2] - coord[3];
-            Vector3 w = T.inverse() * (point - coord[3]);
-            weights[3] = 1.;
-            for (int c = 0; c < 3; ++c) {
-                weights[c] = w[c];
-                weights[3] -= w[c];
-            }
+            cellWeights<TetrahedronWeights>(cl, x, point, indices.data(), weights.data());
             break;
         }
         case PYRAMID: {
             assert(nvert == 5);
-            Vector3 coord[5];
-            for (int i = 0; i < 5; ++i) {
-                const Index ind = cl[i];
-                indices[i] = ind;
-                for (int c = 0; c < 3; ++c) {
-                    coord[i][c] = x[c][ind];
-                }
-            }
-            const Vector3 first(coord[1] - coord[0]);
-            Vector3 normal(0, 0, 0);
-            for (int i = 2; i < 4; ++i) {
-                normal += cross(first, coord[i] - coord[i - 1]);
-            }
-            const Vector3 top = coord[4] - coord[0];
-            const Scalar h = normal.dot(top);
-            const Scalar hp = normal.dot(point - coord[0]);
-            weights[4] = hp / h;
-            const Scalar w = 1 - weights[4];
-            const Vector3 p = (point - weights[4] * coord[4]) / w;
-            const Vector2 ss = bilinearInverse(p, coord);
-            weights[0] = (1 - ss[0]) * (1 - ss[1]) * w;
-            weights[1] = ss[0] * (1 - ss[1]) * w;
-            weights[2] = ss[0] * ss[1] * w;
-            weights[3] = (1 - ss[0]) * ss[1] * w;
+            cellWeights<PyramidWeights>(cl, x, point, indices.data(), weights.data());
             break;
         }
         case PRISM: {
             assert(nvert == 6);
-            Vector3 coord[8];
-            for (int i = 0; i < 3; ++i) {
-                const Index ind1 = cl[i];
-                const Index ind2 = cl[i + 3];
-                indices[i] = ind1;
-                indices[i + 3] = ind2;
-                for (int c = 0; c < 3; ++c) {
-                    coord[i][c] = x[c][ind1];
-                    coord[i + 4][c] = x[c][ind2];
-                }
-            }
-            // we interpolate in a hexahedron with coinciding corners
-            coord[3] = coord[2];
-            coord[7] = coord[6];
-            const Vector3 ss = trilinearInverse(point, coord);
-            weights[0] = (1 - ss[0]) * (1 - ss[1]) * (1 - ss[2]);
-            weights[1] = ss[0] * (1 - ss[1]) * (1 - ss[2]);
-            weights[2] = ss[1] * (1 - ss[2]);
-            weights[3] = (1 - ss[0]) * (1 - ss[1]) * ss[2];
-            weights[4] = ss[0] * (1 - ss[1]) * ss[2];
-            weights[5] = ss[1] * ss[2];
+            cellWeights<PrismWeights>(cl, x, point, indices.data(), weights.data());
             break;
         }
         case HEXAHEDRON: {
             assert(nvert == 8);
-            Vector3 coord[8];
-            for (int i = 0; i < 8; ++i) {
-                const Index ind = cl[i];
-                indices[i] = ind;
-                for (int c = 0; c < 3; ++c) {
-                    coord[i][c] = x[c][ind];
-                }
-            }
-            const Vector3 ss = trilinearInverse(point, coord);
-            weights[0] = (1 - ss[0]) * (1 - ss[1]) * (1 - ss[2]);
-            weights[1] = ss[0] * (1 - ss[1]) * (1 - ss[2]);
-            weights[2] = ss[0] * ss[1] * (1 - ss[2]);
-            weights[3] = (1 - ss[0]) * ss[1] * (1 - ss[2]);
-            weights[4] = (1 - ss[0]) * (1 - ss[1]) * ss[2];
-            weights[5] = ss[0] * (1 - ss[1]) * ss[2];
-            weights[6] = ss[0] * ss[1] * ss[2];
-            weights[7] = (1 - ss[0]) * ss[1] * ss[2];
+            cellWeights<HexahedronWeights>(cl, x, point, indices.data(), weights.data());
             break;
         }
         case POLYHEDRON: {
@@ -657,6 +873,56 @@ GridInterface::Interpolator UnstructuredGrid::getInterpolator(Index elem, const
     return Interpolator(weights, indices);
 }
 
+GridInterface::Interpolators UnstructuredGrid::getInterpolators(Index numPoints, const Index *cells,
+                                                                const Vector3 *points, Mapping mapping,
+                                                                InterpolationMode mode) const
+{
+    if (mapping != Vertex || mode != Linear)
+        return GridInterface::getInterpolators(numPoints, cells, points, mapping, mode);
+
+    const auto el = &this->el()[0];
+    const auto tl = &this->tl()[0];
+    const auto cl = &this->cl()[0];
+    const Scalar *x[3] = {&this->x()[0], &this->y()[0], &this->z()[0]};
+
+    // reserve storage for each point and sort points of simple cells by cell type,
+    // so that they can be processed in packets
+    Interpolators result;
+    result.reserve(numPoints, 0);
+    std::vector<Index> tets, pyramids, prisms, hexes;
+    for (Index i = 0; i < numPoints; ++i) {
+        const Index elem = cells[i];
+        if (elem == InvalidIndex) {
+            result.add(0);
+            continue;
+        }
+        switch (tl[elem]) {
+        case TETRAHEDRON:
+            tets.push_back(result.add(4));
+            break;
+        case PYRAMID:
+            pyramids.push_back(result.add(5));
+            break;
+        case PRISM:
+            prisms.push_back(result.add(6));
+            break;
+        case HEXAHEDRON:
+            hexes.push_back(result.add(8));
+            break;
+        default:
+            result.add(getInterpolator(elem, points[i], mapping, mode));
+            break;
+        }
+    }
+
+    cellWeights<TetrahedronWeights>(tets, cells, points, el, cl, x, result);
+    cellWeights<PyramidWeights>(pyramids, cells, points, el, cl, x, result);
+    cellWeights<PrismWeights>(prisms, cells, points, el, cl, x, result);
+    cellWeights<HexahedronWeights>(hexes, cells, points, el, cl, x, result);
+
+    return result;
+}
+
 std::pair<Vector3, Vector3> UnstructuredGrid::elementBounds(Index elem) const
 {
     const auto t = tl()[elem];
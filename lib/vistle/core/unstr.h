@@ -183,11 +183,14 @@ public:
     bool isGhostCell(Index elem) const override;
     std::pair<Vector3, Vector3> cellBounds(Index elem) const override;
     Index findCell(const Vector3 &point, Index hint = InvalidIndex, int flags = NoFlags) const override;
+    void findCells(Index numPoints, const Vector3 *points, Index *cells, int flags = NoFlags) const override;
     bool inside(Index elem, const Vector3 &point) const override;
     Scalar exitDistance(Index elem, const Vector3 &point, const Vector3 &dir) const override;
 
     Interpolator getInterpolator(Index elem, const Vector3 &point, Mapping mapping = Vertex,
                                  InterpolationMode mode = Linear) const override;
+    Interpolators getInterpolators(Index numPoints, const Index *cells, const Vector3 *points, Mapping mapping = Vertex,
+                                   InterpolationMode mode = Linear) const override;
     std::pair<Vector3, Vector3> elementBounds(Index elem) const override;
     std::vector<Index> cellVertices(Index elem) const override;
     Scalar cellDiameter(Index elem) const override;
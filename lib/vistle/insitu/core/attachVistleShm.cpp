@@ -1,4 +1,5 @@
 #include "attachVistleShm.h"
+#include "shmBuffer.h"
 #include <vistle/core/shm.h>
 #include <vistle/util/shmconfig.h>
 #include <iostream>
@@ -16,6 +17,7 @@ void vistle::insitu::attachShm(const std::string &shmName, int id, int rank)
 
 void vistle::insitu::detachShm()
 {
+    releaseAllShmBuffers();
 #ifndef MODULE_THREAD
     if (vistle::Shm::isAttached()) {
         vistle::Shm::the().detach();
@@ -0,0 +1,55 @@
+#include "shmBuffer.h"
+
+#include <map>
+#include <mutex>
+
+namespace vistle {
+namespace insitu {
+
+namespace {
+std::mutex s_mutex;
+std::map<const void *, detail::ShmBuffer> s_buffers;
+} // namespace
+
+void detail::registerShmBuffer(const void *data, const ShmBuffer &buffer)
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    s_buffers[data] = buffer;
+}
+
+bool detail::findShmBuffer(const void *data, ShmBuffer &buffer)
+{
+    if (!data)
+        return false;
+    std::lock_guard<std::mutex> guard(s_mutex);
+    auto it = s_buffers.find(data);
+    if (it == s_buffers.end())
+        return false;
+    buffer = it->second;
+    return true;
+}
+
+bool releaseShmBuffer(const void *data)
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    return s_buffers.erase(data) > 0;
+}
+
+void releaseAllShmBuffers()
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    s_buffers.clear();
+}
+
+bool shmBufferInUse(const void *data)
+{
+    std::lock_guard<std::mutex> guard(s_mutex);
+    auto it = s_buffers.find(data);
+    if (it == s_buffers.end())
+        return false;
+    // one reference is held by the registry
+    return it->second.refcount() > 1;
+}
+
+} // namespace insitu
+} // namespace vistle
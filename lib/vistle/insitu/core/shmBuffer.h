@@ -0,0 +1,70 @@
+#ifndef VISTLE_INSITU_CORE_SHM_BUFFER_H
+#define VISTLE_INSITU_CORE_SHM_BUFFER_H
+
+#include "export.h"
+#include "dataType.h"
+
+#include <vistle/core/shm.h>
+#include <vistle/core/shmvector.h>
+
+#include <functional>
+#include <memory>
+
+// buffers in vistle's shared memory that a simulation allocates and fills directly:
+// arrays pointing to such a buffer are adopted into vistle objects instead of being copied
+
+namespace vistle {
+namespace insitu {
+namespace detail {
+struct ShmBuffer {
+    DataType type = DataType::INVALID;
+    size_t size = 0;
+    std::shared_ptr<void> array; // the ShmVector<T> owning the buffer
+    std::function<int()> refcount;
+};
+V_INSITUCOREEXPORT void registerShmBuffer(const void *data, const ShmBuffer &buffer);
+V_INSITUCOREEXPORT bool findShmBuffer(const void *data, ShmBuffer &buffer);
+} // namespace detail
+
+//! allocate size elements of T in vistle's shared memory, returns nullptr if not attached to shm
+/*! the buffer stays valid until it is released or the connection to vistle is closed */
+template<typename T>
+T *allocateShmBuffer(size_t size)
+{
+    static_assert(getDataType<T>() != DataType::INVALID, "allocateShmBuffer: unsupported data type");
+    if (!Shm::isAttached())
+        return nullptr;
+    auto vec = std::make_shared<ShmVector<T>>(ShmVector<T>::create(size));
+    detail::ShmBuffer buffer;
+    buffer.type = getDataType<T>();
+    buffer.size = size;
+    buffer.refcount = [p = vec.get()]() {
+        return (*p)->refcount();
+    };
+    buffer.array = vec;
+    T *data = (*vec)->data();
+    detail::registerShmBuffer(data, buffer);
+    return data;
+}
+
+//! shm array backing data, if it has been allocated by allocateShmBuffer with exactly size elements of T
+template<typename T>
+ShmVector<T> adoptShmBuffer(const void *data, size_t size)
+{
+    detail::ShmBuffer buffer;
+    if (!detail::findShmBuffer(data, buffer) || buffer.type != getDataType<T>() || buffer.size != size)
+        return ShmVector<T>();
+    return *std::static_pointer_cast<ShmVector<T>>(buffer.array);
+}
+
+//! drop the simulation's reference to a buffer, memory is reclaimed once no vistle object references it anymore
+V_INSITUCOREEXPORT bool releaseShmBuffer(const void *data);
+//! drop all buffers, has to happen before shm is detached
+V_INSITUCOREEXPORT void releaseAllShmBuffers();
+//! whether vistle objects still reference data, the simulation should not modify it until they have been released
+V_INSITUCOREEXPORT bool shmBufferInUse(const void *data);
+
+} // namespace insitu
+} // namespace vistle
+
+#endif // VISTLE_INSITU_CORE_SHM_BUFFER_H
@@ -12,6 +12,7 @@
 #include <array>
 #include <cassert>
 #include <type_traits>
+#include <vector>
 
 namespace vistle {
 namespace insitu {
@@ -184,22 +185,33 @@ inline vistle::DataBase::ptr vtkData2Vistle(const void *source, size_t n, DataTy
         source, dataType, n, grid, m, interleaved);
 }
 
+namespace detail {
+// convert the axes once instead of dispatching on dataType for every vertex
+template<typename T>
+std::array<std::vector<T>, 3> convertRectilinearAxes(void *source[3], DataType dataType, const int size[3])
+{
+    std::array<std::vector<T>, 3> axes;
+    for (int c = 0; c < 3; ++c) {
+        axes[c].resize(size[c]);
+        callFunctionWithVoidToTypeCast<void, ArrayTransformer>(source[c], dataType, size[c], axes[c].data());
+    }
+    return axes;
+}
+} // namespace detail
+
 template<typename T>
 void expandRectilinearToStructured(void *source[3], DataType dataType, const int size[3], std::array<T *, 3> dest)
 {
     using namespace vistle;
     const Index dim[3] = {(Index)size[0], (Index)size[1], (Index)size[2]};
+    const auto axes = detail::convertRectilinearAxes<T>(source, dataType, size);
     for (Index i = 0; i < dim[0]; i++) {
         for (Index j = 0; j < dim[1]; j++) {
             for (Index k = 0; k < dim[2]; k++) {
                 const Index insertionIndex = UniformGrid::vertexIndex(i, j, k, dim);
-
-                detail::callFunctionWithVoidToTypeCast<void, detail::ConversionInserter>(source[0], dataType, i,
-                                                                                         dest[0], insertionIndex);
-                detail::callFunctionWithVoidToTypeCast<void, detail::ConversionInserter>(source[1], dataType, j,
-                                                                                         dest[1], insertionIndex);
-                detail::callFunctionWithVoidToTypeCast<void, detail::ConversionInserter>(source[2], dataType, k,
-                                                                                         dest[2], insertionIndex);
+                dest[0][insertionIndex] = axes[0][i];
+                dest[1][insertionIndex] = axes[1][j];
+                dest[2][insertionIndex] = axes[2][k];
             }
         }
     }
@@ -215,17 +227,14 @@ void expandRectilinearToVTKStructured(void *source[3], DataType dataType, const
 {
     using namespace vistle;
     const Index dim[3] = {(Index)size[0], (Index)size[1], (Index)size[2]};
+    const auto axes = detail::convertRectilinearAxes<T>(source, dataType, size);
     for (Index k = 0; k < dim[2]; ++k) {
         for (Index j = 0; j < dim[1]; ++j) {
             for (Index i = 0; i < dim[0]; ++i) {
                 const Index insertionIndex = VTKVertexIndex(i, j, k, dim);
-
-                detail::callFunctionWithVoidToTypeCast<void, detail::ConversionInserter>(source[0], dataType, i,
-                                                                                         dest[0], insertionIndex);
-                detail::callFunctionWithVoidToTypeCast<void, detail::ConversionInserter>(source[1], dataType, j,
-                                                                                         dest[1], insertionIndex);
-                detail::callFunctionWithVoidToTypeCast<void, detail::ConversionInserter>(source[2], dataType, k,
-                                                                                         dest[2], insertionIndex);
+                dest[0][insertionIndex] = axes[0][i];
+                dest[1][insertionIndex] = axes[1][j];
+                dest[2][insertionIndex] = axes[2][k];
             }
         }
     }
@@ -5,6 +5,7 @@
 #include "SmartHandle.h"
 #include "VisitDataTypesToVistle.h"
 
+#include <vistle/insitu/core/shmBuffer.h>
 #include <vistle/insitu/core/transformArray.h>
 #include <vistle/insitu/core/callFunctionWithVoidToTypeCast.h>
 #include <vistle/insitu/libsim/libsimInterface/VariableData.h>
@@ -90,6 +91,16 @@ void transformArray(const Array<HT> &source, T *dest)
         source.data, dataTypeToVistle(source.type), source.size, dest);
 }
 
+// shm array backing source if the simulation allocated it with simv2_vistle_alloc_shm_buffer and keeps ownership,
+// invalid otherwise
+template<typename T, HandleType HT>
+ShmVector<T> adoptArray(const Array<HT> &source)
+{
+    if (source.owner != VISIT_OWNER_SIM || source.dim != 1 || !source.template check<T>())
+        return ShmVector<T>();
+    return adoptShmBuffer<T>(source.data, source.size);
+}
+
 } // namespace libsim
 } // namespace insitu
 } // namespace vistle
@@ -142,6 +142,11 @@ void DataTransmitter::makeCombinedMesh(MeshInfo &meshInfo)
     switch (meshInfo.type) {
     case VISIT_MESHTYPE_AMR:
     case VISIT_MESHTYPE_RECTILINEAR: {
+        if (meshInfo.domains.size == 1) {
+            // nothing to combine, keep the rectilinear grid instead of expanding it to an unstructured one
+            makeSeparateMeshes(meshInfo);
+            return;
+        }
         mesh = RectilinearMesh::getCombinedUnstructured(meshInfo, m_rules.vtkFormat);
         break;
     case VISIT_MESHTYPE_CURVILINEAR: {
@@ -282,8 +287,15 @@ vistle::Object::ptr DataTransmitter::makeVariable(const VariableInfo &varInfo, i
                                   varInfo.meshInfo.grids[iteration], varInfo.mapping);
         return var;
     } else {
-        auto var = make_ptr<vistle::Vec<vistle::Scalar, 1>>((Index)varArray.size);
-        transformArray(varArray, var->x().data());
+        vistle::Vec<vistle::Scalar, 1>::ptr var;
+        if (auto adopted = adoptArray<vistle::Scalar>(varArray)) {
+            var = make_ptr<vistle::Vec<vistle::Scalar, 1>>(Index(0));
+            var->d()->x[0] = adopted;
+            var->refresh();
+        } else {
+            var = make_ptr<vistle::Vec<vistle::Scalar, 1>>((Index)varArray.size);
+            transformArray(varArray, var->x().data());
+        }
         var->setMapping(varInfo.mapping);
         var->setGrid(varInfo.meshInfo.grids[iteration]);
         return var;
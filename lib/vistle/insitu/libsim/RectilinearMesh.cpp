@@ -53,7 +53,7 @@ Object::ptr getCombinedUnstructured(const MeshInfo &meshInfo, bool vtkFormat)
         int dims[3]{1, 1, 1};
         void *data[3];
         for (size_t i = 0; i < 3; i++) {
-            dims[i] = meshArrays[i].dim;
+            dims[i] = meshArrays[i].size;
             data[i] = meshArrays[i].data;
         }
         size_t numVertices = getNumVertices(dims);
@@ -95,12 +95,15 @@ RectilinearGrid::ptr makeVistleMesh(const std::array<Array<HandleType::Coords>,
                                           std::max(Index(1), Index(meshData[2].size)));
 
     for (size_t i = 0; i < 3; ++i) {
-        if (meshData[i].data) {
+        if (auto adopted = adoptArray<Scalar>(meshData[i])) {
+            mesh->d()->coords[i] = adopted;
+        } else if (meshData[i].data) {
             transformArray(meshData[i], mesh->coords(i).begin());
         } else {
             mesh->coords(i)[0] = 0;
         }
     }
+    mesh->refresh();
     return mesh;
 }
 
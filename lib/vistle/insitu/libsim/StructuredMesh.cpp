@@ -44,8 +44,10 @@ vistle::Object::ptr get(const visit_smart_handle<HandleType::CurvilinearMesh> &m
             std::fill(mesh->z().begin(), mesh->z().end(), 0);
         }
 
-        std::array<vistle::Scalar *, 3> gridCoords{mesh->x().data(), mesh->y().data(), mesh->z().data()};
-        detail::fillMeshCoords(coordMode, coordHandles, mesh->getNumCoords(), gridCoords, ndims);
+        if (coordMode != VISIT_COORD_MODE_SEPARATE || !detail::adoptSeparateCoords(coordHandles, mesh, ndims)) {
+            std::array<vistle::Scalar *, 3> gridCoords{mesh->x().data(), mesh->y().data(), mesh->z().data()};
+            detail::fillMeshCoords(coordMode, coordHandles, mesh->getNumCoords(), gridCoords, ndims);
+        }
         detail::addGhost(meshHandle, mesh);
         return mesh;
     }
@@ -130,6 +132,21 @@ void separateFill(visit_handle coordHandles[4], int numCoords, std::array<vistle
     }
 }
 
+bool adoptSeparateCoords(visit_handle coordHandles[4], std::shared_ptr<vistle::StructuredGrid> mesh, int dim)
+{
+    std::array<ShmVector<vistle::Scalar>, 3> adopted;
+    for (int i = 0; i < dim; ++i) {
+        adopted[i] = adoptArray<vistle::Scalar>(getVariableData(coordHandles[i]));
+        if (!adopted[i] || adopted[i]->size() != mesh->getNumCoords())
+            return false;
+    }
+    for (int i = 0; i < dim; ++i) {
+        mesh->d()->x[i] = adopted[i];
+    }
+    mesh->refresh();
+    return true;
+}
+
 void interleavedFill(visit_handle coordHandle, int numCoords, const std::array<vistle::Scalar *, 3> &meshCoords,
                      int dim)
 {
@@ -28,6 +28,8 @@ void getMeshCoord(int currDomain, const char *name, int &ndims, int dims[3], int
 void fillMeshCoords(int coordMode, visit_handle coordHandles[4], size_t numVertices,
                     std::array<vistle::Scalar *, 3> &gridCoords, int dim);
 void separateFill(visit_handle coordHandles[4], int numCoords, std::array<vistle::Scalar *, 3> &meshCoords, int dim);
+// use coordinates in place if the simulation provided them in vistle shm
+bool adoptSeparateCoords(visit_handle coordHandles[4], std::shared_ptr<vistle::StructuredGrid> mesh, int dim);
 void interleavedFill(visit_handle coordHandle, int numCoords, const std::array<vistle::Scalar *, 3> &meshCoords,
                      int dim);
 void addGhost(const visit_handle &meshHandle, std::shared_ptr<vistle::StructuredGrid> mesh);
@@ -70,6 +70,13 @@ V_VISITXPORT int simv2_get_view2D(void *, visit_handle);
 V_VISITXPORT int simv2_set_view3D(void *, visit_handle);
 V_VISITXPORT int simv2_get_view3D(void *, visit_handle);
 
+// Vistle extension: buffers in Vistle's shared memory, which are used without copying when they are passed to
+// VisIt_VariableData_setData* with VISIT_OWNER_SIM. They are only available while Vistle is connected.
+// Simulations call them through the front-end in VisItVistleInterface_V2.h.
+V_VISITXPORT void *simv2_vistle_alloc_shm_buffer(int dataType, int nTuples);
+V_VISITXPORT int simv2_vistle_free_shm_buffer(void *);
+V_VISITXPORT int simv2_vistle_shm_buffer_in_use(void *);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,106 @@
+#ifndef VISIT_VISTLE_INTERFACE_V2_H
+#define VISIT_VISTLE_INTERFACE_V2_H
+
+// ****************************************************************************
+//  Purpose:
+//    Front-end for Vistle's extensions to the libsim runtime, to be included
+//    by simulations next to VisItControlInterface_V2.h.
+//    Like the other simv2 calls, these resolve the entry points of the
+//    runtime library loaded by libsim, so simulations do not have to link
+//    against Vistle. Without Vistle's runtime, they fail gracefully.
+//
+//  Usage:
+//    float *x = (float *)VisItVistleAllocShmBuffer(VISIT_DATATYPE_FLOAT, n);
+//    if (x) {
+//        // fill x, then pass it with VISIT_OWNER_SIM to VisIt_VariableData_setDataF,
+//        // Vistle references it without copying
+//    } else {
+//        // not connected to Vistle: use memory of your own
+//    }
+//    ...
+//    // Vistle objects may still reference x after the time step was processed
+//    if (!VisItVistleShmBufferInUse(x)) {
+//        // safe to modify x for next time step
+//    }
+//    ...
+//    VisItVistleFreeShmBuffer(x);
+// ****************************************************************************
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#include <stdio.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void *visit_vistle_runtime_function(const char *name)
+{
+    static const char *const runtimes[] = {"libsimV2runtime_par", "libsimV2runtime_ser"};
+    void *f = NULL;
+    int i = 0;
+#ifdef _WIN32
+    for (i = 0; !f && i < 2; ++i) {
+        HMODULE runtime = GetModuleHandleA(runtimes[i]);
+        if (runtime)
+            f = (void *)GetProcAddress(runtime, name);
+    }
+#else
+    void *global = dlopen(NULL, RTLD_LAZY);
+    if (global) {
+        f = dlsym(global, name);
+        dlclose(global);
+    }
+#ifdef RTLD_NOLOAD
+    for (i = 0; !f && i < 2; ++i) {
+        // runtime might have been loaded without RTLD_GLOBAL, never load it here
+        char lib[64];
+        void *runtime = NULL;
+#ifdef __APPLE__
+        snprintf(lib, sizeof(lib), "%s.dylib", runtimes[i]);
+#else
+        snprintf(lib, sizeof(lib), "%s.so", runtimes[i]);
+#endif
+        runtime = dlopen(lib, RTLD_LAZY | RTLD_NOLOAD);
+        if (runtime) {
+            f = dlsym(runtime, name);
+            dlclose(runtime);
+        }
+    }
+#endif
+#endif
+    return f;
+}
+
+//! allocate nTuples elements of dataType in Vistle's shared memory, NULL if not connected to Vistle
+static inline void *VisItVistleAllocShmBuffer(int dataType, int nTuples)
+{
+    typedef void *(*AllocFunc)(int, int);
+    AllocFunc f = (AllocFunc)visit_vistle_runtime_function("simv2_vistle_alloc_shm_buffer");
+    return f ? f(dataType, nTuples) : NULL;
+}
+
+//! release a buffer from VisItVistleAllocShmBuffer, returns VISIT_OKAY or VISIT_ERROR
+static inline int VisItVistleFreeShmBuffer(void *buffer)
+{
+    typedef int (*FreeFunc)(void *);
+    FreeFunc f = (FreeFunc)visit_vistle_runtime_function("simv2_vistle_free_shm_buffer");
+    return f ? f(buffer) : 0 /* VISIT_ERROR */;
+}
+
+//! whether Vistle objects still reference a buffer from VisItVistleAllocShmBuffer
+static inline int VisItVistleShmBufferInUse(void *buffer)
+{
+    typedef int (*InUseFunc)(void *);
+    InUseFunc f = (InUseFunc)visit_vistle_runtime_function("simv2_vistle_shm_buffer_in_use");
+    return f ? f(buffer) : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -22,6 +22,7 @@
 #include <vistle/core/messagerouter.h>
 #include <vistle/core/object.h>
 #include <vistle/core/parameter.h>
+#include <vistle/core/pipelinetrace.h>
 #include <vistle/core/shm.h>
 #include <vistle/util/directory.h>
 #include <vistle/util/enum.h>
@@ -246,8 +247,23 @@ ClusterManager::ClusterManager(boost::mpi::communicator comm, const std::vector<
 , m_rank(m_comm.rank())
 , m_size(hosts.size())
 , m_barrierActive(false)
+, m_placement(m_size)
 {
     m_portManager->setTracker(&m_stateTracker);
+    if (const char *interval = getenv("VISTLE_SHM_USAGE_INTERVAL")) {
+        m_shmUsageInterval = atof(interval);
+    }
+    if (const char *placement = getenv("VISTLE_REMOTE_PLACEMENT")) {
+        if (std::string(placement) == "modulo")
+            m_placement.setPolicy(RankPlacement::Modulo);
+        else if (std::string(placement) == "balanced")
+            m_placement.setPolicy(RankPlacement::Balanced);
+        else
+            CERR << "unknown VISTLE_REMOTE_PLACEMENT " << placement << ", expected modulo or balanced" << std::endl;
+    }
+    if (const char *rebalance = getenv("VISTLE_REMOTE_REBALANCE")) {
+        m_placement.setRebalanceThreshold(atof(rebalance));
+    }
 }
 
 ClusterManager::~ClusterManager()
@@ -496,6 +512,9 @@ bool ClusterManager::dispatch(bool &received)
             mod.second.update();
     }
 
+    publishShmUsage();
+    publishPipelineTrace();
+
     if (m_quitFlag) {
         if (numRunning() == 0)
             return false;
@@ -645,6 +664,9 @@ bool ClusterManager::handle(const message::Buffer &message, const MessagePayload
         handlePriv(trace);
         break;
     }
+    case message::TRACEDATA:
+        // only collected by hub
+        break;
     default:
         if (payload)
             m_stateTracker.handle(message, payload->data(), payload->size());
@@ -833,6 +855,18 @@ bool ClusterManager::handle(const message::Buffer &message, const MessagePayload
         break;
     }
 
+    case message::SHMINFO: {
+        const message::ShmInfo &m = message.as<ShmInfo>();
+        result = handlePriv(m, payload);
+        break;
+    }
+
+    case message::TRACEDATA: {
+        const message::TraceData &m = message.as<TraceData>();
+        result = handlePriv(m, payload);
+        break;
+    }
+
     case message::REQUESTTUNNEL: {
         const message::RequestTunnel &m = message.as<RequestTunnel>();
         result = handlePriv(m);
@@ -1085,6 +1119,11 @@ bool ClusterManager::handlePriv(const message::Spawn &spawn)
         sendMessage(newId, buf, -1, pl);
     }
 
+    // modules only learn about changes of trace_pipeline, so tell them whether tracing is already on
+    message::SetParameter trace(Id::Vistle, "trace_pipeline", Integer(PipelineTracer::enabled() ? 1 : 0));
+    trace.setSenderId(Id::Vistle);
+    sendMessage(newId, trace);
+
     return true;
 }
 
@@ -1175,6 +1214,9 @@ bool ClusterManager::handlePriv(const message::ModuleExit &moduleExit)
 
     //CERR << " Module [" << mod << "] quit" << std::endl;
 
+    if (m_rank == 0)
+        m_placement.removeSender(mod);
+
     if (moduleExit.isForwarded()) {
         sendAllOthers(mod, moduleExit, MessagePayload(), true);
 
@@ -1544,9 +1586,12 @@ bool ClusterManager::handlePriv(const message::AddObject &addObj)
         }
         //CERR << "ADDOBJECT: local, name=" << obj->getName() << ", refcount=" << obj->refcount() << std::endl;
     } else {
-        int block = addObj.meta().block();
-        if (block >= 0) {
-            destRank = block % getSize();
+        if (getRank() == 0) {
+            destRank = m_placement.place(addObj.senderId(), addObj.getSenderPort(), addObj.meta().block(),
+                                         addObj.meta().timeStep(), addObj.cost());
+        } else {
+            // already placed by rank 0
+            destRank = addObj.destRank();
         }
         onThisRank = destRank == getRank() || (getRank() == 0 && destRank == -1);
 
@@ -1556,7 +1601,9 @@ bool ClusterManager::handlePriv(const message::AddObject &addObj)
             if (obj)
                 Communicator::the().dataManager().notifyTransferComplete(addObj);
         } else {
-            return sendMessage(hubId(), addObj, destRank);
+            message::Buffer buf(addObj);
+            buf.setDestRank(destRank);
+            return sendMessage(hubId(), buf, destRank);
         }
     }
 
@@ -1927,8 +1974,14 @@ bool ClusterManager::handlePriv(const message::SetParameter &setParam)
 
     assert(setParam.getModule() >= Id::ModuleBase || setParam.getModule() == Id::Vistle ||
            setParam.getModule() == Id::Config || Id::isHub(setParam.getModule()));
-    if (setParam.getModule() == Id::Vistle)
+    if (setParam.getModule() == Id::Vistle) {
         m_compressionSettingsValid = false;
+        if (std::string(setParam.getName()) == "trace_pipeline") {
+            updatePipelineTracing();
+            // let modules know, as they do not track session parameters
+            sendAllLocal(setParam);
+        }
+    }
     int sender = setParam.senderId();
     int dest = setParam.destId();
     RunningMap::iterator i = m_runningMap.find(setParam.getModule());
@@ -2075,6 +2128,17 @@ bool ClusterManager::handlePriv(const message::ItemInfo &info, const MessagePayl
     return true;
 }
 
+bool ClusterManager::handlePriv(const message::ShmInfo &info, const MessagePayload &payload)
+{
+    // reports of other ranks are relayed to the master hub by rank 0
+    return sendHub(info, payload, Id::MasterHub);
+}
+
+bool ClusterManager::handlePriv(const message::TraceData &trace, const MessagePayload &payload)
+{
+    return sendHub(trace, payload, Id::MasterHub);
+}
+
 bool ClusterManager::handlePriv(const message::RequestTunnel &tunnel)
 {
     using message::RequestTunnel;
@@ -2114,6 +2178,67 @@ bool ClusterManager::handlePriv(const message::RequestTunnel &tunnel)
     return sendHub(tun);
 }
 
+void ClusterManager::publishShmUsage()
+{
+    if (m_shmUsageInterval <= 0.)
+        return;
+    auto now = Clock::time();
+    if (now - m_lastShmUsageTime < m_shmUsageInterval)
+        return;
+    // segments shared by all ranks on a node are reported only once
+    if (!Shm::perRank() && Shm::the().nodeRank(m_rank) != 0)
+        return;
+
+    auto usage = Shm::the().usage();
+    if (m_lastShmUsageTime > 0. && usage.allocatedBytes >= m_lastShmAllocatedBytes) {
+        usage.allocationRate = (usage.allocatedBytes - m_lastShmAllocatedBytes) / (now - m_lastShmUsageTime);
+    }
+    m_lastShmUsageTime = now;
+    m_lastShmAllocatedBytes = usage.allocatedBytes;
+
+    message::ShmInfo info(usage.bytes, usage.segmentSize);
+    info.setSenderId(hubId());
+    info.setRank(m_rank);
+    info.setDestId(Id::MasterHub);
+    auto data = addPayload(info, usage);
+    MessagePayload pl;
+    pl.construct(data.size());
+    std::copy(data.begin(), data.end(), pl->begin());
+    sendHub(info, pl, Id::MasterHub);
+}
+
+void ClusterManager::updatePipelineTracing()
+{
+    bool trace = getSessionParameter<Integer>(state(), "trace_pipeline") != 0;
+    if (trace != PipelineTracer::enabled()) {
+        CERR << "pipeline tracing " << (trace ? "enabled" : "disabled") << std::endl;
+    }
+    PipelineTracer::enable(trace);
+}
+
+void ClusterManager::publishPipelineTrace()
+{
+    auto &tracer = PipelineTracer::the();
+    if (tracer.empty())
+        return;
+    // while tracing, batch spans for a second
+    auto now = Clock::time();
+    if (PipelineTracer::enabled() && now - m_lastTracePublishTime < 1.)
+        return;
+    m_lastTracePublishTime = now;
+
+    auto spans = tracer.take();
+    message::TraceData trace(spans.size());
+    trace.setSenderId(hubId());
+    trace.setRank(m_rank);
+    trace.setDestId(Id::MasterHub);
+    auto data = addPayload(trace, spans);
+    MessagePayload pl;
+    pl.construct(data.size());
+    std::copy(data.begin(), data.end(), pl->begin());
+    sendHub(trace, pl, Id::MasterHub);
+}
+
 bool ClusterManager::handlePriv(const message::DataTransferState &state)
 {
     assert(m_rank == 0);
@@ -18,6 +18,7 @@
 #include <vistle/util/enum.h>
 
 #include "portmanager.h"
+#include "rankplacement.h"
 
 #include <boost/mpi.hpp>
 
@@ -144,6 +145,8 @@ private:
     bool handlePriv(const message::BarrierReached &barrierReached);
     bool handlePriv(const message::SendText &text, const MessagePayload &payload);
     bool handlePriv(const message::ItemInfo &info, const MessagePayload &payload);
+    bool handlePriv(const message::ShmInfo &info, const MessagePayload &payload);
+    bool handlePriv(const message::TraceData &trace, const MessagePayload &payload);
     bool handlePriv(const message::RequestTunnel &tunnel);
     bool handlePriv(const message::DataTransferState &state);
 
@@ -217,8 +220,22 @@ private:
     long m_totalNumTransferring = 0;
     double m_lastStatusUpdateTime = 0.;
 
+    // periodic shared memory usage reports, interval set with VISTLE_SHM_USAGE_INTERVAL, 0 disables
+    void publishShmUsage();
+    double m_shmUsageInterval = 10.;
+    double m_lastShmUsageTime = 0.;
+    uint64_t m_lastShmAllocatedBytes = 0;
+
+    // spans of pipeline executions, toggled by session parameter trace_pipeline
+    void updatePipelineTracing();
+    void publishPipelineTrace();
+    double m_lastTracePublishTime = 0.;
+
     CompressionSettings m_compressionSettings;
     bool m_compressionSettingsValid = false;
+
+    // ranks for objects from remote hubs, only used on rank 0
+    RankPlacement m_placement;
 };
 
 } // namespace vistle
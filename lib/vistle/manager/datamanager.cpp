@@ -7,6 +7,7 @@
 #include "communicator.h"
 #include <vistle/util/vecstreambuf.h>
 #include <vistle/util/sleep.h>
+#include <vistle/util/stopwatch.h>
 #include <vistle/util/threadname.h>
 #include <vistle/core/archives.h>
 #include <vistle/core/archive_loader.h>
@@ -15,11 +16,15 @@
 #include <vistle/core/shm_array_impl.h>
 #include <vistle/core/statetracker.h>
 #include <vistle/core/object.h>
+#include <vistle/core/pipelinetrace.h>
 #include <vistle/core/tcpmessage.h>
 #include <vistle/core/messages.h>
+#include <vistle/core/messagepayloadtemplates.h>
 #include <vistle/core/shmvector.h>
 #include <iostream>
+#include <iomanip>
 #include <functional>
+#include <cstdlib>
 
 #define CERR std::cerr << "data [" << m_rank << "/" << m_size << "] "
 
@@ -49,6 +54,7 @@ DataManager::DataManager(mpi::communicator &comm)
 , m_rank(m_comm.rank())
 , m_size(m_comm.size())
 , m_dataSocket(m_ioService)
+, m_sendPool(0, "dmgr_ser")
 #if BOOST_VERSION >= 106600
 , m_workGuard(asio::make_work_guard(m_ioService))
 #else
@@ -67,6 +73,13 @@ DataManager::DataManager(mpi::communicator &comm)
     cleanLoop();
 })
 {
+    if (const char *report = getenv("VISTLE_DATA_STATS")) {
+        m_reportStats = atoi(report) != 0;
+    }
+    if (const char *dedup = getenv("VISTLE_DATA_DEDUP")) {
+        m_dedup = atoi(dedup) != 0;
+    }
+
     if (m_size > 1)
         m_req = m_comm.irecv(boost::mpi::any_source, Communicator::TagData, &m_msgSize, 1);
 }
@@ -89,6 +102,9 @@ DataManager::~DataManager()
     m_workGuard.reset();
     m_ioService.stop();
     m_ioThread.join();
+
+    if (m_reportStats)
+        printStats();
 }
 
 bool DataManager::connect(asio::ip::tcp::resolver::iterator &hub)
@@ -162,6 +178,35 @@ void DataManager::trace(message::Type type)
     m_traceMessages = type;
 }
 
+DataManager::TransferStats DataManager::stats() const
+{
+    std::lock_guard<std::mutex> guard(m_statsMutex);
+    return m_stats;
+}
+
+void DataManager::printStats() const
+{
+    auto s = stats();
+    auto rate = [](size_t bytes, double t) -> double {
+        if (t <= 0.)
+            return 0.;
+        return bytes / t / 1024. / 1024.;
+    };
+    CERR << "transfer stats: " << s.requestMessages << " requests for " << s.arraysRequested << " arrays and "
+         << s.objectsRequested << " objects" << std::endl;
+    CERR << "  sent: " << s.objectsSent << " objects, " << s.arraysSent << " arrays, " << s.bytesSent << " bytes ("
+         << s.rawBytesSent << " uncompressed), " << std::fixed << std::setprecision(1)
+         << rate(s.rawBytesSent, s.serializeTime) << " MB/s serialization" << std::endl;
+    CERR << "  received: " << s.objectsReceived << " objects, " << s.arraysReceived << " arrays, " << s.bytesReceived
+         << " bytes (" << s.rawBytesReceived << " uncompressed), " << std::fixed << std::setprecision(1)
+         << rate(s.rawBytesReceived, s.deserializeTime) << " MB/s deserialization, "
+         << (s.arraysReceived > 0 ? s.arrayLatency / s.arraysReceived * 1e3 : 0.) << " ms avg. array latency"
+         << std::endl;
+    CERR << "  deduplicated: " << s.arraysDeduplicated << " arrays with " << s.bytesDeduplicated
+         << " bytes not sent, " << s.dedupHits << " arrays found locally, " << s.dedupMisses << " re-requested"
+         << std::endl;
+}
+
 bool DataManager::send(const message::Message &message, std::shared_ptr<buffer> payload)
 {
     if (isLocal(message.destId())) {
@@ -189,24 +234,36 @@ bool DataManager::send(const message::Message &message, std::shared_ptr<buffer>
     }
 }
 
-bool DataManager::requestArray(const std::string &referrer, const std::string &arrayId, int type, int hub, int rank,
-                               const ArrayCompletionHandler &handler)
+bool DataManager::addArrayRequest(const std::string &arrayId, const ArrayCompletionHandler &handler)
 {
-    //CERR << "requesting array: " << arrayId << " for " << referrer << std::endl;
-    {
-        std::lock_guard<std::mutex> lock(m_requestArrayMutex);
-        auto it = m_requestedArrays.find(arrayId);
-        if (it != m_requestedArrays.end()) {
-            it->second.push_back(handler);
+    std::lock_guard<std::mutex> lock(m_requestArrayMutex);
+    auto it = m_requestedArrays.find(arrayId);
+    if (it != m_requestedArrays.end()) {
+        it->second.push_back(handler);
 #ifdef DEBUG
-            CERR << "requesting array: " << arrayId << " for " << referrer << ", piggybacking..." << std::endl;
+        CERR << "requesting array: " << arrayId << ", piggybacking..." << std::endl;
 #endif
-            return true;
-        }
+        return false;
+    }
 #ifdef DEBUG
-        CERR << "requesting array: " << arrayId << " for " << referrer << ", requesting..." << std::endl;
+    CERR << "requesting array: " << arrayId << ", requesting..." << std::endl;
 #endif
-        m_requestedArrays[arrayId].push_back(handler);
+    m_requestedArrays[arrayId].push_back(handler);
+    m_arrayRequestTime[arrayId] = Clock::time();
+    return true;
+}
+
+bool DataManager::requestArray(const std::string &referrer, const std::string &arrayId, int type, int hub, int rank,
+                               const ArrayCompletionHandler &handler)
+{
+    //CERR << "requesting array: " << arrayId << " for " << referrer << std::endl;
+    if (!addArrayRequest(arrayId, handler))
+        return true;
+
+    {
+        std::lock_guard<std::mutex> guard(m_statsMutex);
+        ++m_stats.requestMessages;
+        ++m_stats.arraysRequested;
     }
 
     message::RequestObject req(hub, rank, arrayId, type, referrer);
@@ -216,6 +273,41 @@ bool DataManager::requestArray(const std::string &referrer, const std::string &a
     return true;
 }
 
+bool DataManager::requestArrays(const std::string &referrer, const std::vector<ArrayRequest> &arrays, int hub,
+                                int rank)
+{
+    message::RequestObject::Payload pl;
+    for (const auto &ar: arrays) {
+        if (!addArrayRequest(ar.arrayId, ar.handler))
+            continue;
+        pl.arrayIds.push_back(ar.arrayId);
+        pl.arrayTypes.push_back(ar.type);
+    }
+    if (pl.arrayIds.empty())
+        return true;
+
+    {
+        std::lock_guard<std::mutex> guard(m_statsMutex);
+        ++m_stats.requestMessages;
+        m_stats.arraysRequested += pl.arrayIds.size();
+    }
+
+    if (pl.arrayIds.size() == 1) {
+        message::RequestObject req(hub, rank, pl.arrayIds[0], pl.arrayTypes[0], referrer);
+        req.setSenderId(Communicator::the().hubId());
+        req.setRank(m_rank);
+        send(req);
+        return true;
+    }
+
+    message::RequestObject req(hub, rank, pl.arrayIds.size(), referrer);
+    req.setSenderId(Communicator::the().hubId());
+    req.setRank(m_rank);
+    auto payload = std::make_shared<buffer>(addPayload(req, pl));
+    send(req, payload);
+    return true;
+}
+
 bool DataManager::requestObject(const message::AddObject &add, const std::string &objId,
                                 const ObjectCompletionHandler &handler)
 {
@@ -243,12 +335,23 @@ bool DataManager::requestObject(const message::AddObject &add, const std::string
 #endif
             return true;
         }
-        m_requestedObjects[objId].completionHandlers.push_back(handler);
+        auto &outstanding = m_requestedObjects[objId];
+        outstanding.completionHandlers.push_back(handler);
+        if (PipelineTracer::enabled()) {
+            outstanding.module = add.destId();
+            outstanding.requestTime = PipelineTracer::now();
+        }
 #ifdef DEBUG
         CERR << m_outstandingAdds[objId].size() << " outstanding adds for " << objId << ", requesting..." << std::endl;
 #endif
     }
 
+    {
+        std::lock_guard<std::mutex> guard(m_statsMutex);
+        ++m_stats.requestMessages;
+        ++m_stats.objectsRequested;
+    }
+
     message::RequestObject req(add, objId);
     req.setSenderId(Communicator::the().hubId());
     req.setRank(m_rank);
@@ -290,6 +393,12 @@ bool DataManager::requestObject(const std::string &referrer, const std::string &
 #endif
     }
 
+    {
+        std::lock_guard<std::mutex> guard(m_statsMutex);
+        ++m_stats.requestMessages;
+        ++m_stats.objectsRequested;
+    }
+
     message::RequestObject req(hub, rank, objId, referrer);
     req.setSenderId(Communicator::the().hubId());
     req.setRank(m_rank);
@@ -375,7 +484,7 @@ bool DataManager::handle(const message::Message &msg, buffer *payload)
         return true;
     }
     case message::REQUESTOBJECT:
-        return handlePriv(static_cast<const RequestObject &>(msg));
+        return handlePriv(static_cast<const RequestObject &>(msg), payload);
     case message::SENDOBJECT:
         return handlePriv(static_cast<const SendObject &>(msg), payload);
     case message::ADDOBJECTCOMPLETED:
@@ -404,9 +513,25 @@ public:
     void requestArray(const std::string &name, int type, const ArrayCompletionHandler &completeCallback) override
     {
         assert(!m_add);
+        if (m_batch) {
+            m_arrays.push_back(DataManager::ArrayRequest{name, type, completeCallback});
+            return;
+        }
         m_dmgr->requestArray(m_referrer, name, type, m_hub, m_rank, completeCallback);
     }
 
+    //! collect array requests until flush() instead of requesting each one immediately
+    void setBatch(bool batch) { m_batch = batch; }
+
+    //! request all collected arrays with a single message
+    void flush()
+    {
+        m_batch = false;
+        if (!m_arrays.empty())
+            m_dmgr->requestArrays(m_referrer, m_arrays, m_hub, m_rank);
+        m_arrays.clear();
+    }
+
     void requestObject(const std::string &name, const ObjectCompletionHandler &completeCallback) override
     {
         m_dmgr->requestObject(m_referrer, name, m_hub, m_rank, completeCallback);
@@ -416,19 +541,161 @@ public:
     const message::AddObject *m_add;
     const std::string m_referrer;
     int m_hub, m_rank;
+    bool m_batch = false;
+    std::vector<DataManager::ArrayRequest> m_arrays;
 };
 
-bool DataManager::handlePriv(const message::RequestObject &req)
+void DataManager::completeArrayRequest(const message::SendObject &snd, const std::string &name)
+{
+    std::unique_lock<std::mutex> lock(m_requestArrayMutex);
+    //CERR << "restored array " << snd.objectId() << ", dangling in memory" << std::endl;
+    auto tit = m_arrayRequestTime.find(snd.objectId());
+    if (tit != m_arrayRequestTime.end()) {
+        std::lock_guard<std::mutex> guard(m_statsMutex);
+        m_stats.arrayLatency += Clock::time() - tit->second;
+        m_arrayRequestTime.erase(tit);
+    }
+    auto it = m_requestedArrays.find(snd.objectId());
+    if (it == m_requestedArrays.end()) {
+        CERR << "restored array " << snd.objectId() << " for " << snd.referrer() << ", but did not find request"
+             << std::endl;
+    }
+    assert(it != m_requestedArrays.end());
+    if (it != m_requestedArrays.end()) {
+        auto handlers = std::move(it->second);
+#ifdef DEBUG
+        CERR << "restored array " << snd.objectId() << " as " << name << ", " << handlers.size()
+             << " completion handler" << std::endl;
+#endif
+        m_requestedArrays.erase(it);
+        const bool idle = m_reportStats && m_requestedArrays.empty();
+        lock.unlock();
+        for (const auto &completionHandler: handlers)
+            completionHandler(name);
+        if (idle)
+            printStats();
+    }
+}
+
+bool DataManager::sendArray(const message::RequestObject &req, const std::string &arrayId, int type)
+{
+    double start = Clock::time();
+    std::string hash;
+    if (m_dedup) {
+        ArrayHasher hasher(arrayId, type);
+        if (hasher.compute()) {
+            hash = hasher.hash();
+            const auto peer = std::make_pair(req.senderId(), req.rank());
+            bool known = false;
+            if (!req.contentRequired()) {
+                std::lock_guard<std::mutex> guard(m_peerHashMutex);
+                auto it = m_peerHashes.find(peer);
+                known = it != m_peerHashes.end() && it->second.count(hash) > 0;
+            }
+            if (known) {
+                // receiver already got an array with identical contents, it will only have to look it up
+                message::RequestObject single(req.senderId(), req.rank(), arrayId, type, req.referrer());
+                single.setUuid(req.uuid());
+                message::SendObject snd(single, 0);
+                snd.setContentHash(hash);
+                snd.setHashOnly(true);
+                snd.setDestId(req.senderId());
+                snd.setDestRank(req.rank());
+                snd.setSenderId(Communicator::the().hubId());
+                snd.setRank(m_rank);
+                {
+                    std::lock_guard<std::mutex> guard(m_statsMutex);
+                    ++m_stats.arraysDeduplicated;
+                    m_stats.bytesDeduplicated += hasher.size();
+                    m_stats.serializeTime += Clock::time() - start;
+                }
+                return send(snd);
+            }
+        }
+    }
+
+    vecostreambuf<buffer> buf;
+    buffer &mem = buf.get_vector();
+    vistle::oarchive memar(buf);
+#ifdef USE_YAS
+    memar.setCompressionSettings(Communicator::the().clusterManager().compressionSettings());
+#endif
+    ArraySaver saver(arrayId, type, memar);
+    if (!saver.save()) {
+        CERR << "failed to serialize array " << arrayId << std::endl;
+        return false;
+    }
+
+    message::RequestObject single(req.senderId(), req.rank(), arrayId, type, req.referrer());
+    single.setUuid(req.uuid());
+    message::SendObject snd(single, mem.size());
+    auto compressed = std::make_shared<buffer>();
+    *compressed = message::compressPayload(Communicator::the().clusterManager().archiveCompressionMode(), snd, mem,
+                                           Communicator::the().clusterManager().archiveCompressionSpeed());
+
+    snd.setContentHash(hash);
+    snd.setDestId(req.senderId());
+    snd.setDestRank(req.rank());
+    snd.setSenderId(Communicator::the().hubId());
+    snd.setRank(m_rank);
+    {
+        std::lock_guard<std::mutex> guard(m_statsMutex);
+        ++m_stats.arraysSent;
+        m_stats.bytesSent += compressed->size();
+        m_stats.rawBytesSent += mem.size();
+        m_stats.serializeTime += Clock::time() - start;
+    }
+    if (!send(snd, compressed))
+        return false;
+    if (!hash.empty()) {
+        std::lock_guard<std::mutex> guard(m_peerHashMutex);
+        auto &hashes = m_peerHashes[std::make_pair(req.senderId(), req.rank())];
+        if (hashes.size() >= MaxPeerHashes)
+            hashes.clear();
+        hashes.insert(hash);
+    }
+    return true;
+}
+
+bool DataManager::handlePriv(const message::RequestObject &req, buffer *payload)
 {
 #ifdef DEBUG
-    if (req.isArray()) {
+    if (req.numArrays() > 0) {
+        CERR << "request for " << req.numArrays() << " arrays" << std::endl;
+    } else if (req.isArray()) {
         CERR << "request for array " << req.objectId() << std::endl;
     } else {
         CERR << "request for object " << req.objectId() << std::endl;
     }
 #endif
 
-    auto fut = std::async(std::launch::async, [this, req]() {
+    if (req.numArrays() > 0) {
+        // serialize and compress arrays concurrently, each one is sent as soon as it is ready
+        if (!payload || req.payloadSize() == 0 || payload->size() < req.payloadSize()) {
+            CERR << "missing payload for request of " << req.numArrays() << " arrays" << std::endl;
+            return false;
+        }
+        auto pl = message::getPayload<message::RequestObject::Payload>(*payload);
+        if (pl.arrayIds.size() != req.numArrays() || pl.arrayTypes.size() != req.numArrays()) {
+            CERR << "inconsistent payload for request of " << req.numArrays() << " arrays" << std::endl;
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_sendTaskMutex);
+        for (size_t i = 0; i < pl.arrayIds.size(); ++i) {
+            auto arrayId = pl.arrayIds[i];
+            auto type = pl.arrayTypes[i];
+            m_sendTasks.emplace_back(
+                m_sendPool.submit([this, req, arrayId, type]() { return sendArray(req, arrayId, type); }));
+        }
+        return true;
+    }
+
+    auto fut = m_sendPool.submit([this, req]() {
+        if (req.isArray()) {
+            return sendArray(req, req.objectId(), req.arrayType());
+        }
+
+        double start = Clock::time();
         std::shared_ptr<message::SendObject> snd;
         vecostreambuf<buffer> buf;
         buffer &mem = buf.get_vector();
@@ -436,22 +703,13 @@ bool DataManager::handlePriv(const message::RequestObject &req)
 #ifdef USE_YAS
         memar.setCompressionSettings(Communicator::the().clusterManager().compressionSettings());
 #endif
-        if (req.isArray()) {
-            ArraySaver saver(req.objectId(), req.arrayType(), memar);
-            if (!saver.save()) {
-                CERR << "failed to serialize array " << req.objectId() << std::endl;
-                return false;
-            }
-            snd.reset(new message::SendObject(req, mem.size()));
-        } else {
-            Object::const_ptr obj = Shm::the().getObjectFromName(req.objectId());
-            if (!obj) {
-                CERR << "cannot find object with name " << req.objectId() << std::endl;
-                return false;
-            }
-            obj->saveObject(memar);
-            snd.reset(new message::SendObject(req, obj, mem.size()));
+        Object::const_ptr obj = Shm::the().getObjectFromName(req.objectId());
+        if (!obj) {
+            CERR << "cannot find object with name " << req.objectId() << std::endl;
+            return false;
         }
+        obj->saveObject(memar);
+        snd.reset(new message::SendObject(req, obj, mem.size()));
 
         auto compressed = std::make_shared<buffer>();
         *compressed = message::compressPayload(Communicator::the().clusterManager().archiveCompressionMode(), *snd, mem,
@@ -461,6 +719,13 @@ bool DataManager::handlePriv(const message::RequestObject &req)
         snd->setDestRank(req.rank());
         snd->setSenderId(Communicator::the().hubId());
         snd->setRank(m_rank);
+        {
+            std::lock_guard<std::mutex> guard(m_statsMutex);
+            ++m_stats.objectsSent;
+            m_stats.bytesSent += compressed->size();
+            m_stats.rawBytesSent += mem.size();
+            m_stats.serializeTime += Clock::time() - start;
+        }
         send(*snd, compressed);
         //CERR << "sent " << snd->payloadSize() << "(" << snd->payloadRawSize() << ") bytes for " << req << " with " << *snd << std::endl;
 
@@ -485,8 +750,32 @@ bool DataManager::handlePriv(const message::SendObject &snd, buffer *payload)
     }
 #endif
 
+    if (snd.isHashOnly()) {
+        std::string name;
+        std::shared_ptr<ArrayLoader::ArrayOwner> owner;
+        if (!ArrayLoader::findByHash(snd.contentHash(), snd.objectType(), name, owner)) {
+            // array has been deleted in the meantime, request it again including its contents
+            {
+                std::lock_guard<std::mutex> guard(m_statsMutex);
+                ++m_stats.dedupMisses;
+            }
+            message::RequestObject req(snd.senderId(), snd.rank(), snd.objectId(), snd.objectType(), snd.referrer());
+            req.setContentRequired(true);
+            req.setSenderId(Communicator::the().hubId());
+            req.setRank(m_rank);
+            return send(req);
+        }
+        {
+            std::lock_guard<std::mutex> guard(m_statsMutex);
+            ++m_stats.dedupHits;
+        }
+        completeArrayRequest(snd, name);
+        return true;
+    }
+
     auto payload2 = std::make_shared<buffer>(std::move(*payload));
     auto fut = std::async(std::launch::async, [this, snd, payload2]() {
+        double start = Clock::time();
         buffer uncompressed = decompressPayload(snd, *payload2.get());
         vecistreambuf<buffer> membuf(uncompressed);
 
@@ -499,27 +788,15 @@ bool DataManager::handlePriv(const message::SendObject &snd, buffer *payload)
                 return false;
             }
 
-            std::unique_lock<std::mutex> lock(m_requestArrayMutex);
-            //CERR << "restored array " << snd.objectId() << ", dangling in memory" << std::endl;
-            auto it = m_requestedArrays.find(snd.objectId());
-            if (it == m_requestedArrays.end()) {
-                CERR << "restored array " << snd.objectId() << " for " << snd.referrer() << ", but did not find request"
-                     << std::endl;
+            {
+                std::lock_guard<std::mutex> guard(m_statsMutex);
+                ++m_stats.arraysReceived;
+                m_stats.bytesReceived += payload2->size();
+                m_stats.rawBytesReceived += uncompressed.size();
+                m_stats.deserializeTime += Clock::time() - start;
             }
-            assert(it != m_requestedArrays.end());
-            if (it != m_requestedArrays.end()) {
-                auto handlers = std::move(it->second);
-#ifdef DEBUG
-                CERR << "restored array " << snd.objectId() << ", " << handlers.size() << " completion handler"
-                     << std::endl;
-#endif
-                m_requestedArrays.erase(it);
-                lock.unlock();
-                for (const auto &completionHandler: handlers)
-                    completionHandler(snd.objectId());
-                lock.lock();
-            }
-
+            Shm::the().registerArrayHash(loader.name(), snd.contentHash());
+            completeArrayRequest(snd, loader.name());
             return true;
         }
 
@@ -554,6 +831,8 @@ bool DataManager::handlePriv(const message::SendObject &snd, buffer *payload)
             if (objIt != m_requestedObjects.end()) {
                 auto handlers = std::move(objIt->second.completionHandlers);
                 auto objref = objIt->second.obj;
+                int module = objIt->second.module;
+                double requestTime = objIt->second.requestTime;
                 m_requestedObjects.erase(objIt);
                 lock.unlock();
                 auto obj = Shm::the().getObjectFromName(objName);
@@ -565,6 +844,19 @@ bool DataManager::handlePriv(const message::SendObject &snd, buffer *payload)
                     }
                 }
                 assert(obj);
+                if (requestTime > 0. && PipelineTracer::enabled()) {
+                    TraceSpan span;
+                    span.kind = TraceSpan::Transfer;
+                    span.module = module;
+                    span.rank = m_rank;
+                    span.thread = PipelineTracer::threadNumber();
+                    span.block = obj ? obj->getBlock() : -1;
+                    span.timestep = obj ? obj->getTimestep() : -1;
+                    span.begin = requestTime;
+                    span.end = PipelineTracer::now();
+                    span.name = objName;
+                    PipelineTracer::the().record(std::move(span));
+                }
                 for (const auto &handler: handlers) {
                     handler(obj);
                 }
@@ -576,13 +868,23 @@ bool DataManager::handlePriv(const message::SendObject &snd, buffer *payload)
 
         vistle::iarchive memar(membuf);
         memar.setObjectCompletionHandler(completionHandler);
-        std::shared_ptr<Fetcher> fetcher(new RemoteFetcher(this, snd.referrer(), snd.senderId(), snd.rank()));
+        auto fetcher = std::make_shared<RemoteFetcher>(this, snd.referrer(), snd.senderId(), snd.rank());
+        // request all arrays missing for this object with a single message
+        fetcher->setBatch(true);
         memar.setFetcher(fetcher);
         Object::const_ptr obj(Object::loadObject(memar));
         if (!obj) {
             CERR << "loading from archive failed for " << objName << std::endl;
         }
         assert(obj);
+        {
+            std::lock_guard<std::mutex> guard(m_statsMutex);
+            ++m_stats.objectsReceived;
+            m_stats.bytesReceived += payload2->size();
+            m_stats.rawBytesReceived += uncompressed.size();
+            m_stats.deserializeTime += Clock::time() - start;
+        }
+        fetcher->flush();
 
         std::lock_guard<std::mutex> lock(m_requestObjectMutex);
         auto objIt = m_requestedObjects.find(objName);
@@ -11,6 +11,7 @@
 #include <vistle/core/messages.h>
 #include <vistle/core/object.h>
 #include <vistle/util/buffer.h>
+#include <vistle/util/threadpool.h>
 
 #if BOOST_VERSION >= 106600
 #include <boost/asio/executor_work_guard.hpp>
@@ -29,6 +30,30 @@ class Object;
 
 class DataManager {
 public:
+    struct ArrayRequest {
+        std::string arrayId;
+        int type;
+        ArrayCompletionHandler handler;
+    };
+
+    //! statistics on bulk data transfers from and to remote ranks
+    struct TransferStats {
+        size_t requestMessages = 0; //!< number of request messages sent
+        size_t arraysRequested = 0; //!< number of arrays requested, possibly several per message
+        size_t objectsRequested = 0;
+        size_t arraysSent = 0, objectsSent = 0;
+        size_t bytesSent = 0, rawBytesSent = 0; //!< payload size after and before compression
+        size_t arraysReceived = 0, objectsReceived = 0;
+        size_t bytesReceived = 0, rawBytesReceived = 0;
+        double serializeTime = 0.; //!< time spent for serializing and compressing sent payloads
+        double deserializeTime = 0.; //!< time spent for decompressing and restoring received payloads
+        double arrayLatency = 0.; //!< accumulated time from requesting an array until it has been restored
+        size_t arraysDeduplicated = 0; //!< arrays for which only the content hash has been sent
+        size_t bytesDeduplicated = 0; //!< uncompressed size of arrays not sent because of identical content
+        size_t dedupHits = 0; //!< received content hashes resolved to local arrays
+        size_t dedupMisses = 0; //!< received content hashes without local array, re-requested with contents
+    };
+
     DataManager(boost::mpi::communicator &comm);
     ~DataManager();
     bool handle(const message::Message &msg, buffer *payload);
@@ -39,6 +64,8 @@ public:
                        const ObjectCompletionHandler &handler);
     bool requestArray(const std::string &referrer, const std::string &arrayId, int type, int hub, int rank,
                       const ArrayCompletionHandler &handler);
+    //! request several arrays from the same remote rank with a single message
+    bool requestArrays(const std::string &referrer, const std::vector<ArrayRequest> &arrays, int hub, int rank);
     bool prepareTransfer(const message::AddObject &add);
     bool completeTransfer(const message::AddObjectCompleted &complete);
     bool notifyTransferComplete(const message::AddObject &add);
@@ -46,6 +73,8 @@ public:
     bool dispatch();
 
     void trace(message::Type type);
+    TransferStats stats() const;
+    void printStats() const;
 
     bool send(const message::Message &message, std::shared_ptr<buffer> payload = nullptr);
 
@@ -56,7 +85,12 @@ public:
     };
 
 private:
-    bool handlePriv(const message::RequestObject &req);
+    //! record handler for array, return whether it still has to be requested
+    bool addArrayRequest(const std::string &arrayId, const ArrayCompletionHandler &handler);
+    bool sendArray(const message::RequestObject &req, const std::string &arrayId, int type);
+    //! invoke completion handlers for array requested as snd.objectId(), which is available locally as name
+    void completeArrayRequest(const message::SendObject &snd, const std::string &name);
+    bool handlePriv(const message::RequestObject &req, buffer *payload);
     bool handlePriv(const message::SendObject &snd, buffer *payload);
     bool handlePriv(const message::AddObjectCompleted &complete);
     void updateStatus();
@@ -86,10 +120,13 @@ private:
     std::mutex m_requestArrayMutex;
     std::map<std::string, std::vector<ArrayCompletionHandler>>
         m_requestedArrays; //!< requests for (sub-)objects which have not been serviced yet
+    std::map<std::string, double> m_arrayRequestTime; //!< when arrays have been requested
 
     struct OutstandingObject {
         vistle::Object::const_ptr obj;
         std::vector<ObjectCompletionHandler> completionHandlers;
+        int module = message::Id::Invalid; //!< receiver of AddObject that triggered request
+        double requestTime = 0.; //!< when request was sent, for pipeline tracing
     };
     std::mutex m_requestObjectMutex;
     std::map<std::string, OutstandingObject>
@@ -100,6 +137,16 @@ private:
 
     std::mutex m_sendTaskMutex;
     std::deque<std::future<bool>> m_sendTasks;
+    ThreadPool m_sendPool; //!< serializes and compresses requested objects and arrays
+
+    mutable std::mutex m_statsMutex;
+    TransferStats m_stats;
+    bool m_reportStats = false; //!< print statistics whenever all outstanding requests have been serviced
+
+    bool m_dedup = true; //!< send only content hash of arrays that the receiver already got
+    static const size_t MaxPeerHashes = 100000;
+    std::mutex m_peerHashMutex;
+    std::map<std::pair<int, int>, std::set<std::string>> m_peerHashes; //!< content hashes sent to (hub, rank)
 
 #if BOOST_VERSION >= 106600
     boost::asio::executor_work_guard<boost::asio::io_context::executor_type> m_workGuard;
@@ -0,0 +1,111 @@
+#include "rankplacement.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace vistle {
+
+uint64_t RankPlacement::Block::total() const
+{
+    uint64_t sum = 0;
+    for (const auto &c: cost)
+        sum += c.second;
+    return sum;
+}
+
+RankPlacement::RankPlacement(int size): m_size(std::max(1, size)), m_load(m_size)
+{}
+
+void RankPlacement::setPolicy(Policy policy)
+{
+    m_policy = policy;
+}
+
+RankPlacement::Policy RankPlacement::policy() const
+{
+    return m_policy;
+}
+
+void RankPlacement::setRebalanceThreshold(double factor)
+{
+    m_rebalanceThreshold = factor;
+}
+
+uint64_t RankPlacement::load(int rank) const
+{
+    assert(rank >= 0 && rank < m_size);
+    return m_load[rank];
+}
+
+int RankPlacement::leastLoaded(int preferred) const
+{
+    // on ties, prefer the rank chosen by the modulo mapping
+    int rank = preferred;
+    for (int r = 0; r < m_size; ++r) {
+        if (m_load[r] < m_load[rank])
+            rank = r;
+    }
+    return rank;
+}
+
+void RankPlacement::move(Block &block, int rank)
+{
+    const uint64_t cost = block.total();
+    if (block.rank >= 0)
+        m_load[block.rank] -= cost;
+    block.rank = rank;
+    m_load[block.rank] += cost;
+}
+
+int RankPlacement::place(int sender, const std::string &port, int block, int timestep, uint64_t cost)
+{
+    if (block < 0)
+        return -1;
+    if (m_policy == Modulo)
+        return block % m_size;
+
+    // also account for objects without cells or values, e.g. placeholders
+    cost = std::max<uint64_t>(cost, 1);
+
+    auto &b = m_blocks[block];
+    if (b.rank < 0) {
+        move(b, leastLoaded(block % m_size));
+    } else if (m_rebalanceThreshold > 0. && timestep >= 0 && timestep != b.timestep && m_size > 1) {
+        // only move at the start of a new timestep, so that all objects of a timestep stay together
+        const double average = double(m_totalLoad) / m_size;
+        if (m_load[b.rank] > m_rebalanceThreshold * average) {
+            int target = leastLoaded(b.rank);
+            if (target != b.rank && m_load[target] + b.total() < m_load[b.rank])
+                move(b, target);
+        }
+    }
+    if (timestep >= 0)
+        b.timestep = timestep;
+
+    auto &c = b.cost[Source(sender, port)];
+    m_load[b.rank] += cost;
+    m_load[b.rank] -= c;
+    m_totalLoad += cost;
+    m_totalLoad -= c;
+    c = cost;
+
+    return b.rank;
+}
+
+void RankPlacement::removeSender(int sender)
+{
+    for (auto &b: m_blocks) {
+        auto &block = b.second;
+        for (auto it = block.cost.begin(); it != block.cost.end();) {
+            if (it->first.first == sender) {
+                m_load[block.rank] -= it->second;
+                m_totalLoad -= it->second;
+                it = block.cost.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+} // namespace vistle
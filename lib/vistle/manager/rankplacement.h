@@ -0,0 +1,60 @@
+#ifndef RANKPLACEMENT_H
+#define RANKPLACEMENT_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vistle {
+
+//! chooses the rank handling an object received from a remote hub
+/*! with the Balanced policy, a block is placed on the rank with the least load when it is seen first
+    and stays there for subsequent timesteps, so that grids and data of a block and their caches end up together.
+    The load of a rank is the sum of the costs of the most recent objects of the blocks placed on it.
+    If a rebalancing threshold is set, a block is moved at the start of a new timestep
+    when the load of its rank exceeds the average load by this factor. */
+class RankPlacement {
+public:
+    enum Policy {
+        Modulo, //!< block % size, as before
+        Balanced,
+    };
+
+    explicit RankPlacement(int size);
+
+    void setPolicy(Policy policy);
+    Policy policy() const;
+    //! factor by which load of a rank has to exceed average load for moving blocks, 0 disables rebalancing
+    void setRebalanceThreshold(double factor);
+
+    //! rank for an object with the given cost sent from port of module sender, -1 if not partitioned into blocks
+    int place(int sender, const std::string &port, int block, int timestep, uint64_t cost);
+    //! forget costs of objects sent by a module
+    void removeSender(int sender);
+
+    uint64_t load(int rank) const;
+
+private:
+    typedef std::pair<int, std::string> Source; // module and port
+    struct Block {
+        int rank = -1;
+        int timestep = -1;
+        std::map<Source, uint64_t> cost; //!< cost of most recent object from source
+        uint64_t total() const;
+    };
+
+    int leastLoaded(int preferred) const;
+    void move(Block &block, int rank);
+
+    int m_size = 1;
+    Policy m_policy = Balanced;
+    double m_rebalanceThreshold = 0.;
+    std::map<int, Block> m_blocks;
+    std::vector<uint64_t> m_load;
+    uint64_t m_totalLoad = 0;
+};
+
+} // namespace vistle
+#endif
@@ -24,6 +24,7 @@
 #include <vistle/util/exception.h>
 #include <vistle/util/shmconfig.h>
 #include <vistle/util/threadname.h>
+#include <vistle/util/threadpool.h>
 #include <vistle/util/affinity.h>
 #include <vistle/util/profile.h>
 #include <vistle/config/config.h>
@@ -35,6 +36,7 @@
 #include <vistle/core/messagerouter.h>
 #include <vistle/core/messagepayload.h>
 #include <vistle/core/parameter.h>
+#include <vistle/core/pipelinetrace.h>
 #include <vistle/core/shm.h>
 #include <vistle/core/port.h>
 #include <vistle/core/statetracker.h>
@@ -332,6 +334,9 @@ Module::Module(const std::string &moduleName, const int moduleId, mpi::communica
 
 #ifndef MODULE_THREAD
     message::DefaultSender::init(m_id, m_rank);
+#else
+    // all modules share the hub's process
+    Shm::setThreadOwner(m_id);
 #endif
 
     // names are swapped relative to communicator
@@ -384,7 +389,7 @@ Module::Module(const std::string &moduleName, const int moduleId, mpi::communica
     auto outrank = addIntParameter("_error_output_rank", "rank from which to show stderr (-1: all ranks)", -1);
     setParameterRange<Integer>(outrank, -1, size() - 1);
 
-    auto openmp_threads = addIntParameter("_openmp_threads", "number of OpenMP threads (0: system default)", 0);
+    auto openmp_threads = addIntParameter("_openmp_threads", "number of OpenMP and block task threads (0: system default)", 0);
     setParameterRange<Integer>(openmp_threads, 0, 4096);
     addIntParameter("_benchmark", "show timing information", m_benchmark ? 1 : 0, Parameter::Boolean);
 
@@ -937,16 +942,41 @@ void Module::updateOutputMode()
 
 void Module::waitAllTasks()
 {
-    while (!m_tasks.empty()) {
-        m_tasks.front()->wait();
-        m_tasks.pop_front();
-    }
+    retireTasks(0);
     if (m_lastTask) {
         m_lastTask->wait();
         m_lastTask.reset();
     }
 }
 
+void Module::retireTasks(size_t maxInFlight)
+{
+    // tasks are retired in submission order, so that objects are added to output ports in input order
+    while (!m_tasks.empty()) {
+        auto &task = m_tasks.front();
+        if (m_tasks.size() <= maxInFlight && !task->isFinished())
+            break;
+        task->wait();
+        m_tasks.pop_front();
+    }
+}
+
+ThreadPool &Module::threadPool()
+{
+    unsigned nthreads = openmpThreads();
+    if (nthreads == 0)
+        nthreads = hardware_concurrency();
+    if (nthreads == 0)
+        nthreads = 1;
+    if (m_threadPool && m_threadPool->size() != nthreads && m_tasks.empty()) {
+        m_threadPool.reset();
+    }
+    if (!m_threadPool) {
+        m_threadPool = std::make_unique<ThreadPool>(nthreads, std::to_string(id()) + "p");
+    }
+    return *m_threadPool;
+}
+
 void Module::updateMeta(vistle::Object::ptr obj) const
 {
     if (!obj)
@@ -1379,6 +1409,11 @@ bool Module::getNextMessage(message::Buffer &buf, bool block, unsigned int minPr
             }
         }
         if (block) {
+            TraceScope trace(TraceSpan::Wait, id(), rank());
+            if (!m_prepared || m_reduced) {
+                // only waits during an execution are of interest
+                trace.cancel();
+            }
             receiveMessageQueue->receive(buf);
             recv = true;
         }
@@ -1772,6 +1807,10 @@ bool Module::handleMessage(const vistle::message::Message *message, const Messag
         if (param->destId() == id()) {
             ParameterManager::handleMessage(*param);
         } else {
+            if (param->getModule() == Id::Vistle && std::string(param->getName()) == "trace_pipeline" &&
+                param->rangeType() == Parameter::Value) {
+                PipelineTracer::enable(param->getInteger() != 0);
+            }
             // notification of controller about current value happens in set...Parameter
             parameterChanged(param->getModule(), param->getName(), *param);
         }
@@ -2224,7 +2263,7 @@ bool Module::handleExecute(const vistle::message::Execute *exec)
             computeOk = false;
             try {
                 double start = Clock::time();
-                int timestep = -1;
+                int timestep = -1, block = -1;
                 bool objectIsEmpty = false;
                 for (auto &port: inputPorts) {
                     if (port.second.flags() & Port::NOCOMPUTE)
@@ -2238,6 +2277,9 @@ bool Module::handleExecute(const vistle::message::Execute *exec)
                         int t = getTimestep(objs.front());
                         if (t != -1)
                             timestep = t;
+                        int b = getBlock(objs.front());
+                        if (b != -1)
+                            block = b;
                         if (Empty::as(objs.front()))
                             objectIsEmpty = true;
                     }
@@ -2262,6 +2304,7 @@ bool Module::handleExecute(const vistle::message::Execute *exec)
                     computeOk = true;
                 } else {
                     PROF_SCOPE("Module::compute");
+                    TraceScope trace(TraceSpan::Compute, id(), rank(), block, timestep);
                     computeOk = compute();
                 }
 
@@ -2595,6 +2638,8 @@ bool Module::prepareWrapper(const message::Execute *exec)
     start.setDestId(Id::LocalManager);
     sendMessage(start);
 
+    TraceScope trace(TraceSpan::Prepare, id(), rank());
+
     if (collective) {
         int oldGeneration = m_generation;
         m_generation = boost::mpi::all_reduce(comm(), m_generation, boost::mpi::maximum<int>());
@@ -2645,18 +2690,15 @@ bool Module::compute()
     if (concurrency <= 1)
         concurrency = 1;
 
-    while (m_tasks.size() >= unsigned(concurrency)) {
-        m_tasks.front()->wait();
-        m_tasks.pop_front();
-    }
+    retireTasks(concurrency - 1);
+    auto &pool = threadPool();
     m_tasks.push_back(task);
 
-    std::unique_lock<std::mutex> guard(task->m_mutex);
     auto tname = std::to_string(id()) + "b" + std::to_string(m_tasks.size()) + ":" + name();
-    task->m_future = std::async(std::launch::async, [this, tname, task] {
+    pool.enqueue([tname, task] {
         PROF_FUNC();
         setThreadName(tname);
-        return compute(task);
+        task->run();
     });
     return true;
 }
@@ -2672,6 +2714,8 @@ bool Module::reduceWrapper(const message::Execute *exec, bool reordered)
 {
     //CERR << "reduceWrapper: prepared=" << m_prepared << ", generation = " << m_generation << std::endl;
 
+    TraceScope trace(TraceSpan::Reduce, id(), rank());
+
     assert(m_prepared);
     if (reducePolicy() != message::ReducePolicy::Never) {
         assert(!m_reduced);
@@ -2755,6 +2799,9 @@ bool Module::reduceWrapper(const message::Execute *exec, bool reordered)
         }
     }
 
+    trace.end();
+    publishPipelineTrace();
+
     message::ExecutionProgress fin(message::ExecutionProgress::Finish);
     fin.setReferrer(exec->uuid());
     fin.setDestId(Id::LocalManager);
@@ -2781,6 +2828,18 @@ bool Module::reduceWrapper(const message::Execute *exec, bool reordered)
     return ret;
 }
 
+void Module::publishPipelineTrace()
+{
+    auto &tracer = PipelineTracer::the();
+    if (tracer.empty())
+        return;
+
+    auto spans = tracer.take();
+    message::TraceData trace(spans.size());
+    trace.setDestId(Id::MasterHub);
+    sendMessageWithPayload(trace, spans);
+}
+
 bool Module::reduce(int timestep)
 {
 #ifndef NDEBUG
@@ -2908,6 +2967,7 @@ BlockTask::~BlockTask()
 {
     assert(m_dependencies.empty());
     assert(m_objects.empty());
+    assert(m_continuations.empty());
 }
 
 bool BlockTask::hasObject(const Port *p)
@@ -2929,7 +2989,34 @@ Object::const_ptr BlockTask::takeObject(const Port *p)
 
 void BlockTask::addDependency(std::shared_ptr<BlockTask> dep)
 {
-    m_dependencies.insert(dep);
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (!m_dependencies.insert(dep).second)
+            return;
+        ++m_pendingDependencies;
+    }
+
+    std::weak_ptr<BlockTask> weak = shared_from_this();
+    dep->then([weak]() {
+        if (auto task = weak.lock()) {
+            std::lock_guard<std::mutex> guard(task->m_mutex);
+            assert(task->m_pendingDependencies > 0);
+            --task->m_pendingDependencies;
+            task->m_cond.notify_all();
+        }
+    });
+}
+
+void BlockTask::then(std::function<void()> continuation)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (!m_retired) {
+            m_continuations.emplace_back(std::move(continuation));
+            return;
+        }
+    }
+    continuation();
 }
 
 void BlockTask::addObject(Port *port, Object::ptr obj)
@@ -2961,22 +3048,67 @@ void BlockTask::addAllObjects()
     m_objects.clear();
 }
 
+void BlockTask::run()
+{
+    bool result = false;
+    std::exception_ptr exception;
+    try {
+        TraceScope trace(TraceSpan::Block, m_module->id(), m_module->rank());
+        if (trace.active() && !m_input.empty())
+            trace.setBlock(getBlock(m_input.begin()->second), getTimestep(m_input.begin()->second));
+        result = m_module->compute(shared_from_this());
+    } catch (...) {
+        exception = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_result = result;
+    m_exception = exception;
+    m_finished = true;
+    m_cond.notify_all();
+}
+
+bool BlockTask::isFinished()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_finished;
+}
+
 bool BlockTask::wait()
 {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (m_retired)
+            return m_result;
+    }
+
     waitDependencies();
-    bool result = m_future.get();
+
+    std::vector<std::function<void()>> continuations;
+    {
+        std::unique_lock<std::mutex> guard(m_mutex);
+        m_cond.wait(guard, [this]() { return m_finished; });
+    }
     addAllObjects();
-    return result;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_retired = true;
+        std::swap(continuations, m_continuations);
+    }
+    for (auto &c: continuations)
+        c();
+
+    if (m_exception)
+        std::rethrow_exception(m_exception);
+    return m_result;
 }
 
 bool BlockTask::waitDependencies()
 {
+    // dependencies release this task from their continuations when their results have been published,
+    // as Module retires tasks in order of submission, this does not block
     std::unique_lock<std::mutex> guard(m_mutex);
-    for (auto it = m_dependencies.begin(); it != m_dependencies.end(); ++it) {
-        auto &d = *it;
-        d->wait();
-    }
-
+    m_cond.wait(guard, [this]() { return m_pendingDependencies == 0; });
     m_dependencies.clear();
 
     return true;
@@ -27,6 +27,8 @@
 #include <deque>
 #include <mutex>
 #include <future>
+#include <condition_variable>
+#include <functional>
 #include <memory>
 
 #include <vistle/core/paramvector.h>
@@ -59,6 +61,7 @@ namespace mpi = ::boost::mpi;
 namespace vistle {
 
 class StateTracker;
+class ThreadPool;
 struct HubData;
 class Module;
 class Renderer;
@@ -77,7 +80,7 @@ class RemoveParameter;
 class MessageQueue;
 } // namespace message
 
-class V_MODULEEXPORT BlockTask {
+class V_MODULEEXPORT BlockTask: public std::enable_shared_from_this<BlockTask> {
     friend class Module;
 
 public:
@@ -100,10 +103,14 @@ public:
 
 protected:
     void addDependency(std::shared_ptr<BlockTask> dep);
+    //! run continuation after results of this task have been published, or immediately if this has already happened
+    void then(std::function<void()> continuation);
 
     void addAllObjects();
 
-    bool wait();
+    void run(); //< execute Module::compute(task) on calling thread
+    bool isFinished();
+    bool wait(); //< wait for completion of this task and publish its results
     bool waitDependencies();
 
     Module *m_module = nullptr;
@@ -114,7 +121,12 @@ protected:
     std::map<Port *, std::deque<Object::ptr>> m_objects;
 
     std::mutex m_mutex;
-    std::shared_future<bool> m_future;
+    std::condition_variable m_cond;
+    bool m_finished = false, m_retired = false;
+    bool m_result = false;
+    std::exception_ptr m_exception;
+    unsigned m_pendingDependencies = 0;
+    std::vector<std::function<void()>> m_continuations;
 };
 
 class V_MODULEEXPORT Module: public ParameterManager, public MessageSender {
@@ -338,6 +350,8 @@ protected:
     void enableResultCaches(bool on);
 
 private:
+    //! send spans recorded by PipelineTracer to hub
+    void publishPipelineTrace();
     std::shared_ptr<StateTracker> m_stateTracker;
     int m_receivePolicy;
     int m_schedulingPolicy;
@@ -395,6 +409,9 @@ private:
     //maximum number of parallel threads per rank
     IntParameter *m_concurrency = nullptr;
     void waitAllTasks();
+    void retireTasks(size_t maxInFlight); //< publish results of finished tasks, block while more than maxInFlight remain
+    ThreadPool &threadPool();
+    std::unique_ptr<ThreadPool> m_threadPool;
     std::shared_ptr<BlockTask> m_lastTask;
     std::deque<std::shared_ptr<BlockTask>> m_tasks;
 
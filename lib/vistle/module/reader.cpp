@@ -1,5 +1,6 @@
 #include "reader.h"
 #include <vistle/util/threadname.h>
+#include <vistle/util/threadpool.h>
 
 namespace vistle {
 
@@ -25,7 +26,9 @@ Reader::Reader(const std::string &name, const int moduleID, mpi::communicator co
 }
 
 Reader::~Reader()
-{}
+{
+    finishPrefetches();
+}
 
 Parameter *Reader::addParameterGeneric(const std::string &name, std::shared_ptr<Parameter> parameter)
 {
@@ -49,6 +52,9 @@ bool Reader::removeParameter(const std::string &name)
 
 void Reader::prepareQuit()
 {
+    finishPrefetches();
+    m_ioPool.reset();
+    m_readPool.reset();
     m_observedParameters.clear();
     Module::prepareQuit();
 }
@@ -87,6 +93,72 @@ int Reader::numPartitions() const
     return m_numPartitions;
 }
 
+bool Reader::prefetch(int timestep, int block)
+{
+    return true;
+}
+
+void Reader::schedulePrefetch(const ReaderProperties &prop, int timestep, int step)
+{
+    if (!m_ioPool)
+        return;
+
+    bool partitioned = m_handlePartitions == Partition || (timestep >= 0 && m_handlePartitions == PartitionTimesteps);
+    std::lock_guard<std::mutex> guard(m_prefetchMutex);
+    for (int p = -1; p < prop.numpart; ++p) {
+        if (partitioned && comm().rank() != rankForTimestepAndPartition(step, p))
+            continue;
+        auto key = std::make_pair(timestep, p);
+        if (m_prefetches.find(key) != m_prefetches.end())
+            continue;
+        m_prefetches[key] = m_ioPool->submit([this, timestep, p]() { return prefetch(timestep, p); }).share();
+    }
+}
+
+bool Reader::waitForPrefetch(int timestep, int block)
+{
+    std::shared_future<bool> future;
+    {
+        std::lock_guard<std::mutex> guard(m_prefetchMutex);
+        auto it = m_prefetches.find(std::make_pair(timestep, block));
+        if (it == m_prefetches.end()) {
+            // not scheduled ahead of time
+            return prefetch(timestep, block);
+        }
+        future = it->second;
+        m_prefetches.erase(it);
+    }
+
+    try {
+        return future.get();
+    } catch (std::exception &ex) {
+        std::cerr << "Reader: prefetching t=" << timestep << ", b=" << block << " failed: " << ex.what() << std::endl;
+    }
+    return false;
+}
+
+void Reader::finishPrefetches()
+{
+    std::map<std::pair<int, int>, std::shared_future<bool>> prefetches;
+    {
+        std::lock_guard<std::mutex> guard(m_prefetchMutex);
+        std::swap(prefetches, m_prefetches);
+    }
+    for (auto &p: prefetches) {
+        if (p.second.valid())
+            p.second.wait();
+    }
+}
+
+bool Reader::readPrefetched(Token &token, int timestep, int block)
+{
+    if (!waitForPrefetch(timestep, block)) {
+        sendInfo("error prefetching time data %d on partition %d", timestep, block);
+        return false;
+    }
+    return read(token, timestep, block);
+}
+
 size_t Reader::waitForReaders(size_t maxRunning, bool &result)
 {
     while (m_tokens.size() > maxRunning) {
@@ -142,7 +214,7 @@ bool Reader::readTimestep(std::shared_ptr<Token> &prev, const ReaderProperties &
                 }
             }
             if (m_parallel == Serial) {
-                if (!read(*token, timestep, p)) {
+                if (!readPrefetched(*token, timestep, p)) {
                     sendInfo("error reading time data %d on partition %d", timestep, p);
                     result = false;
                     break;
@@ -156,14 +228,16 @@ bool Reader::readTimestep(std::shared_ptr<Token> &prev, const ReaderProperties &
                 m_tokens.emplace_back(token);
                 prev = token;
                 auto tname = std::to_string(id()) + "r" + std::to_string(m_tokenCount) + ":" + name();
-                token->m_future = std::async(std::launch::async, [this, tname, token, timestep, p]() {
-                    setThreadName(tname);
-                    if (!read(*token, timestep, p)) {
-                        sendInfo("error reading time data %d on partition %d", timestep, p);
-                        return false;
-                    }
-                    return true;
-                });
+                token->m_future = m_readPool
+                                      ->submit([this, tname, token, timestep, p]() {
+                                          setThreadName(tname);
+                                          if (!readPrefetched(*token, timestep, p)) {
+                                              sendInfo("error reading time data %d on partition %d", timestep, p);
+                                              return false;
+                                          }
+                                          return true;
+                                      })
+                                      .share();
             }
         }
         if (cancelRequested()) {
@@ -200,8 +274,17 @@ bool Reader::readTimesteps(std::shared_ptr<Token> &prev, const ReaderProperties
     bool result = true;
     if (prop.time.inc() != 0) {
         int step = 0;
-        for (int t = prop.time.first(); prop.time.inc() < 0 ? t >= prop.time.last() : t <= prop.time.last();
-             t += prop.time.inc()) {
+        int readAhead = m_ioPool ? m_readAhead->getValue() : 0;
+        auto inRange = [&prop](int t) {
+            return prop.time.inc() < 0 ? t >= prop.time.last() : t <= prop.time.last();
+        };
+        for (int t = prop.time.first(); inRange(t); t += prop.time.inc()) {
+            for (int ahead = 0; ahead <= readAhead; ++ahead) {
+                int tt = t + ahead * prop.time.inc();
+                if (!inRange(tt))
+                    break;
+                schedulePrefetch(prop, tt, step + ahead);
+            }
             if (!readTimestep(prev, prop, t, step)) {
                 result = false;
                 break;
@@ -262,6 +345,21 @@ bool Reader::prepare()
         concurrency = 1;
     assert(concurrency >= 1);
 
+    // tokens block while waiting for their predecessors, so every token in flight requires its own thread
+    if (m_parallel != Serial && (!m_readPool || m_readPool->size() != unsigned(concurrency))) {
+        m_readPool.reset();
+        m_readPool = std::make_unique<ThreadPool>(concurrency, std::to_string(id()) + "r");
+    }
+    if (m_readAhead && m_readAhead->getValue() > 0) {
+        unsigned ioThreads = m_ioThreads->getValue();
+        if (!m_ioPool || m_ioPool->size() != ioThreads) {
+            m_ioPool.reset();
+            m_ioPool = std::make_unique<ThreadPool>(ioThreads, std::to_string(id()) + "io");
+        }
+    } else {
+        m_ioPool.reset();
+    }
+
     if (rank() == 0) {
         if (concurrency > 1) {
             sendInfo("reading %d timesteps with up to %d partitions, %d in parallel", numtime, numpart, concurrency);
@@ -277,6 +375,12 @@ bool Reader::prepare()
     if (m_handlePartitions == PartitionTimesteps) {
         prop.numpart = 0;
     }
+    if (rTime.inc() != 0 && numtime > 0) {
+        // overlap loading of first timestep with reading constant data
+        ReaderProperties tprop(prop);
+        tprop.numpart = numpart;
+        schedulePrefetch(tprop, rTime.first(), 0);
+    }
     if (!readTimestep(prev, prop, -1, -1)) {
         sendError("error reading constant data");
         prev.reset();
@@ -296,6 +400,8 @@ bool Reader::prepare()
         }
     }
 
+    finishPrefetches();
+
     //finish read
     if (!finishRead()) {
         sendError("error finishing read");
@@ -375,6 +481,27 @@ void Reader::setAllowTimestepDistribution(bool allow)
     }
 }
 
+void Reader::setReadAhead(int timesteps)
+{
+    if (timesteps > 0) {
+        if (!m_readAhead) {
+            setCurrentParameterGroup("Reader");
+            m_readAhead = addIntParameter("read_ahead", "number of timesteps to prefetch ahead of reading", timesteps);
+            setParameterRange(m_readAhead, Integer(0), Integer(64));
+            m_ioThreads = addIntParameter("io_threads", "number of threads for prefetching data", 2);
+            setParameterRange(m_ioThreads, Integer(1), Integer(64));
+            setCurrentParameterGroup();
+        }
+    } else {
+        if (m_readAhead)
+            removeParameter(m_readAhead->getName());
+        m_readAhead = nullptr;
+        if (m_ioThreads)
+            removeParameter(m_ioThreads->getName());
+        m_ioThreads = nullptr;
+    }
+}
+
 void Reader::observeParameter(const Parameter *param)
 {
     m_observedParameters.insert(param);
@@ -3,6 +3,7 @@
 
 #include "module.h"
 #include <set>
+#include <map>
 #include <future>
 
 namespace vistle {
@@ -18,7 +19,12 @@ namespace vistle {
  - prepareRead @ref Reader::prepareRead
  - read @ref Reader::read
  - finishRead @ref Reader::finishRead
+
+ Optionally, reimplement @ref Reader::prefetch for loading data from disk ahead of @ref Reader::read
+ and enable reading ahead with @ref Reader::setReadAhead.
  */
+class ThreadPool;
+
 class V_MODULEEXPORT Reader: public Module {
     friend class Token;
 
@@ -87,6 +93,14 @@ public:
     */
     virtual bool read(Token &token, int timestep = -1, int block = -1) = 0;
 
+    /// called ahead of read for the same timestep and block, e.g. for loading file contents into memory
+    /** Called on a separate I/O thread for up to 'read_ahead' timesteps ahead of the timestep currently being read,
+    *  if enabled with @ref setReadAhead, otherwise on the reading thread right before @ref read.
+    *  @ref read for the same timestep and block will only be called after prefetch has returned.
+    *  Invocations are not collective, so do not communicate.
+    */
+    virtual bool prefetch(int timestep = -1, int block = -1);
+
     /* virtual bool readDIYBlock(Token &token, int timestep = -1); */
     /// called once on every rank after execution of the module has been initiated before read is called
     virtual bool prepareRead();
@@ -149,6 +163,8 @@ protected:
     void setHandlePartitions(PartitionHandling part);
     /// whether timesteps may be distributed to different ranks
     void setAllowTimestepDistribution(bool allow);
+    //! call from constructor if @ref prefetch is reimplemented, timesteps is the default for parameter read_ahead
+    void setReadAhead(int timesteps = 1);
     //! whenever an observed parameter changes, data set should be rescanned
     void observeParameter(const Parameter *param);
     //! call during @ref examine to inform module how many timesteps are present whithin dataset
@@ -181,6 +197,7 @@ private:
 
     bool readTimestep(std::shared_ptr<Token> &prev, const ReaderProperties &prop, int timestep, int step);
     bool readTimesteps(std::shared_ptr<Token> &prev, const ReaderProperties &prop);
+    bool readPrefetched(Token &token, int timestep, int block);
     bool prepare() override;
     bool compute() override;
 
@@ -189,6 +206,16 @@ private:
     std::deque<std::shared_ptr<Token>> m_tokens;
     size_t waitForReaders(size_t maxRunning, bool &result);
 
+    IntParameter *m_readAhead = nullptr;
+    IntParameter *m_ioThreads = nullptr;
+    std::unique_ptr<ThreadPool> m_readPool; // executes read calls, one thread per token in flight
+    std::unique_ptr<ThreadPool> m_ioPool; // executes prefetch calls
+    std::mutex m_prefetchMutex;
+    std::map<std::pair<int, int>, std::shared_future<bool>> m_prefetches; // (timestep, block) -> result
+    void schedulePrefetch(const ReaderProperties &prop, int timestep, int step);
+    bool waitForPrefetch(int timestep, int block);
+    void finishPrefetches();
+
     std::set<const Parameter *> m_observedParameters;
 
     std::vector<int> m_minDomain;
@@ -3,10 +3,23 @@
 
 namespace vistle {
 
+ResultCacheBase::ResultCacheBase(Lifetime lifetime): m_lifetime(lifetime)
+{}
+
 ResultCacheBase::~ResultCacheBase() = default;
 
 void ResultCacheBase::enable(bool on)
 {
     m_enabled = on;
 }
+
+bool ResultCacheBase::enabled() const
+{
+    return m_enabled;
+}
+
+ResultCacheBase::Lifetime ResultCacheBase::lifetime() const
+{
+    return m_lifetime;
+}
 } // namespace vistle
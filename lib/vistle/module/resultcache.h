@@ -12,12 +12,22 @@ namespace vistle {
 
 class V_MODULEEXPORT ResultCacheBase {
 public:
+    //! how long stored values are retained
+    enum Lifetime {
+        Execution, //< values are discarded after each execution
+        Persistent, //< values that have been used during an execution are carried over into the next one
+    };
+
+    explicit ResultCacheBase(Lifetime lifetime = Execution);
     virtual ~ResultCacheBase();
     virtual void clear() = 0;
     virtual void enable(bool on);
+    bool enabled() const;
+    Lifetime lifetime() const;
 
 protected:
     bool m_enabled = true;
+    Lifetime m_lifetime = Execution;
 };
 
 //! data structure for retaining data that can be reused between timesteps
@@ -33,12 +43,15 @@ public:
         Result data;
     };
 
+    explicit ResultCache(Lifetime lifetime = Execution): ResultCacheBase(lifetime) {}
+
     //! if available, retrieve value for key, store to result, and return nullptr;
     //! otherwise the entry corresponding to key is locked and has to be updated with storeAndUnlock via the returned Entry
     Entry *getOrLock(const std::string &key, Result &result);
     //! update value stored for entry with data and unlock it
     bool storeAndUnlock(Entry *entry, const Result &data);
-    //! discard all currently stored values
+    //! discard all currently stored values,
+    //! for Persistent caches, values are only discarded if they have not been retrieved since the previous call
     void clear() override;
 
 protected:
@@ -34,9 +34,37 @@ typename ResultCache<Result>::Entry *ResultCache<Result>::getOrLock(const std::s
     auto it = cache.find(key);
     if (it == cache.end()) {
         auto &ent = cache[key];
-        ent.generation = m_generation;
+        auto generation = m_generation;
+        ent.generation = generation;
         ent.mutex.lock();
-        modifyBorrowCount(m_generation, 1);
+        modifyBorrowCount(generation, 1);
+
+        if (m_lifetime == Persistent) {
+            // carry over value from a previous generation, if still available
+            for (size_t gen = m_cache.size() - 1; gen > 0; --gen) {
+                auto &old = m_cache[gen - 1];
+                auto oit = old.find(key);
+                if (oit == old.end())
+                    continue;
+
+                auto &oldEnt = oit->second;
+                auto oldGeneration = oldEnt.generation;
+                modifyBorrowCount(oldGeneration, 1);
+                guard.unlock();
+
+                std::unique_lock<std::mutex> old_guard(oldEnt.mutex);
+                result = oldEnt.data;
+                old_guard.unlock();
+                ent.data = result;
+                ent.mutex.unlock();
+
+                guard.lock();
+                modifyBorrowCount(oldGeneration, -1);
+                modifyBorrowCount(generation, -1);
+                return nullptr;
+            }
+        }
+
         return &ent;
     }
 
@@ -76,6 +104,10 @@ template<class Result>
 void ResultCache<Result>::clear()
 {
     std::unique_lock<std::mutex> guard(m_mutex);
+    if (m_lifetime == Persistent && !m_cache.empty() && m_cache.back().empty()) {
+        // nothing has been stored or retrieved since last call
+        return;
+    }
     if (!m_cache.empty()) {
         ++m_generation;
         m_cache.emplace_back();
@@ -87,7 +119,8 @@ void ResultCache<Result>::clear()
 template<class Result>
 void ResultCache<Result>::purgeOldGenerations()
 {
-    while (m_borrowCount.size() > 1) {
+    const size_t keep = m_lifetime == Persistent ? 2 : 1;
+    while (m_borrowCount.size() > keep) {
         if (m_borrowCount.front() > 0)
             break;
         ++m_purgedGenerations;
@@ -485,6 +485,8 @@ void DataProxy::msgForward(std::shared_ptr<tcp_socket> sock, EndPointType type)
             }
             case REQUESTOBJECT: {
                 forward = true;
+                // names of arrays requested at once
+                needPayload = msg->as<const RequestObject>().numArrays() > 0;
                 break;
             }
             case ADDOBJECTCOMPLETED: {
@@ -34,6 +34,7 @@
 
 #include <vistle/core/statetracker.h>
 #include <vistle/core/porttracker.h>
+#include <vistle/core/scalars.h>
 
 namespace py = pybind11;
 namespace asio = boost::asio;
@@ -449,6 +450,115 @@ static std::vector<int> getBusy()
     return state().getBusyList();
 }
 
+static py::list getShmUsage()
+{
+    std::unique_lock<PythonStateAccessor> guard(access());
+#ifdef DEBUG
+    std::cerr << "Python: getShmUsage " << std::endl;
+#endif
+    auto toDict = [](const ShmUsageEntry &entry) {
+        py::dict d;
+        d["bytes"] = entry.bytes;
+        d["highWater"] = entry.highWater;
+        d["count"] = entry.count;
+        return d;
+    };
+
+    py::list result;
+    for (const auto &hub: state().shmUsage()) {
+        for (const auto &rank: hub.second) {
+            const auto &usage = rank.second;
+            py::dict d;
+            d["hub"] = hub.first;
+            d["rank"] = usage.rank;
+            d["time"] = usage.time;
+            d["segmentSize"] = usage.segmentSize;
+            d["segmentFree"] = usage.segmentFree;
+            d["bytes"] = usage.bytes;
+            d["highWater"] = usage.highWater;
+            d["cachedBytes"] = usage.cachedBytes;
+            d["numAllocations"] = usage.numAllocations;
+            d["allocatedBytes"] = usage.allocatedBytes;
+            d["allocationRate"] = usage.allocationRate;
+            d["fragmentation"] = usage.fragmentation();
+            py::dict modules, objectTypes, arrayTypes;
+            for (const auto &e: usage.modules)
+                modules[py::int_(e.key)] = toDict(e);
+            for (const auto &e: usage.objectTypes)
+                objectTypes[Object::toString(Object::Type(e.key))] = toDict(e);
+            for (const auto &e: usage.arrayTypes) {
+                if (e.key >= 0 && size_t(e.key) < ScalarTypeNames.size())
+                    arrayTypes[ScalarTypeNames[e.key]] = toDict(e);
+                else
+                    arrayTypes[py::int_(e.key)] = toDict(e);
+            }
+            d["modules"] = modules;
+            d["objectTypes"] = objectTypes;
+            d["arrayTypes"] = arrayTypes;
+            result.append(d);
+        }
+    }
+    return result;
+}
+
+static bool writeChromeTrace(const std::string &filename)
+{
+    std::unique_lock<PythonStateAccessor> guard(access());
+#ifdef DEBUG
+    std::cerr << "Python: writeChromeTrace(" << filename << ")" << std::endl;
+#endif
+    auto spans = state().pipelineTrace();
+    std::map<int, std::string> names;
+    for (const auto &span: spans) {
+        if (names.find(span.module) == names.end()) {
+            auto name = state().getModuleName(span.module);
+            if (!name.empty())
+                names[span.module] = name;
+        }
+    }
+    guard.unlock();
+
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << "Python: writeChromeTrace: could not open " << filename << std::endl;
+        return false;
+    }
+    out << toChromeTrace(spans, names);
+    return bool(out);
+}
+
+static py::list getCriticalPath()
+{
+    std::unique_lock<PythonStateAccessor> guard(access());
+#ifdef DEBUG
+    std::cerr << "Python: getCriticalPath " << std::endl;
+#endif
+    py::list result;
+    for (const auto &step: state().pipelineCriticalPath()) {
+        py::dict d;
+        d["module"] = step.module;
+        d["name"] = state().getModuleName(step.module);
+        d["hub"] = step.hub;
+        d["rank"] = step.rank;
+        d["begin"] = step.begin;
+        d["end"] = step.end;
+        d["busy"] = step.busy;
+        d["waiting"] = step.waiting;
+        d["transfer"] = step.transfer;
+        result.append(d);
+    }
+    return result;
+}
+
+static void clearPipelineTrace()
+{
+    std::unique_lock<PythonStateAccessor> guard(access());
+#ifdef DEBUG
+    std::cerr << "Python: clearPipelineTrace " << std::endl;
+#endif
+    state().clearPipelineTrace();
+}
+
 static std::vector<std::string> getInputPorts(int id)
 {
     std::unique_lock<PythonStateAccessor> guard(access());
@@ -1542,6 +1652,14 @@ PY_MODULE(_vistle, m)
     m.def("getRunning", getRunning, "get list of IDs of running modules");
     m.def("findFirstModule", findFirstModule, "find the first instance of a module and return its id", "moduleName"_a);
     m.def("getBusy", getBusy, "get list of IDs of busy modules");
+    m.def("getShmUsage", getShmUsage,
+          "get most recent shared memory usage report of every rank (set VISTLE_SHM_USAGE_INTERVAL to adjust period)");
+    m.def("writeChromeTrace", writeChromeTrace,
+          "write pipeline trace collected while session parameter trace_pipeline is set in Chrome/Perfetto format",
+          "filename"_a);
+    m.def("getCriticalPath", getCriticalPath,
+          "get modules and ranks that determined the duration of the most recent traced pipeline execution");
+    m.def("clearPipelineTrace", clearPipelineTrace, "discard pipeline trace collected so far");
     m.def("getModuleName", getModuleName, "get name of module with ID `arg1`");
     m.def("getModuleDescription", getModuleDescription, "get description of module with ID `arg1`");
     m.def("getInputPorts", getInputPorts, "get name of input ports of module with ID `arg1`");
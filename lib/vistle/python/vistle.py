@@ -67,6 +67,26 @@ def showBusy():
       name = _vistle.getModuleName(id)
       print("%s\t%s" % (id, name))
 
+def showShmUsage():
+   print("hub\trank\tbytes\thigh water\tsegment\tfree\tfragmentation\talloc rate [B/s]")
+   for u in _vistle.getShmUsage():
+      print("%s\t%s\t%s\t%s\t%s\t%s\t%.3f\t%.0f" % (u['hub'], u['rank'], u['bytes'], u['highWater'],
+         u['segmentSize'], u['segmentFree'], u['fragmentation'], u['allocationRate']))
+      for id, m in sorted(u['modules'].items()):
+         name = _vistle.getModuleName(id) if id >= 1 else "manager"
+         print("\tmodule %s %s: %s bytes (high water %s)" % (id, name, m['bytes'], m['highWater']))
+
+def showCriticalPath():
+   path = _vistle.getCriticalPath()
+   if not path:
+      print("no pipeline trace, set session parameter trace_pipeline and execute")
+      return
+   start = path[0]['begin']
+   print("module\thub\trank\tstart [s]\tend [s]\tbusy [s]\twaiting [s]\ttransfer [s]")
+   for s in path:
+      print("%s_%s\t%s\t%s\t%.3f\t%.3f\t%.3f\t%.3f\t%.3f" % (s['name'], s['module'], s['hub'], s['rank'],
+         s['begin'] - start, s['end'] - start, s['busy'], s['waiting'], s['transfer']))
+
 def showInputPorts(id):
    ports = _vistle.getInputPorts(id)
    for p in ports:
@@ -415,6 +435,10 @@ applyParameters = _vistle.applyParameters
 getAvailable = _vistle.getAvailable
 getRunning = _vistle.getRunning
 getBusy = _vistle.getBusy
+getShmUsage = _vistle.getShmUsage
+writeChromeTrace = _vistle.writeChromeTrace
+getCriticalPath = _vistle.getCriticalPath
+clearPipelineTrace = _vistle.clearPipelineTrace
 getModuleName = _vistle.getModuleName
 getModuleDescription = _vistle.getModuleDescription
 hubName = _vistle.hubName
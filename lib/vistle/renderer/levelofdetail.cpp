@@ -0,0 +1,254 @@
+#include <vistle/core/triangles.h>
+#include <vistle/core/quads.h>
+#include <vistle/core/polygons.h>
+#include <vistle/core/lines.h>
+#include <vistle/core/texture1d.h>
+#include <vistle/core/vec.h>
+#include <vistle/core/vector.h>
+
+#include "levelofdetail.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace vistle {
+
+namespace {
+
+// only worth rendering instead of the original if at most this fraction of primitives remains
+const double MaxRemainingFraction = 0.5;
+
+class VertexClustering {
+public:
+    VertexClustering(Coords::const_ptr coords, Index resolution)
+    : m_x(coords->x().data()), m_y(coords->y().data()), m_z(coords->z().data())
+    {
+        auto bounds = coords->getBounds();
+        m_min = bounds.first;
+        Vector3 extent = bounds.second - bounds.first;
+        Scalar maxExtent = std::max(extent[0], std::max(extent[1], extent[2]));
+        if (maxExtent > 0 && resolution > 0)
+            m_cellSize = maxExtent / resolution;
+        for (int c = 0; c < 3; ++c)
+            m_dims[c] = std::max(extent[c], Scalar(0)) / m_cellSize + 1;
+        m_cluster.resize(coords->getNumVertices(), InvalidIndex);
+    }
+
+    //! index of cluster containing vertex v
+    Index operator()(Index v)
+    {
+        Index &cl = m_cluster[v];
+        if (cl != InvalidIndex)
+            return cl;
+
+        Vector3 p(m_x[v], m_y[v], m_z[v]);
+        uint64_t cell = 0;
+        for (int c = 2; c >= 0; --c) {
+            uint64_t i = std::min(uint64_t(std::max((p[c] - m_min[c]) / m_cellSize, Scalar(0))), m_dims[c] - 1);
+            cell = cell * m_dims[c] + i;
+        }
+        auto it = m_cells.emplace(cell, Index(m_representative.size())).first;
+        cl = it->second;
+        if (cl == m_representative.size()) {
+            m_representative.push_back(v);
+            m_sum.emplace_back(Vector3::Zero());
+            m_count.push_back(0);
+        }
+        m_sum[cl] += p;
+        ++m_count[cl];
+        return cl;
+    }
+
+    Index numClusters() const { return m_representative.size(); }
+    const std::vector<Index> &representatives() const { return m_representative; }
+
+    void fillCoords(Coords::ptr coords) const
+    {
+        auto x = coords->x().data(), y = coords->y().data(), z = coords->z().data();
+        for (Index i = 0; i < numClusters(); ++i) {
+            Vector3 p = m_sum[i] / m_count[i];
+            x[i] = p[0];
+            y[i] = p[1];
+            z[i] = p[2];
+        }
+    }
+
+private:
+    const Scalar *m_x, *m_y, *m_z;
+    Vector3 m_min;
+    Scalar m_cellSize = 1;
+    uint64_t m_dims[3];
+    std::vector<Index> m_cluster;
+    std::unordered_map<uint64_t, Index> m_cells;
+    std::vector<Index> m_representative;
+    std::vector<Vector3> m_sum;
+    std::vector<Index> m_count;
+};
+
+// call emit(elem, v0, v1, v2) for all non-ghost triangles after splitting quads and polygons
+template<class Emit>
+bool forEachTriangle(Object::const_ptr geometry, Emit emit)
+{
+    if (auto tri = Triangles::as(geometry)) {
+        const Index *cl = tri->getNumCorners() > 0 ? tri->cl().data() : nullptr;
+        for (Index e = 0; e < tri->getNumElements(); ++e) {
+            if (tri->isGhost(e))
+                continue;
+            const Index b = e * 3;
+            if (cl)
+                emit(e, cl[b], cl[b + 1], cl[b + 2]);
+            else
+                emit(e, b, b + 1, b + 2);
+        }
+        return true;
+    }
+    if (auto quads = Quads::as(geometry)) {
+        const Index *cl = quads->getNumCorners() > 0 ? quads->cl().data() : nullptr;
+        for (Index e = 0; e < quads->getNumElements(); ++e) {
+            if (quads->isGhost(e))
+                continue;
+            const Index b = e * 4;
+            Index v[4] = {b, b + 1, b + 2, b + 3};
+            if (cl)
+                std::transform(v, v + 4, v, [cl](Index i) { return cl[i]; });
+            emit(e, v[0], v[1], v[2]);
+            emit(e, v[0], v[2], v[3]);
+        }
+        return true;
+    }
+    if (auto poly = Polygons::as(geometry)) {
+        const Index *el = poly->el().data();
+        const Index *cl = poly->cl().data();
+        for (Index e = 0; e < poly->getNumElements(); ++e) {
+            if (poly->isGhost(e))
+                continue;
+            for (Index c = el[e] + 2; c < el[e + 1]; ++c)
+                emit(e, cl[el[e]], cl[c - 1], cl[c]);
+        }
+        return true;
+    }
+    return false;
+}
+
+// representative values for vertex data, original values for element data
+DataBase::ptr reduceData(DataBase::const_ptr data, Object::const_ptr grid, DataBase::Mapping mapping,
+                         const std::vector<Index> &source)
+{
+    auto reduced = DataBase::as(data->cloneType());
+    if (!reduced)
+        return reduced;
+    reduced->setSize(source.size());
+    for (Index i = 0; i < source.size(); ++i) {
+        if (!reduced->copyEntry(i, data, source[i]))
+            return DataBase::ptr();
+    }
+    if (auto tex = Texture1D::as(data)) {
+        auto rtex = Texture1D::as(Object::ptr(reduced));
+        rtex->d()->range[0] = tex->getMin();
+        rtex->d()->range[1] = tex->getMax();
+        rtex->d()->pixels = tex->d()->pixels;
+    }
+    reduced->setMeta(data->meta());
+    reduced->copyAttributes(data);
+    reduced->setMapping(mapping);
+    reduced->setGrid(grid);
+    return reduced;
+}
+
+} // namespace
+
+Index numSimplifiablePrimitives(Object::const_ptr geometry)
+{
+    if (auto tri = Triangles::as(geometry))
+        return tri->getNumElements();
+    if (auto quads = Quads::as(geometry))
+        return 2 * quads->getNumElements();
+    if (auto poly = Polygons::as(geometry))
+        return poly->getNumCorners() - 2 * poly->getNumElements();
+    if (auto lines = Lines::as(geometry))
+        return lines->getNumCorners() - lines->getNumElements();
+    return 0;
+}
+
+LevelOfDetail simplifyByVertexClustering(Object::const_ptr geometry, Object::const_ptr mapdata, Index resolution)
+{
+    LevelOfDetail lod;
+    auto coords = Coords::as(geometry);
+    const Index numPrimitives = numSimplifiablePrimitives(geometry);
+    if (!coords || numPrimitives == 0)
+        return lod;
+
+    auto data = DataBase::as(mapdata);
+    auto mapping = data ? data->guessMapping(geometry) : DataBase::Unspecified;
+    if (mapping != DataBase::Vertex && mapping != DataBase::Element)
+        data.reset();
+
+    VertexClustering cluster(coords, resolution);
+    std::vector<Index> elements; // original element for each remaining primitive
+
+    Coords::ptr reduced;
+    if (auto lines = Lines::as(geometry)) {
+        const Index *el = lines->el().data();
+        const Index *cl = lines->getNumCorners() > 0 ? lines->cl().data() : nullptr;
+        std::vector<Index> rel(1, 0), rcl;
+        for (Index e = 0; e < lines->getNumElements(); ++e) {
+            const Index begin = rcl.size();
+            for (Index c = el[e]; c < el[e + 1]; ++c) {
+                Index v = cluster(cl ? cl[c] : c);
+                if (rcl.size() == begin || rcl.back() != v)
+                    rcl.push_back(v);
+            }
+            if (rcl.size() - begin < 2) {
+                rcl.resize(begin);
+                continue;
+            }
+            rel.push_back(rcl.size());
+            elements.push_back(e);
+        }
+        if (rcl.size() - elements.size() > numPrimitives * MaxRemainingFraction)
+            return lod;
+
+        Lines::ptr rlines(new Lines(elements.size(), rcl.size(), cluster.numClusters()));
+        std::copy(rel.begin(), rel.end(), rlines->el().begin());
+        std::copy(rcl.begin(), rcl.end(), rlines->cl().begin());
+        rlines->setCapStyles(lines->startStyle(), lines->jointStyle(), lines->endStyle());
+        if (auto radius = lines->radius()) {
+            auto rradius = reduceData(radius, rlines, DataBase::Vertex, cluster.representatives());
+            rlines->setRadius(Vec<Scalar>::as(Object::const_ptr(rradius)));
+        }
+        reduced = rlines;
+    } else {
+        std::vector<Index> rcl;
+        forEachTriangle(geometry, [&cluster, &rcl, &elements](Index e, Index v0, Index v1, Index v2) {
+            Index c0 = cluster(v0), c1 = cluster(v1), c2 = cluster(v2);
+            if (c0 == c1 || c1 == c2 || c2 == c0)
+                return;
+            rcl.push_back(c0);
+            rcl.push_back(c1);
+            rcl.push_back(c2);
+            elements.push_back(e);
+        });
+        if (elements.size() > numPrimitives * MaxRemainingFraction)
+            return lod;
+
+        Triangles::ptr tri(new Triangles(rcl.size(), cluster.numClusters()));
+        std::copy(rcl.begin(), rcl.end(), tri->cl().begin());
+        reduced = tri;
+    }
+
+    cluster.fillCoords(reduced);
+    reduced->setMeta(geometry->meta());
+    reduced->copyAttributes(geometry);
+    lod.geometry = reduced;
+
+    if (data) {
+        lod.mapdata =
+            reduceData(data, reduced, mapping, mapping == DataBase::Vertex ? cluster.representatives() : elements);
+    }
+
+    return lod;
+}
+
+} // namespace vistle
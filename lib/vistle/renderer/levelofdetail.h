@@ -0,0 +1,28 @@
+#ifndef VISTLE_RENDERER_LEVELOFDETAIL_H
+#define VISTLE_RENDERER_LEVELOFDETAIL_H
+
+#include <vistle/core/object.h>
+#include <vistle/core/index.h>
+
+#include "export.h"
+
+namespace vistle {
+
+//! simplified representation of a geometry object together with its mapped data
+struct LevelOfDetail {
+    Object::const_ptr geometry;
+    Object::const_ptr mapdata;
+};
+
+//! reduce Triangles, Quads and Polygons to Triangles and Lines to Lines by merging all vertices within cells of a
+//! regular grid with resolution cells along the longest edge of the bounding box
+/*! vertex-mapped data is taken from one vertex of each cell, element-mapped data from the original elements,
+    normals are not retained - returns empty geometry if unsupported or if the reduction would not pay off */
+V_RENDEREREXPORT LevelOfDetail simplifyByVertexClustering(Object::const_ptr geometry, Object::const_ptr mapdata,
+                                                         Index resolution);
+
+//! number of primitives that would be considered by simplifyByVertexClustering, 0 if unsupported
+V_RENDEREREXPORT Index numSimplifiablePrimitives(Object::const_ptr geometry);
+
+} // namespace vistle
+#endif
@@ -1,9 +1,13 @@
 #include "parrendmgr.h"
 #include "renderobject.h"
 #include "renderer.h"
+#include <vistle/util/stopwatch.h>
+#include <vistle/util/enum.h>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/map.hpp>
+#include <cmath>
+#include <limits>
 
 #ifdef VISTLE_USE_MPI
 #include <IceT.h>
@@ -46,6 +50,8 @@ inline void serialize(Archive &ar, vistle::Renderer::Variant &t, const unsigned
 
 namespace vistle {
 
+DEFINE_ENUM_WITH_STRING_CONVERSIONS(CompositeStrategy, (Automatic)(BinarySwap)(RadixK)(Tree))
+
 #ifdef VISTLE_USE_MPI
 namespace {
 
@@ -80,6 +86,14 @@ ParallelRemoteRenderManager::ParallelRemoteRenderManager(Renderer *module)
     m_delay = m_module->addFloatParameter("delay", "artificial delay (s)", m_delaySec);
     m_module->setParameterRange(m_delay, 0., 3.);
     m_colorRank = m_module->addIntParameter("color_rank", "different colors on each rank", 0, Parameter::Boolean);
+    m_compositeStrategy = m_module->addIntParameter("composite_strategy", "algorithm for compositing images of all ranks",
+                                                    Automatic, Parameter::Choice);
+    m_module->V_ENUM_SET_CHOICES(m_compositeStrategy, CompositeStrategy);
+    m_compositeCull = m_module->addIntParameter(
+        "composite_cull", "only composite pixels covered by screen-space bounds of local data", 1, Parameter::Boolean);
+    m_compositeInterlace = m_module->addIntParameter(
+        "composite_interlace", "interlace images for balancing compositing load of sparse images", 1,
+        Parameter::Boolean);
     m_module->setCurrentParameterGroup("");
 }
 
@@ -166,6 +180,11 @@ bool ParallelRemoteRenderManager::sceneChanged() const
     return m_sceneChanged;
 }
 
+bool ParallelRemoteRenderManager::interacting() const
+{
+    return m_state.interacting;
+}
+
 bool ParallelRemoteRenderManager::isVariantVisible(const std::string &variant) const
 {
     if (variant.empty())
@@ -346,11 +365,15 @@ bool ParallelRemoteRenderManager::prepareFrame(size_t numTimesteps)
         }
         assert(m_viewData.size() == rhr->numViews());
 
+        bool viewChanged = false;
         for (size_t i = 0; i < rhr->numViews(); ++i) {
             PerViewState &vd = m_viewData[i];
 
-            if (vd.width != rhr->width(i) || vd.height != rhr->height(i) || vd.proj != rhr->projMat(i) ||
-                vd.view != rhr->viewMat(i) || vd.model != rhr->modelMat(i)) {
+            if (vd.width != rhr->width(i) || vd.height != rhr->height(i)) {
+                m_doRender = 1;
+            }
+            if (vd.proj != rhr->projMat(i) || vd.view != rhr->viewMat(i) || vd.model != rhr->modelMat(i)) {
+                viewChanged = true;
                 m_doRender = 1;
             }
 
@@ -369,6 +392,18 @@ bool ParallelRemoteRenderManager::prepareFrame(size_t numTimesteps)
             m_updateScene = 1;
             m_updateCount = rhr->updateCount();
         }
+
+        if (m_module->rank() == rootRank()) {
+            // switch back to full detail once the view has not been changed for a while
+            const double InteractionTimeout = 0.3;
+            const double now = Clock::time();
+            if (viewChanged)
+                m_lastViewChange = now;
+            bool interacting = now - m_lastViewChange < InteractionTimeout;
+            if (interacting != m_state.interacting && m_module->levelOfDetailEnabled())
+                m_doRender = 1;
+            m_state.interacting = interacting;
+        }
     } else if (m_module->rank() == rootRank()) {
         if (!m_viewData.empty()) {
             m_viewData.clear();
@@ -504,12 +539,81 @@ void ParallelRemoteRenderManager::setCurrentView(size_t i)
         checkIceTError("after reset tiles");
     }
 
+    const int strategy = m_compositeStrategy->getValue();
+    if (icet.strategy != strategy) {
+        // IceT transfers only runs of active pixels, binary-swap and radix-k profit most from sparse images
+        switch (strategy) {
+        case BinarySwap:
+            icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_BSWAP);
+            break;
+        case RadixK:
+            icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_RADIXK);
+            break;
+        case Tree:
+            icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_TREE);
+            break;
+        default:
+            icetSingleImageStrategy(ICET_SINGLE_IMAGE_STRATEGY_AUTOMATIC);
+            break;
+        }
+        icet.strategy = strategy;
+    }
+    const int interlace = m_compositeInterlace->getValue() ? 1 : 0;
+    if (icet.interlace != interlace) {
+        if (interlace)
+            icetEnable(ICET_INTERLACE_IMAGES);
+        else
+            icetDisable(ICET_INTERLACE_IMAGES);
+        icet.interlace = interlace;
+    }
+
     icetBoundingBoxf(localBoundMin[0], localBoundMax[0], localBoundMin[1], localBoundMax[1], localBoundMin[2],
                      localBoundMax[2]);
     checkIceTError("exit setCurrentView");
 #endif
 }
 
+void ParallelRemoteRenderManager::cullViewport(int viewport[4]) const
+{
+    const auto &vd = m_viewData[m_currentView];
+
+    for (int c = 0; c < 3; ++c) {
+        if (localBoundMin[c] > localBoundMax[c]) {
+            // no local data
+            viewport[2] = viewport[3] = 0;
+            return;
+        }
+    }
+
+    const Matrix4 mvp = getProjMat(m_currentView) * getModelViewMat(m_currentView);
+    Scalar xmin = std::numeric_limits<Scalar>::max(), ymin = xmin;
+    Scalar xmax = std::numeric_limits<Scalar>::lowest(), ymax = xmax;
+    for (int i = 0; i < 8; ++i) {
+        Vector4 corner(i & 1 ? localBoundMax[0] : localBoundMin[0], i & 2 ? localBoundMax[1] : localBoundMin[1],
+                       i & 4 ? localBoundMax[2] : localBoundMin[2], 1);
+        Vector4 clip = mvp * corner;
+        if (clip[3] <= 0) {
+            // bounds extend behind viewer, projection is not bounded
+            return;
+        }
+        const Scalar x = (clip[0] / clip[3] * Scalar(0.5) + Scalar(0.5)) * vd.width;
+        const Scalar y = (clip[1] / clip[3] * Scalar(0.5) + Scalar(0.5)) * vd.height;
+        xmin = std::min(xmin, x);
+        xmax = std::max(xmax, x);
+        ymin = std::min(ymin, y);
+        ymax = std::max(ymax, y);
+    }
+
+    const int x0 = std::max(viewport[0], int(std::floor(xmin)));
+    const int y0 = std::max(viewport[1], int(std::floor(ymin)));
+    const int x1 = std::min(viewport[0] + viewport[2], int(std::ceil(xmax)) + 1);
+    const int y1 = std::min(viewport[1] + viewport[3], int(std::ceil(ymax)) + 1);
+    viewport[0] = x0;
+    viewport[1] = y0;
+    viewport[2] = std::max(0, x1 - x0);
+    viewport[3] = std::max(0, y1 - y0);
+}
+
 void ParallelRemoteRenderManager::compositeCurrentView(const unsigned char *rgba, const float *depth, const int vp[4],
                                                        int timestep, bool lastView)
 {
@@ -533,9 +637,15 @@ void ParallelRemoteRenderManager::compositeCurrentView(const unsigned char *rgba
     IceTDouble mv[16];
     toIcet(mv, MV);
 
-    IceTInt viewport[4] = {vp[0], vp[1], vp[2], vp[3]};
+    int culled[4] = {vp[0], vp[1], vp[2], vp[3]};
+    if (m_compositeCull->getValue())
+        cullViewport(culled);
+    IceTInt viewport[4] = {culled[0], culled[1], culled[2], culled[3]};
     IceTFloat bg[4] = {0., 0., 0., 0.};
+    double start = Clock::time();
     IceTImage img = icetCompositeImage(rgba, depth, viewport, proj, mv, bg);
+    if (auto rhr = m_rhrControl.server())
+        rhr->addCompositeTime(Clock::time() - start);
 #else
     IceTImage img{rgba, depth};
 #endif
@@ -50,6 +50,8 @@ public:
     void updateRect(size_t viewIdx, const int *viewport);
     void setModified();
     bool sceneChanged() const;
+    //! whether the view has been manipulated recently, consistent across ranks
+    bool interacting() const;
     bool isVariantVisible(const std::string &variant) const;
     void setLocalBounds(const Vector3 &min, const Vector3 &max);
     int rootRank() const { return m_displayRank == -1 ? 0 : m_displayRank; }
@@ -69,6 +71,9 @@ public:
     double m_delaySec;
 
     IntParameter *m_colorRank;
+    IntParameter *m_compositeStrategy;
+    IntParameter *m_compositeCull;
+    IntParameter *m_compositeInterlace;
     Vector4 m_defaultColor;
 
     Vector3 localBoundMin, localBoundMax;
@@ -80,6 +85,7 @@ public:
     int m_doRender;
     size_t m_lightsUpdateCount;
     bool m_sceneChanged = false;
+    double m_lastViewChange = 0.;
 
     struct PerViewState {
         // synchronized across all ranks
@@ -133,6 +139,7 @@ public:
     struct GlobalState {
         int timestep = -1;
         int numTimesteps = 0;
+        bool interacting = false;
         Vector3 bMin, bMax;
 
         GlobalState(): timestep(-1), numTimesteps(0) {}
@@ -142,6 +149,7 @@ public:
         {
             ar &timestep;
             ar &numTimesteps;
+            ar &interacting;
         }
     };
     struct GlobalState m_state;
@@ -158,10 +166,14 @@ public:
         bool ctxValid;
         int width, height; // dimensions of local tile
         IceTContext ctx;
+        int strategy = -1; // single image compositing strategy currently set
+        int interlace = -1; // whether image interlacing is currently enabled
 
         IceTData(): ctxValid(false), width(0), height(0) { ctx = 0; }
     };
     std::vector<IceTData> m_icet; // managed locally
+    //! restrict viewport to screen-space projection of local bounds, so that uncovered pixels are not composited
+    void cullViewport(int viewport[4]) const;
 #ifdef MODULE_THREAD
     // protect against simultaneous calls to IceT from multiple modules in same process
     static std::recursive_mutex s_icetMutex;
@@ -16,6 +16,7 @@
 #include <vistle/util/vecstreambuf.h>
 #include <vistle/util/sleep.h>
 #include <vistle/util/stopwatch.h>
+#include <vistle/util/threadpool.h>
 
 namespace mpi = boost::mpi;
 
@@ -259,6 +260,8 @@ bool Renderer::dispatch(bool block, bool *messageReceived, unsigned int minPrio)
         ++numSync;
     } while (maxNumMessages > 0 && numSync < m_numObjectsPerFrame);
 
+    finishLevelOfDetail();
+
     double start = 0.;
     if (m_benchmark) {
         comm().barrier();
@@ -354,6 +357,7 @@ bool Renderer::addInputObject(int sender, const std::string &senderPort, const s
         if (m_objectList.size() <= size_t(ro->timestep + 1))
             m_objectList.resize(ro->timestep + 2);
         m_objectList[ro->timestep + 1].push_back(ro);
+        startLevelOfDetail(ro);
     }
 
 #if 1
@@ -476,6 +480,78 @@ const Renderer::VariantMap &Renderer::variants() const
     return m_variants;
 }
 
+void Renderer::enableLevelOfDetail()
+{
+    setCurrentParameterGroup("Level of Detail", false);
+    m_lodParam = addIntParameter("level_of_detail", "render simplified geometry while view is manipulated", false,
+                                 Parameter::Boolean);
+    m_lodResolution =
+        addIntParameter("lod_resolution", "no. of cells along longest edge of grid for clustering vertices", 256);
+    setParameterRange(m_lodResolution, Integer(1), Integer(65536));
+    m_lodMinPrimitives = addIntParameter("lod_min_primitives", "only simplify objects with at least this many primitives",
+                                         100000);
+    setParameterMinimum(m_lodMinPrimitives, Integer(0));
+    setCurrentParameterGroup("");
+}
+
+bool Renderer::levelOfDetailEnabled() const
+{
+    return m_lodParam && m_lodParam->getValue();
+}
+
+std::shared_ptr<RenderObject> Renderer::addLevelOfDetail(std::shared_ptr<RenderObject> ro, Object::const_ptr geometry,
+                                                         Object::const_ptr texture)
+{
+    return nullptr;
+}
+
+void Renderer::startLevelOfDetail(std::shared_ptr<RenderObject> ro)
+{
+    if (!levelOfDetailEnabled() || ro->lod || !ro->geometry)
+        return;
+    auto numPrimitives = numSimplifiablePrimitives(ro->geometry);
+    if (numPrimitives == 0 || numPrimitives < Index(m_lodMinPrimitives->getValue()))
+        return;
+    for (const auto &task: m_lodTasks) {
+        if (task.ro.lock() == ro)
+            return;
+    }
+
+    if (!m_lodPool) {
+        // leave most of the cores for rendering
+        m_lodPool = std::make_unique<ThreadPool>(std::max(1u, hardware_concurrency() / 4), std::to_string(id()) + "l");
+    }
+    Index resolution = m_lodResolution->getValue();
+    Object::const_ptr geometry = ro->geometry, mapdata = ro->mapdata;
+    LodTask task;
+    task.ro = ro;
+    task.result = m_lodPool->submit([geometry, mapdata, resolution]() {
+        return simplifyByVertexClustering(geometry, mapdata, resolution);
+    });
+    m_lodTasks.emplace_back(std::move(task));
+}
+
+void Renderer::finishLevelOfDetail()
+{
+    for (auto it = m_lodTasks.begin(); it != m_lodTasks.end();) {
+        if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        auto lod = it->result.get();
+        auto ro = it->ro.lock();
+        it = m_lodTasks.erase(it);
+        if (!ro || !lod.geometry || !levelOfDetailEnabled())
+            continue;
+        if (m_objectList.size() <= size_t(ro->timestep + 1))
+            continue;
+        auto &objects = m_objectList[ro->timestep + 1];
+        if (std::find(objects.begin(), objects.end(), ro) == objects.end())
+            continue;
+        ro->lod = addLevelOfDetail(ro, lod.geometry, lod.mapdata);
+    }
+}
+
 bool Renderer::render()
 {
     // no work was done
@@ -510,6 +586,13 @@ bool Renderer::changeParameter(const Parameter *p)
         enableGeometryCaches(m_useGeometryCaches->getValue());
     }
 
+    if (p == m_lodParam && levelOfDetailEnabled()) {
+        for (auto &objects: m_objectList) {
+            for (auto &ro: objects)
+                startLevelOfDetail(ro);
+        }
+    }
+
     return Module::changeParameter(p);
 }
 
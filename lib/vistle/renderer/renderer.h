@@ -4,8 +4,12 @@
 #include <vistle/module/module.h>
 #include <vistle/util/enum.h>
 #include "renderobject.h"
+#include "levelofdetail.h"
 #include "export.h"
 
+#include <deque>
+#include <future>
+
 namespace vistle {
 
 DEFINE_ENUM_WITH_STRING_CONVERSIONS(RenderMode, (LocalOnly)(MasterOnly)(AllRanks)(LocalShmLeader)(AllShmLeaders))
@@ -18,6 +22,8 @@ public:
     bool dispatch(bool block = true, bool *messageReceived = nullptr, unsigned int minPrio = 0) override;
 
     int numTimesteps() const;
+    //! whether simplified versions of render objects should be used during interaction
+    bool levelOfDetailEnabled() const;
     void getBounds(Vector3 &min, Vector3 &max);
     void getBounds(Vector3 &min, Vector3 &max, int time);
 
@@ -42,14 +48,18 @@ public:
     typedef std::map<std::string, ColorMap> ColorMapMap;
 
     //! let module clear cache at appropriate times and manage its deletion
+    /*! with a Persistent lifetime, entries still in use survive re-execution of the sender */
     template<class CacheData>
-    vistle::ResultCache<CacheData> *getOrCreateGeometryCache(int senderId, const std::string &senderPort)
+    vistle::ResultCache<CacheData> *
+    getOrCreateGeometryCache(int senderId, const std::string &senderPort,
+                             ResultCacheBase::Lifetime lifetime = ResultCacheBase::Execution)
     {
         typedef ResultCache<CacheData> RC;
         SendPort c(senderId, senderPort);
         auto it = m_geometryCaches.find(c);
         if (it == m_geometryCaches.end()) {
-            it = m_geometryCaches.emplace(c, new RC).first;
+            it = m_geometryCaches.emplace(c, new RC(lifetime)).first;
+            it->second->enable(m_useGeometryCaches->getValue());
         }
         assert(dynamic_cast<RC *>(it->second.get()));
         return static_cast<RC *>(it->second.get());
@@ -66,6 +76,12 @@ protected:
                                                     Object::const_ptr normal, Object::const_ptr texture) = 0;
     virtual void removeObject(std::shared_ptr<RenderObject> ro);
 
+    //! create parameters for building simplified geometry in the background, for renderers implementing addLevelOfDetail
+    void enableLevelOfDetail();
+    //! create a render object for a simplified version of ro, which has to be removed together with ro
+    virtual std::shared_ptr<RenderObject> addLevelOfDetail(std::shared_ptr<RenderObject> ro,
+                                                           Object::const_ptr geometry, Object::const_ptr texture);
+
     bool changeParameter(const Parameter *p) override;
     void connectionRemoved(const Port *from, const Port *to) override;
 
@@ -89,6 +105,18 @@ private:
 
     void removeAllSentBy(int sender, const std::string &senderPort);
 
+    void startLevelOfDetail(std::shared_ptr<RenderObject> ro);
+    void finishLevelOfDetail();
+    IntParameter *m_lodParam = nullptr;
+    IntParameter *m_lodResolution = nullptr;
+    IntParameter *m_lodMinPrimitives = nullptr;
+    std::unique_ptr<ThreadPool> m_lodPool;
+    struct LodTask {
+        std::weak_ptr<RenderObject> ro;
+        std::future<LevelOfDetail> result;
+    };
+    std::deque<LodTask> m_lodTasks;
+
     struct SendPort {
         SendPort(int id, const std::string &port, const std::string &basename = std::string())
         : module(id), port(port), age(0), iteration(-1)
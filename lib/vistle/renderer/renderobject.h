@@ -1,6 +1,7 @@
 #ifndef VISTLE_RENDEROBJECT_H
 #define VISTLE_RENDEROBJECT_H
 
+#include <memory>
 #include <vector>
 
 #include <vistle/util/enum.h>
@@ -44,6 +45,9 @@ public:
 
     bool hasSolidColor = false;
     vistle::Vector4 solidColor;
+
+    //! simplified representation to be rendered instead while the view is manipulated
+    std::shared_ptr<RenderObject> lod;
 };
 
 } // namespace vistle
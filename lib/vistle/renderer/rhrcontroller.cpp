@@ -87,6 +87,13 @@ RhrController::RhrController(vistle::Module *module, int displayRank)
     module->setCurrentParameterGroup("Advanced", false);
     m_dumpImagesParam = module->addIntParameter("rhr_dump_images", "dump image data to disk", (Integer)m_dumpImages,
                                                 Parameter::Boolean);
+    m_framesInFlightParam = module->addIntParameter(
+        "rhr_frames_in_flight", "number of frames encoded and sent while rendering proceeds", m_framesInFlight);
+    module->setParameterRange(m_framesInFlightParam, (Integer)1, (Integer)8);
+    m_latencyBudgetParam = module->addFloatParameter(
+        "rhr_latency_budget", "max. time (s) a frame may be in flight before rendering blocks, 0: unlimited",
+        m_latencyBudget);
+    module->setParameterMinimum(m_latencyBudgetParam, (Float)0.);
     module->setCurrentParameterGroup("");
 
     initializeServer();
@@ -156,6 +163,8 @@ bool RhrController::initializeServer()
     m_rhr->setTileSize(m_sendTileSize[0], m_sendTileSize[1]);
     m_rhr->setColorCompression(m_rgbaCompress);
     m_rhr->setLinearDepth(linearDepth());
+    m_rhr->setMaxFramesInFlight(m_framesInFlight);
+    m_rhr->setLatencyBudget(m_latencyBudget);
 
     return true;
 }
@@ -283,6 +292,16 @@ bool RhrController::handleParam(const vistle::Parameter *p)
         m_dumpImages = m_dumpImagesParam->getValue() != 0;
         if (m_rhr)
             m_rhr->setDumpImages(m_dumpImages);
+    } else if (p == m_framesInFlightParam) {
+        m_framesInFlight = m_framesInFlightParam->getValue();
+        if (m_rhr)
+            m_rhr->setMaxFramesInFlight(m_framesInFlight);
+        return true;
+    } else if (p == m_latencyBudgetParam) {
+        m_latencyBudget = m_latencyBudgetParam->getValue();
+        if (m_rhr)
+            m_rhr->setLatencyBudget(m_latencyBudget);
+        return true;
     }
 
     return false;
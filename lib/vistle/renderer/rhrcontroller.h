@@ -85,6 +85,11 @@ private:
     IntParameter *m_dumpImagesParam = nullptr;
     bool m_dumpImages = false;
 
+    IntParameter *m_framesInFlightParam = nullptr;
+    Integer m_framesInFlight = 2;
+    FloatParameter *m_latencyBudgetParam = nullptr;
+    Float m_latencyBudget = 0.;
+
     std::shared_ptr<RhrServer> m_rhr;
 };
 
@@ -1,5 +1,7 @@
 #include <cstdio>
 #include "depthquant.h"
+#include "predict.h"
+#include "simd.h"
 #include "compdecomp.h"
 #include "depthcompare.h"
 #include <vistle/util/stopwatch.h>
@@ -10,6 +12,7 @@
 #include <iostream>
 #include <random>
 #include <string>
+#include <functional>
 #include <vistle/core/message.h>
 
 #include <vistle/util/netpbmimage.h>
@@ -166,6 +169,79 @@ void measure(vistle::DepthCompressionParameters depthParam, const std::string &n
     std::cout << std::endl;
 }
 
+//! time individual quantization and prediction kernels for all instruction sets supported by the CPU
+void measureKernels(const std::string &name, const float *depth, size_t w, size_t h, int num_runs)
+{
+    std::cout << name << ", kernels" << std::endl;
+
+    const double mpix = w * h * 1e-6;
+    std::vector<unsigned char> rgba(w * h * 4);
+    for (size_t i = 0; i < w * h; ++i) {
+        const unsigned char gray = depth[i] * 255.f;
+        rgba[i * 4] = gray;
+        rgba[i * 4 + 1] = gray ^ 0x55;
+        rgba[i * 4 + 2] = 255 - gray;
+        rgba[i * 4 + 3] = 255;
+    }
+    const char *zbuf = reinterpret_cast<const char *>(depth);
+
+    struct Kernel {
+        std::string name;
+        size_t size;
+        std::function<void(char *)> run;
+    };
+    std::vector<Kernel> kernels{
+        {"depthquant 16", vistle::depthquant_size(DepthFloat, 2, w, h),
+         [&](char *out) { vistle::depthquant(out, zbuf, DepthFloat, 2, 0, 0, w, h, w); }},
+        {"depthquant 24", vistle::depthquant_size(DepthFloat, 3, w, h),
+         [&](char *out) { vistle::depthquant(out, zbuf, DepthFloat, 3, 0, 0, w, h, w); }},
+        {"depthquant_planar 24", vistle::depthquant_size(DepthFloat, 3, w, h),
+         [&](char *out) { vistle::depthquant_planar(out, zbuf, DepthFloat, 3, 0, 0, w, h, w); }},
+        {"transform_predict", w * h * 3,
+         [&](char *out) { vistle::transform_predict(reinterpret_cast<unsigned char *>(out), depth, w, h, w); }},
+        {"transform_predict_planar", w * h * 3,
+         [&](char *out) { vistle::transform_predict_planar(reinterpret_cast<unsigned char *>(out), depth, w, h, w); }},
+        {"transform_predict rgb", w * h * 3,
+         [&](char *out) {
+             vistle::transform_predict<3, true, true>(reinterpret_cast<unsigned char *>(out), rgba.data(), w, h, w);
+         }},
+        {"transform_predict rgba", w * h * 4,
+         [&](char *out) {
+             vistle::transform_predict<4, true, true>(reinterpret_cast<unsigned char *>(out), rgba.data(), w, h, w);
+         }},
+    };
+
+    const auto isa = vistle::simd::currentIsa();
+    for (auto &k: kernels) {
+        std::vector<char> reference(k.size);
+        vistle::simd::setIsa(vistle::simd::Scalar);
+        k.run(reference.data());
+
+        for (int i = vistle::simd::Scalar; i < vistle::simd::NumIsa; ++i) {
+            if (!vistle::simd::setIsa(vistle::simd::Isa(i)))
+                continue;
+
+            std::vector<char> result(k.size);
+            double fast = std::numeric_limits<double>::max();
+            for (int run = 0; run < num_runs; ++run) {
+                double start = Clock::time();
+                k.run(result.data());
+                double dur = Clock::time() - start;
+                if (dur < fast)
+                    fast = dur;
+            }
+
+            std::cout << k.name << " " << vistle::simd::toString(vistle::simd::Isa(i)) << ": " << fast << " s, "
+                      << mpix / fast << " MPix/s";
+            if (result != reference)
+                std::cout << " (result differs from scalar)";
+            std::cout << std::endl;
+        }
+    }
+    vistle::simd::setIsa(isa);
+    std::cout << std::endl;
+}
+
 int main(int argc, char *argv[])
 {
     std::string name = "depthmap.pgm";
@@ -227,5 +303,7 @@ int main(int argc, char *argv[])
     depthParam.depthCodec = vistle::CompressionParameters::DepthPredictPlanar;
     measure(depthParam, name, &img.gray()[0], w, h, 4, num_runs);
 
+    measureKernels(name, &img.gray()[0], w, h, num_runs);
+
     return 0;
 }
@@ -1,5 +1,6 @@
 #include "depthquant.h"
 #include "predict.h"
+#include "simd.h"
 #include <vistle/util/buffer.h>
 #include <algorithm>
 #include <iostream>
@@ -13,6 +14,10 @@
 
 #include <cassert>
 
+#ifdef VISTLE_RHR_SIMD
+#include <immintrin.h>
+#endif
+
 typedef unsigned char uchar;
 
 namespace vistle {
@@ -421,6 +426,215 @@ static inline void findgap(const uint32_t *depths, uint32_t midval, uint32_t &lo
     }
 }
 
+namespace {
+
+const uint32_t FarDepth = 0x00ffffff;
+
+//! parameters for mapping depth values of a tile to interpolation weights
+struct QuantizeParams {
+    uint32_t mindepth = 0, maxdepth = 0;
+    uint32_t midval = ~uint32_t(0); //!< depths up to midval are interpolated from mindepth, others from maxdepth
+    uint32_t mask = 0; //!< weight used for far pixels
+    uint32_t upperBase = 0; //!< weight of maxdepth
+    float lowerScale = 0.f, upperScale = 0.f;
+    float range = 0.f;
+};
+
+//! convert float depths of a 4x4 tile to 24 bit, find min. and max. of non-far depths, return whether a pixel is far
+typedef bool (*GatherFunc)(uint32_t *depths, const float *tile, int stride, uint32_t &mindepth, uint32_t &maxdepth);
+//! compute interpolation weights for the 16 depths of a tile
+typedef void (*QuantizeFunc)(uint32_t *quant, const uint32_t *depths, const QuantizeParams &p);
+
+void quantize_scalar(uint32_t *quant, const uint32_t *depths, const QuantizeParams &p)
+{
+    for (int idx = 0; idx < 16; ++idx) {
+        const uint32_t depth = depths[idx];
+        if (depth == FarDepth) {
+            quant[idx] = p.mask;
+        } else if (depth <= p.midval) {
+            quant[idx] = ((depth - p.mindepth) * p.lowerScale) / p.range;
+        } else {
+            const uint32_t q = ((p.maxdepth - depth) * p.upperScale) / p.range;
+            quant[idx] = p.upperBase - q;
+        }
+    }
+}
+
+#ifdef VISTLE_RHR_SIMD
+V_TARGET("sse4.1")
+bool gather_float_sse4(uint32_t *depths, const float *tile, int stride, uint32_t &mindepth, uint32_t &maxdepth)
+{
+    const __m128 scale = _mm_set1_ps(float(FarDepth));
+    const __m128i far = _mm_set1_epi32(FarDepth);
+    __m128i vmin = far, vmax = _mm_setzero_si128(), vfar = _mm_setzero_si128();
+    for (int row = 0; row < 4; ++row) {
+        const __m128 df = _mm_loadu_ps(tile + row * stride);
+        const __m128i d = _mm_min_epu32(_mm_cvttps_epi32(_mm_mul_ps(df, scale)), far);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(depths + 4 * row), d);
+        const __m128i isFar = _mm_cmpeq_epi32(d, far);
+        vfar = _mm_or_si128(vfar, isFar);
+        vmin = _mm_min_epu32(vmin, d);
+        vmax = _mm_max_epu32(vmax, _mm_andnot_si128(isFar, d));
+    }
+    vmin = _mm_min_epu32(vmin, _mm_shuffle_epi32(vmin, 0x4e));
+    vmin = _mm_min_epu32(vmin, _mm_shuffle_epi32(vmin, 0xb1));
+    vmax = _mm_max_epu32(vmax, _mm_shuffle_epi32(vmax, 0x4e));
+    vmax = _mm_max_epu32(vmax, _mm_shuffle_epi32(vmax, 0xb1));
+    mindepth = _mm_cvtsi128_si32(vmin);
+    maxdepth = _mm_cvtsi128_si32(vmax);
+    return !_mm_testz_si128(vfar, vfar);
+}
+
+V_TARGET("sse4.1") void quantize_sse4(uint32_t *quant, const uint32_t *depths, const QuantizeParams &p)
+{
+    const __m128i far = _mm_set1_epi32(FarDepth), mask = _mm_set1_epi32(p.mask);
+    const __m128i mindepth = _mm_set1_epi32(p.mindepth), maxdepth = _mm_set1_epi32(p.maxdepth);
+    const __m128i midval = _mm_set1_epi32(p.midval), upperBase = _mm_set1_epi32(p.upperBase);
+    const __m128 lowerScale = _mm_set1_ps(p.lowerScale), upperScale = _mm_set1_ps(p.upperScale);
+    const __m128 range = _mm_set1_ps(p.range);
+    for (int idx = 0; idx < 16; idx += 4) {
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(depths + idx));
+        const __m128i lower = _mm_cmpeq_epi32(_mm_min_epu32(d, midval), d);
+        const __m128i n = _mm_blendv_epi8(_mm_sub_epi32(maxdepth, d), _mm_sub_epi32(d, mindepth), lower);
+        const __m128 s = _mm_blendv_ps(upperScale, lowerScale, _mm_castsi128_ps(lower));
+        __m128i q = _mm_cvttps_epi32(_mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(n), s), range));
+        q = _mm_blendv_epi8(_mm_sub_epi32(upperBase, q), q, lower);
+        q = _mm_blendv_epi8(q, mask, _mm_cmpeq_epi32(d, far));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(quant + idx), q);
+    }
+}
+
+V_TARGET("avx2")
+bool gather_float_avx2(uint32_t *depths, const float *tile, int stride, uint32_t &mindepth, uint32_t &maxdepth)
+{
+    const __m256 scale = _mm256_set1_ps(float(FarDepth));
+    const __m256i far = _mm256_set1_epi32(FarDepth);
+    __m256i vmin = far, vmax = _mm256_setzero_si256(), vfar = _mm256_setzero_si256();
+    for (int row = 0; row < 4; row += 2) {
+        const __m256 df = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(tile + row * stride)),
+                                               _mm_loadu_ps(tile + (row + 1) * stride), 1);
+        const __m256i d = _mm256_min_epu32(_mm256_cvttps_epi32(_mm256_mul_ps(df, scale)), far);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(depths + 4 * row), d);
+        const __m256i isFar = _mm256_cmpeq_epi32(d, far);
+        vfar = _mm256_or_si256(vfar, isFar);
+        vmin = _mm256_min_epu32(vmin, d);
+        vmax = _mm256_max_epu32(vmax, _mm256_andnot_si256(isFar, d));
+    }
+    __m128i min4 = _mm_min_epu32(_mm256_castsi256_si128(vmin), _mm256_extracti128_si256(vmin, 1));
+    __m128i max4 = _mm_max_epu32(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1));
+    min4 = _mm_min_epu32(min4, _mm_shuffle_epi32(min4, 0x4e));
+    min4 = _mm_min_epu32(min4, _mm_shuffle_epi32(min4, 0xb1));
+    max4 = _mm_max_epu32(max4, _mm_shuffle_epi32(max4, 0x4e));
+    max4 = _mm_max_epu32(max4, _mm_shuffle_epi32(max4, 0xb1));
+    mindepth = _mm_cvtsi128_si32(min4);
+    maxdepth = _mm_cvtsi128_si32(max4);
+    return !_mm256_testz_si256(vfar, vfar);
+}
+
+V_TARGET("avx2") void quantize_avx2(uint32_t *quant, const uint32_t *depths, const QuantizeParams &p)
+{
+    const __m256i far = _mm256_set1_epi32(FarDepth), mask = _mm256_set1_epi32(p.mask);
+    const __m256i mindepth = _mm256_set1_epi32(p.mindepth), maxdepth = _mm256_set1_epi32(p.maxdepth);
+    const __m256i midval = _mm256_set1_epi32(p.midval), upperBase = _mm256_set1_epi32(p.upperBase);
+    const __m256 lowerScale = _mm256_set1_ps(p.lowerScale), upperScale = _mm256_set1_ps(p.upperScale);
+    const __m256 range = _mm256_set1_ps(p.range);
+    for (int idx = 0; idx < 16; idx += 8) {
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(depths + idx));
+        const __m256i lower = _mm256_cmpeq_epi32(_mm256_min_epu32(d, midval), d);
+        const __m256i n = _mm256_blendv_epi8(_mm256_sub_epi32(maxdepth, d), _mm256_sub_epi32(d, mindepth), lower);
+        const __m256 s = _mm256_blendv_ps(upperScale, lowerScale, _mm256_castsi256_ps(lower));
+        __m256i q = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(n), s), range));
+        q = _mm256_blendv_epi8(_mm256_sub_epi32(upperBase, q), q, lower);
+        q = _mm256_blendv_epi8(q, mask, _mm256_cmpeq_epi32(d, far));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(quant + idx), q);
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC's AVX-512 intrinsics pass self-initialized _mm512_undefined_* vectors as source for unused lanes
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+// a 4x4 tile fits into a single 512 bit register
+V_TARGET("avx512f,avx512bw")
+bool gather_float_avx512(uint32_t *depths, const float *tile, int stride, uint32_t &mindepth, uint32_t &maxdepth)
+{
+    const __m512i far = _mm512_set1_epi32(FarDepth);
+    __m512 df = _mm512_castps128_ps512(_mm_loadu_ps(tile));
+    df = _mm512_insertf32x4(df, _mm_loadu_ps(tile + stride), 1);
+    df = _mm512_insertf32x4(df, _mm_loadu_ps(tile + 2 * stride), 2);
+    df = _mm512_insertf32x4(df, _mm_loadu_ps(tile + 3 * stride), 3);
+    const __m512i d = _mm512_min_epu32(_mm512_cvttps_epi32(_mm512_mul_ps(df, _mm512_set1_ps(float(FarDepth)))), far);
+    _mm512_storeu_si512(depths, d);
+    const __mmask16 isFar = _mm512_cmpeq_epu32_mask(d, far);
+    mindepth = _mm512_reduce_min_epu32(d);
+    maxdepth = _mm512_reduce_max_epu32(_mm512_maskz_mov_epi32(__mmask16(~isFar), d));
+    return isFar != 0;
+}
+
+V_TARGET("avx512f,avx512bw") void quantize_avx512(uint32_t *quant, const uint32_t *depths, const QuantizeParams &p)
+{
+    const __m512i d = _mm512_loadu_si512(depths);
+    const __mmask16 lower = _mm512_cmple_epu32_mask(d, _mm512_set1_epi32(p.midval));
+    const __m512i n = _mm512_mask_blend_epi32(lower, _mm512_sub_epi32(_mm512_set1_epi32(p.maxdepth), d),
+                                              _mm512_sub_epi32(d, _mm512_set1_epi32(p.mindepth)));
+    const __m512 s = _mm512_mask_blend_ps(lower, _mm512_set1_ps(p.upperScale), _mm512_set1_ps(p.lowerScale));
+    __m512i q = _mm512_cvttps_epi32(_mm512_div_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(n), s), _mm512_set1_ps(p.range)));
+    q = _mm512_mask_blend_epi32(lower, _mm512_sub_epi32(_mm512_set1_epi32(p.upperBase), q), q);
+    q = _mm512_mask_mov_epi32(q, _mm512_cmpeq_epu32_mask(d, _mm512_set1_epi32(FarDepth)), _mm512_set1_epi32(p.mask));
+    _mm512_storeu_si512(quant, q);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+GatherFunc gatherFloatKernel()
+{
+    switch (simd::currentIsa()) {
+#ifdef VISTLE_RHR_SIMD
+    case simd::AVX512:
+        return gather_float_avx512;
+    case simd::AVX2:
+        return gather_float_avx2;
+    case simd::SSE4:
+        return gather_float_sse4;
+#endif
+    default:
+        break;
+    }
+    return nullptr;
+}
+
+QuantizeFunc quantizeKernel()
+{
+    switch (simd::currentIsa()) {
+#ifdef VISTLE_RHR_SIMD
+    case simd::AVX512:
+        return quantize_avx512;
+    case simd::AVX2:
+        return quantize_avx2;
+    case simd::SSE4:
+        return quantize_sse4;
+#endif
+    default:
+        break;
+    }
+    return quantize_scalar;
+}
+
+template<int bits_per_pixel>
+inline uint64_t packbits(const uint32_t *quant)
+{
+    uint64_t bits = 0;
+    for (int idx = 0; idx < 16; ++idx)
+        bits |= uint64_t(quant[idx]) << (idx * bits_per_pixel);
+    return bits;
+}
+
+} // namespace
+
 //! dxt-like compression for depth values
 template<int bpp, class Quant, class MinMaxDepth, DepthFormat format>
 static void depthquant_t(const uchar *inimg, Quant *quantbuf, MinMaxDepth *mmdepth, int x0, int y0, int w, int h,
@@ -439,10 +653,12 @@ static void depthquant_t(const uchar *inimg, Quant *quantbuf, MinMaxDepth *mmdep
     assert(Next > 0);
     assert((Next & Valid) > 0);
     assert(((Next - 1) & Valid) == 0);
-#define NOCHECK
-#if !defined(NOCHECK) || !defined(NDEBUG)
-    const uint32_t qm2 = (1U << quantbits) / 2;
-#endif
+    static_assert(size == 16, "kernels are specialized for 4x4 tiles");
+
+    GatherFunc gather = nullptr;
+    if (format == DepthFloat && bpp == 4)
+        gather = gatherFloatKernel();
+    const QuantizeFunc quantize = quantizeKernel();
 
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -466,7 +682,10 @@ static void depthquant_t(const uchar *inimg, Quant *quantbuf, MinMaxDepth *mmdep
             maxdepth = d; \
     }
 
-            if (yy + edge <= y0 + h && xx + edge <= x0 + w) {
+            if (gather && yy + edge <= y0 + h && xx + edge <= x0 + w) {
+                const float *tile = reinterpret_cast<const float *>(inimg) + yy * stride + xx;
+                haveFar = gather(depths, tile, stride, mindepth, maxdepth);
+            } else if (yy + edge <= y0 + h && xx + edge <= x0 + w) {
                 const int ym = yy + edge, xm = xx + edge;
                 int idx = 0;
                 for (int y = yy; y < ym; ++y) {
@@ -521,28 +740,15 @@ static void depthquant_t(const uchar *inimg, Quant *quantbuf, MinMaxDepth *mmdep
                         bits = 0;
                     }
                 } else {
-                    if (haveFar) {
-                        for (int idx = 0; idx < size; ++idx) {
-                            const uint32_t depth = depths[idx];
-                            uint32_t quant = 0;
-                            if (depth == Far) {
-                                quant = mask;
-                            } else {
-                                quant = ((depth - mindepth) * qscale) / range;
-                                assert(quant < mask);
-                            }
-
-                            bits |= uint64_t(quant) << (idx * quantbits);
-                        }
-                    } else {
-                        for (int idx = 0; idx < size; ++idx) {
-                            const uint32_t depth = depths[idx];
-                            uint32_t quant = ((depth - mindepth) * qscale) / range;
-                            assert(quant <= mask);
-
-                            bits |= uint64_t(quant) << (idx * quantbits);
-                        }
-                    }
+                    QuantizeParams param;
+                    param.mindepth = mindepth;
+                    param.maxdepth = maxdepth;
+                    param.mask = mask;
+                    param.lowerScale = qscale;
+                    param.range = range;
+                    uint32_t quant[size];
+                    quantize(quant, depths, param);
+                    bits = packbits<quantbits>(quant);
                 }
                 dq_setbits(sq, bits);
             } else {
@@ -578,62 +784,23 @@ static void depthquant_t(const uchar *inimg, Quant *quantbuf, MinMaxDepth *mmdep
                         dq_setbits(sq, 0UL);
                     }
                 } else {
+                    QuantizeParams param;
+                    param.mindepth = mindepth;
+                    param.maxdepth = maxdepth;
+                    param.midval = midval;
+                    param.mask = mask;
+                    param.lowerScale = lowerscale * mask + 0.5f;
                     if (haveFar) {
-                        for (int idx = 0; idx < size; ++idx) {
-                            const uint32_t depth = depths[idx];
-                            uint32_t quant = 0;
-
-                            if (depth == Far) {
-                                quant = mask;
-                            } else if (depth <= midval) {
-                                assert(depth <= lowermid);
-                                quant = ((depth - mindepth) * (lowerscale * mask + 0.5f)) / range;
-#ifndef NOCHECK
-                                if (quant >= qm2)
-                                    quant = qm2 - 1;
-#endif
-                                assert(quant < qm2);
-                            } else {
-                                assert(depth >= uppermid);
-                                quant = ((maxdepth - depth) * (upperscale * (mask - 1.5f))) / range;
-#ifndef NOCHECK
-                                if (quant >= qm2 - 1)
-                                    quant = qm2 - 2;
-#endif
-                                assert(quant < qm2 - 1);
-                                quant = mask - 1 - quant;
-                            }
-
-                            bits |= uint64_t(quant) << (idx * quantbits);
-                        }
+                        param.upperBase = mask - 1;
+                        param.upperScale = upperscale * (mask - 1.5f);
                     } else {
-                        for (int idx = 0; idx < size; ++idx) {
-                            const uint32_t depth = depths[idx];
-                            uint32_t quant = 0;
-
-                            if (depth <= midval) {
-                                assert(depth <= lowermid);
-                                quant = ((depth - mindepth) * (lowerscale * mask + 0.5f)) / range;
-#ifndef NOCHECK
-                                if (quant >= qm2)
-                                    quant = qm2 - 1;
-#endif
-                                assert(quant < qm2);
-                            } else {
-                                assert(depth >= uppermid);
-                                assert(depth < Far);
-                                quant = ((maxdepth - depth) * (upperscale * mask + 0.5f)) / range;
-#ifndef NOCHECK
-                                if (quant >= qm2)
-                                    quant = qm2 - 1;
-#endif
-                                assert(quant < qm2);
-                                quant = mask - quant;
-                            }
-
-                            bits |= uint64_t(quant) << (idx * quantbits);
-                        }
+                        param.upperBase = mask;
+                        param.upperScale = upperscale * mask + 0.5f;
                     }
+                    param.range = range;
+                    uint32_t quant[size];
+                    quantize(quant, depths, param);
+                    bits = packbits<quantbits>(quant);
                     dq_setbits(sq, bits);
                 }
 
@@ -1,43 +1,282 @@
 #include "predict.h"
+#include "simd.h"
 
 #include <vistle/util/math.h>
 #include <cstdint>
+#include <cstring>
 #include <cassert>
 
+#ifdef VISTLE_RHR_SIMD
+#include <immintrin.h>
+#endif
+
 namespace vistle {
 
 namespace {
 const uint32_t Max = 0xffffffU;
 }
 
+// for color data
 
-void transform_predict(unsigned char *output, const float *input, unsigned width, unsigned height, unsigned stride)
+static void rgb2yuv(uint8_t r, uint8_t g, uint8_t b, uint8_t &y, uint8_t &u, uint8_t &v)
 {
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for (unsigned y = 0; y < height; ++y) {
-        const float *in = input + y * stride;
-        unsigned char *out = output + y * width * 3;
+    y = b;
+    u = g - b;
+    v = g - r;
+}
 
-        uint8_t prev[3] = {0, 0, 0};
-        for (unsigned x = 0; x < width; ++x) {
-            uint32_t I = *in * Max;
+static void yuv2rgb(uint8_t y, uint8_t u, uint8_t v, uint8_t &r, uint8_t &g, uint8_t &b)
+{
+    b = y;
+    g = u + b;
+    r = g - v;
+}
+
+namespace {
+
+// all prediction kernels convert a pixel into a 32 bit word holding one byte per plane:
+// 24 bit quantized depth for depth data and Y, U, V, A for color data,
+// and then store the byte-wise difference to the word of the previous pixel
+
+//! predict a row of pixels starting at x, prevWord is the word of pixel x-1
+template<int planes, bool planar, bool depth>
+void predict_row_tail(unsigned char *out, size_t plane_size, const void *input, unsigned x, unsigned width,
+                      uint32_t prevWord)
+{
+    uint8_t prev[4] = {uint8_t(prevWord), uint8_t(prevWord >> 8), uint8_t(prevWord >> 16), uint8_t(prevWord >> 24)};
+    for (; x < width; ++x) {
+        uint32_t word = 0;
+        if constexpr (depth) {
+            uint32_t I = static_cast<const float *>(input)[x] * Max;
             if (I > Max)
                 I = Max;
-            ++in;
+            word = I;
+        } else {
+            const unsigned char *in = static_cast<const unsigned char *>(input) + 4 * x;
+            uint8_t y, u, v;
+            rgb2yuv(in[0], in[1], in[2], y, u, v);
+            word = y | (uint32_t(u) << 8) | (uint32_t(v) << 16) | (uint32_t(in[3]) << 24);
+        }
 
-            for (unsigned i = 0; i < 3; ++i) {
-                uint8_t a = I & 0xff;
-                I >>= 8;
-                uint8_t d = a - prev[i];
-                prev[i] = a;
-                out[i] = d;
-            }
+        for (int p = 0; p < planes; ++p) {
+            uint8_t a = word & 0xff;
+            word >>= 8;
+            uint8_t d = a - prev[p];
+            prev[p] = a;
+            if (planar)
+                out[p * plane_size + x] = d;
+            else
+                out[x * planes + p] = d;
+        }
+    }
+}
+
+template<int planes, bool planar, bool depth>
+void predict_row_scalar(unsigned char *out, size_t plane_size, const void *input, unsigned width)
+{
+    predict_row_tail<planes, planar, depth>(out, plane_size, input, 0, width, 0);
+}
 
-            out += 3;
+#ifdef VISTLE_RHR_SIMD
+V_TARGET("sse4.1") inline __m128i quantize_sse4(const float *in)
+{
+    const __m128i I = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(in), _mm_set1_ps(float(Max))));
+    return _mm_min_epu32(I, _mm_set1_epi32(Max));
+}
+
+V_TARGET("sse4.1") inline __m128i yuva_sse4(const unsigned char *in)
+{
+    // y = b, u = g - b, v = g - r
+    const __m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+    const __m128i bgga = _mm_shuffle_epi8(rgba, _mm_setr_epi8(2, 1, 1, 3, 6, 5, 5, 7, 10, 9, 9, 11, 14, 13, 13, 15));
+    const __m128i _br_ =
+        _mm_shuffle_epi8(rgba, _mm_setr_epi8(-1, 2, 0, -1, -1, 6, 4, -1, -1, 10, 8, -1, -1, 14, 12, -1));
+    return _mm_sub_epi8(bgga, _br_);
+}
+
+template<int planes, bool planar, bool depth>
+V_TARGET("sse4.1")
+void predict_row_sse4(unsigned char *out, size_t plane_size, const void *input, unsigned width)
+{
+    const __m128i toPlanes = planar ? _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15)
+                                    : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    __m128i prev = _mm_setzero_si128();
+    unsigned x = 0;
+    for (; x + 4 <= width; x += 4) {
+        __m128i word;
+        if constexpr (depth)
+            word = quantize_sse4(static_cast<const float *>(input) + x);
+        else
+            word = yuva_sse4(static_cast<const unsigned char *>(input) + 4 * x);
+        const __m128i delta = _mm_sub_epi8(word, _mm_alignr_epi8(word, prev, 12));
+        prev = word;
+
+        alignas(16) unsigned char bytes[16];
+        _mm_store_si128(reinterpret_cast<__m128i *>(bytes), _mm_shuffle_epi8(delta, toPlanes));
+        if (planar) {
+            for (int p = 0; p < planes; ++p)
+                memcpy(out + p * plane_size + x, bytes + 4 * p, 4);
+        } else {
+            memcpy(out + x * planes, bytes, 4 * planes);
         }
     }
+    predict_row_tail<planes, planar, depth>(out, plane_size, input, x, width, _mm_extract_epi32(prev, 3));
+}
+
+V_TARGET("avx2") inline __m256i quantize_avx2(const float *in)
+{
+    const __m256i I = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in), _mm256_set1_ps(float(Max))));
+    return _mm256_min_epu32(I, _mm256_set1_epi32(Max));
+}
+
+V_TARGET("avx2") inline __m256i yuva_avx2(const unsigned char *in)
+{
+    const __m256i rgba = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+    const __m256i bgga = _mm256_shuffle_epi8(
+        rgba, _mm256_broadcastsi128_si256(_mm_setr_epi8(2, 1, 1, 3, 6, 5, 5, 7, 10, 9, 9, 11, 14, 13, 13, 15)));
+    const __m256i _br_ = _mm256_shuffle_epi8(
+        rgba, _mm256_broadcastsi128_si256(_mm_setr_epi8(-1, 2, 0, -1, -1, 6, 4, -1, -1, 10, 8, -1, -1, 14, 12, -1)));
+    return _mm256_sub_epi8(bgga, _br_);
+}
+
+template<int planes, bool planar, bool depth>
+V_TARGET("avx2")
+void predict_row_avx2(unsigned char *out, size_t plane_size, const void *input, unsigned width)
+{
+    const __m256i toPlanes = _mm256_broadcastsi128_si256(
+        planar ? _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15)
+               : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+    // gather 8 bytes of each plane from both 128 bit lanes
+    const __m256i fromLanes = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    __m256i prev = _mm256_setzero_si256();
+    unsigned x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i word;
+        if constexpr (depth)
+            word = quantize_avx2(static_cast<const float *>(input) + x);
+        else
+            word = yuva_avx2(static_cast<const unsigned char *>(input) + 4 * x);
+        // words shifted by one pixel, with last word of previous iteration shifted in
+        const __m256i shifted = _mm256_alignr_epi8(word, _mm256_permute2x128_si256(prev, word, 0x21), 12);
+        const __m256i delta = _mm256_sub_epi8(word, shifted);
+        prev = word;
+
+        alignas(32) unsigned char bytes[32];
+        if (planar) {
+            _mm256_store_si256(reinterpret_cast<__m256i *>(bytes),
+                               _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(delta, toPlanes), fromLanes));
+            for (int p = 0; p < planes; ++p)
+                memcpy(out + p * plane_size + x, bytes + 8 * p, 8);
+        } else {
+            _mm256_store_si256(reinterpret_cast<__m256i *>(bytes), _mm256_shuffle_epi8(delta, toPlanes));
+            memcpy(out + x * planes, bytes, 4 * planes);
+            memcpy(out + (x + 4) * planes, bytes + 16, 4 * planes);
+        }
+    }
+    predict_row_tail<planes, planar, depth>(out, plane_size, input, x, width, _mm256_extract_epi32(prev, 7));
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC's AVX-512 intrinsics pass self-initialized _mm512_undefined_* vectors as source for unused lanes
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+V_TARGET("avx512f,avx512bw") inline __m512i quantize_avx512(const float *in)
+{
+    const __m512i I = _mm512_cvttps_epi32(_mm512_mul_ps(_mm512_loadu_ps(in), _mm512_set1_ps(float(Max))));
+    return _mm512_min_epu32(I, _mm512_set1_epi32(Max));
+}
+
+V_TARGET("avx512f,avx512bw") inline __m512i yuva_avx512(const unsigned char *in)
+{
+    const __m512i rgba = _mm512_loadu_si512(in);
+    const __m512i bgga = _mm512_shuffle_epi8(
+        rgba, _mm512_broadcast_i32x4(_mm_setr_epi8(2, 1, 1, 3, 6, 5, 5, 7, 10, 9, 9, 11, 14, 13, 13, 15)));
+    const __m512i _br_ = _mm512_shuffle_epi8(
+        rgba, _mm512_broadcast_i32x4(_mm_setr_epi8(-1, 2, 0, -1, -1, 6, 4, -1, -1, 10, 8, -1, -1, 14, 12, -1)));
+    return _mm512_sub_epi8(bgga, _br_);
+}
+
+template<int planes, bool planar, bool depth>
+V_TARGET("avx512f,avx512bw")
+void predict_row_avx512(unsigned char *out, size_t plane_size, const void *input, unsigned width)
+{
+    static_assert(planar || planes == 3, "interleaved output only for 3 planes");
+    const __m512i toPlanes =
+        _mm512_broadcast_i32x4(_mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1));
+    // remove gaps between 12 byte groups in each of the 128 bit lanes
+    const __m512i fromLanes = _mm512_setr_epi32(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0, 0, 0, 0);
+    __m512i prev = _mm512_setzero_si512();
+    unsigned x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m512i word;
+        if constexpr (depth)
+            word = quantize_avx512(static_cast<const float *>(input) + x);
+        else
+            word = yuva_avx512(static_cast<const unsigned char *>(input) + 4 * x);
+        const __m512i delta = _mm512_sub_epi8(word, _mm512_alignr_epi32(word, prev, 15));
+        prev = word;
+
+        if (planar) {
+            for (int p = 0; p < planes; ++p) {
+                const __m512i plane = _mm512_srl_epi32(delta, _mm_cvtsi32_si128(8 * p));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + p * plane_size + x), _mm512_cvtepi32_epi8(plane));
+            }
+        } else {
+            const __m512i packed = _mm512_permutexvar_epi32(fromLanes, _mm512_shuffle_epi8(delta, toPlanes));
+            _mm512_mask_storeu_epi32(out + x * planes, 0x0fff, packed);
+        }
+    }
+    predict_row_tail<planes, planar, depth>(out, plane_size, input, x, width,
+                                            _mm_extract_epi32(_mm512_extracti32x4_epi32(prev, 3), 3));
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+typedef void (*PredictRowFunc)(unsigned char *out, size_t plane_size, const void *input, unsigned width);
+
+template<int planes, bool planar, bool depth>
+PredictRowFunc predictRowKernel()
+{
+    switch (simd::currentIsa()) {
+#ifdef VISTLE_RHR_SIMD
+    case simd::AVX512:
+        return predict_row_avx512<planes, planar, depth>;
+    case simd::AVX2:
+        return predict_row_avx2<planes, planar, depth>;
+    case simd::SSE4:
+        return predict_row_sse4<planes, planar, depth>;
+#endif
+    default:
+        break;
+    }
+    return predict_row_scalar<planes, planar, depth>;
+}
+
+//! apply prediction to all rows of an image, input stride is in elements of Input
+template<int planes, bool planar, bool depth, typename Input>
+void predict_rows(unsigned char *output, const Input *input, unsigned width, unsigned height, size_t stride)
+{
+    const size_t plane_size = width * height;
+    const PredictRowFunc predict_row = predictRowKernel<planes, planar, depth>();
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (unsigned y = 0; y < height; ++y) {
+        unsigned char *out = planar ? output + y * width : output + y * width * planes;
+        predict_row(out, plane_size, input + y * stride, width);
+    }
+}
+
+} // namespace
+
+void transform_predict(unsigned char *output, const float *input, unsigned width, unsigned height, unsigned stride)
+{
+    predict_rows<3, false, true>(output, input, width, height, stride);
 }
 
 void transform_unpredict(float *output, const unsigned char *input, unsigned width, unsigned height, unsigned stride)
@@ -68,34 +307,7 @@ void transform_unpredict(float *output, const unsigned char *input, unsigned wid
 void transform_predict_planar(unsigned char *output, const float *input, unsigned width, unsigned height,
                               unsigned stride)
 {
-    const size_t plane_size = width * height;
-
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for (unsigned y = 0; y < height; ++y) {
-        const float *in = input + y * stride;
-        unsigned char *out[3] = {output + y * width, output + plane_size + y * width,
-                                 output + 2 * plane_size + y * width};
-
-        uint8_t prev[3] = {0, 0, 0};
-        for (unsigned x = 0; x < width; ++x) {
-            uint32_t I = *in * Max;
-            if (I > Max)
-                I = Max;
-            ++in;
-
-            for (unsigned i = 0; i < 3; ++i) {
-                uint8_t a = I & 0xff;
-                I >>= 8;
-                uint8_t d = a - prev[i];
-                prev[i] = a;
-
-                *out[i] = d;
-                ++out[i];
-            }
-        }
-    }
+    predict_rows<3, true, true>(output, input, width, height, stride);
 }
 
 void transform_unpredict_planar(float *output, const unsigned char *input, unsigned width, unsigned height,
@@ -212,59 +424,11 @@ template void transform_unpredict<5, true, false>(unsigned char *output, const u
 template void transform_unpredict<6, true, false>(unsigned char *output, const unsigned char *input, unsigned width,
                                                   unsigned height, unsigned stride);
 
-// for color data
-
-static void rgb2yuv(uint8_t r, uint8_t g, uint8_t b, uint8_t &y, uint8_t &u, uint8_t &v)
-{
-    y = b;
-    u = g - b;
-    v = g - r;
-}
-
-static void yuv2rgb(uint8_t y, uint8_t u, uint8_t v, uint8_t &r, uint8_t &g, uint8_t &b)
-{
-    b = y;
-    g = u + b;
-    r = g - v;
-}
-
 template<>
 void transform_predict<3, true, true>(unsigned char *output, const unsigned char *input, unsigned width,
                                       unsigned height, unsigned stride)
 {
-    const int planes = 3;
-    const size_t plane_size = width * height;
-
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for (unsigned y = 0; y < height; ++y) {
-        const unsigned char *in = input + y * stride * 4;
-        unsigned char *out[planes];
-        for (int i = 0; i < planes; ++i) {
-            out[i] = output + i * plane_size + y * width;
-        }
-
-        uint8_t prev[planes] = {};
-        for (unsigned x = 0; x < width; ++x) {
-            uint8_t r = *in++;
-            uint8_t g = *in++;
-            uint8_t b = *in++;
-            uint8_t a = *in++;
-            (void)a;
-
-            uint8_t y, u, v;
-            rgb2yuv(r, g, b, y, u, v);
-
-            *out[0]++ = y - prev[0];
-            *out[1]++ = u - prev[1];
-            *out[2]++ = v - prev[2];
-
-            prev[0] = y;
-            prev[1] = u;
-            prev[2] = v;
-        }
-    }
+    predict_rows<3, true, false>(output, input, width, height, size_t(stride) * 4);
 }
 
 template<>
@@ -308,40 +472,7 @@ template<>
 void transform_predict<4, true, true>(unsigned char *output, const unsigned char *input, unsigned width,
                                       unsigned height, unsigned stride)
 {
-    const int planes = 4;
-    const size_t plane_size = width * height;
-
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-    for (unsigned y = 0; y < height; ++y) {
-        const unsigned char *in = input + y * stride * planes;
-        unsigned char *out[planes];
-        for (int i = 0; i < planes; ++i) {
-            out[i] = output + i * plane_size + y * width;
-        }
-
-        uint8_t prev[planes] = {};
-        for (unsigned x = 0; x < width; ++x) {
-            uint8_t r = *in++;
-            uint8_t g = *in++;
-            uint8_t b = *in++;
-            uint8_t a = *in++;
-
-            uint8_t y, u, v;
-            rgb2yuv(r, g, b, y, u, v);
-
-            *out[0]++ = y - prev[0];
-            *out[1]++ = u - prev[1];
-            *out[2]++ = v - prev[2];
-            *out[3]++ = a - prev[3];
-
-            prev[0] = y;
-            prev[1] = u;
-            prev[2] = v;
-            prev[3] = a;
-        }
-    }
+    predict_rows<4, true, false>(output, input, width, height, size_t(stride) * 4);
 }
 
 template<>
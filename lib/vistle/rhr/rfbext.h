@@ -207,6 +207,7 @@ enum rfbTileFlags {
     rfbTileFirst = 1,
     rfbTileLast = 2,
     rfbTileRequest = 4,
+    rfbTileUnchanged = 8, //!< tile is identical to the one last sent for same view, position and size - no payload
 };
 
 enum rfbTileFormats {
@@ -10,6 +10,8 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <cstring>
+#include <iomanip>
 #include <thread>
 
 #include "rfbext.h"
@@ -50,7 +52,12 @@ bool RhrServer::send(message::Buffer msg, const buffer *payload)
     }
 
     message::error_code ec;
-    if (!message::send(*m_clientSocket, msg, ec, payload)) {
+    bool ok = false;
+    {
+        std::lock_guard<std::mutex> locker(m_sendMutex);
+        ok = message::send(*m_clientSocket, msg, ec, payload);
+    }
+    if (!ok) {
         if (ec) {
             CERR << "client error: " << ec.message() << ", disconnecting" << std::endl;
         } else {
@@ -62,6 +69,30 @@ bool RhrServer::send(message::Buffer msg, const buffer *payload)
     return true;
 }
 
+bool RhrServer::sendTile(const RemoteRenderMessage &msg, size_t modificationCount, const buffer *payload)
+{
+    message::Buffer buf(msg);
+    auto &rem = buf.as<RemoteRenderMessage>();
+    rem.rhr().modificationCount = modificationCount;
+
+    std::lock_guard<std::mutex> locker(m_sendMutex);
+    if (!m_clientSocket || !m_clientSocket->is_open())
+        return false;
+
+    message::error_code ec;
+    if (!message::send(*m_clientSocket, buf, ec, payload)) {
+        if (ec) {
+            CERR << "client error while sending tile: " << ec.message() << ", disconnecting" << std::endl;
+        } else {
+            CERR << "unknown client error while sending tile, disconnecting" << std::endl;
+        }
+        // client is reset from main thread
+        m_sendFailed = true;
+        return false;
+    }
+    return true;
+}
+
 //! called when plugin is loaded
 RhrServer::RhrServer(): m_acceptorv4(m_io), m_acceptorv6(m_io), m_listen(true), m_port(0), m_destPort(0)
 {
@@ -71,12 +102,21 @@ RhrServer::RhrServer(): m_acceptorv4(m_io), m_acceptorv6(m_io), m_listen(true),
 // this is called if the plugin is removed at runtime
 RhrServer::~RhrServer()
 {
-    while (m_queuedTiles > 0) {
-        usleep(10000);
-        std::lock_guard<std::mutex> locker(m_taskMutex);
-        m_queuedTiles -= m_finishedTasks.size();
-        m_finishedTasks.clear();
-    }
+    discardFrames();
+
+    std::unique_lock<std::mutex> locker(m_taskMutex);
+    assert(m_queuedTasks.empty());
+    m_quit = true;
+    m_frameCond.notify_all();
+    auto workers = std::move(m_workers);
+    m_workers.clear();
+    locker.unlock();
+
+    for (auto &w: workers)
+        w.second.join();
+    if (m_sendThread.joinable())
+        m_sendThread.join();
+
     m_clientSocket.reset();
 
     //fprintf(stderr,"RhrServer::~RhrServer\n");
@@ -102,11 +142,15 @@ bool RhrServer::isConnected() const
 
 void RhrServer::setColorCodec(CompressionParameters::ColorCodec value)
 {
+    if (m_imageParam.rgbaParam.rgbaCodec != value)
+        resetTileHashes();
     m_imageParam.rgbaParam.rgbaCodec = value;
 }
 
 void RhrServer::setDepthCodec(CompressionParameters::DepthCodec value)
 {
+    if (m_imageParam.depthParam.depthCodec != value)
+        resetTileHashes();
     m_imageParam.depthParam.depthCodec = value;
 }
 
@@ -122,16 +166,22 @@ void RhrServer::setDepthCompression(message::CompressionMode mode)
 
 void RhrServer::setDepthPrecision(int bits)
 {
+    if (m_imageParam.depthParam.depthPrecision != bits)
+        resetTileHashes();
     m_imageParam.depthParam.depthPrecision = bits;
 }
 
 void RhrServer::setLinearDepth(bool linear)
 {
+    if (m_imageParam.depthParam.depthGL != !linear)
+        resetTileHashes();
     m_imageParam.depthParam.depthGL = !linear;
 }
 
 void RhrServer::setZfpMode(CompressionParameters::ZfpMode mode)
 {
+    if (m_imageParam.depthParam.depthZfpMode != mode)
+        resetTileHashes();
     m_imageParam.depthParam.depthZfpMode = mode;
 }
 
@@ -140,6 +190,43 @@ void RhrServer::setDumpImages(bool enable)
     m_dumpImages = enable;
 }
 
+void RhrServer::setMaxFramesInFlight(unsigned num)
+{
+    m_maxFramesInFlight = std::max(1u, num);
+}
+
+void RhrServer::setLatencyBudget(double seconds)
+{
+    m_latencyBudget = seconds;
+}
+
+void RhrServer::addCompositeTime(double seconds)
+{
+    m_compositeTime += seconds;
+}
+
+RhrServer::FrameStats RhrServer::frameStats() const
+{
+    std::lock_guard<std::mutex> locker(m_taskMutex);
+    return m_stats;
+}
+
+void RhrServer::printFrameStats() const
+{
+    auto s = frameStats();
+    if (s.frames == 0)
+        return;
+    auto ms = [&s](double t) -> double {
+        return t / s.frames * 1e3;
+    };
+    CERR << "frame stats: " << s.frames << " frames, " << s.tiles << " tiles (" << s.tilesUnchanged
+         << " unchanged), " << s.bytes << " bytes" << std::endl;
+    CERR << "  avg. per frame: " << std::fixed << std::setprecision(2) << ms(s.frameInterval) << " ms interval, "
+         << ms(s.compositeTime) << " ms composite, " << ms(s.encodeTime) << " ms encode (" << ms(s.encodeCpuTime)
+         << " ms cpu), " << ms(s.sendTime) << " ms send, " << ms(s.waitTime) << " ms blocked" << std::endl;
+    CERR << "  latency: " << ms(s.latency) << " ms avg., " << s.maxLatency * 1e3 << " ms max." << std::endl;
+}
+
 unsigned short RhrServer::port() const
 {
     return m_port;
@@ -287,22 +374,29 @@ void RhrServer::init()
     m_imageParam.depthParam.depthZfpMode = CompressionParameters::ZfpFixedRate;
 
     m_resizeBlocked = false;
-    m_queuedTiles = 0;
-    m_firstTile = false;
+
+    if (const char *report = getenv("VISTLE_RHR_STATS")) {
+        m_reportStats = atoi(report);
+    }
 
     resetClient();
 }
 
 void RhrServer::resetClient()
 {
-    finishTiles(RhrServer::ViewParameters(), true /* finish */, false /* send */);
+    discardFrames();
     joinWorkerThreads();
+    m_resizeBlocked = false;
 
     ++m_updateCount;
     ++lightsUpdateCount;
-    if (m_clientSocket)
-        m_clientSocket->close();
-    m_clientSocket.reset();
+    {
+        std::lock_guard<std::mutex> locker(m_sendMutex);
+        if (m_clientSocket)
+            m_clientSocket->close();
+        m_clientSocket.reset();
+    }
+    m_sendFailed = false;
     lightsUpdateCount = 0;
     m_clientVariants.clear();
     m_viewData.clear();
@@ -361,7 +455,10 @@ void RhrServer::handleAccept(asio::ip::tcp::acceptor &a, std::shared_ptr<asio::i
     }
 
     CERR << "incoming connection, accepting new client" << std::endl;
-    m_clientSocket = sock;
+    {
+        std::lock_guard<std::mutex> locker(m_sendMutex);
+        m_clientSocket = sock;
+    }
 
     send(message::Identify());
     initializeConnection();
@@ -410,7 +507,10 @@ bool RhrServer::makeConnection(const std::string &host, unsigned short port, int
         return false;
     }
 
-    m_clientSocket = sock;
+    {
+        std::lock_guard<std::mutex> locker(m_sendMutex);
+        m_clientSocket = sock;
+    }
 
     m_destHost = host;
     m_destPort = port;
@@ -430,6 +530,8 @@ bool RhrServer::makeConnection(const std::string &host, unsigned short port, int
 
 bool RhrServer::initializeConnection()
 {
+    resetTileHashes();
+
     animationMsg anim;
     anim.current = m_imageParam.timestep;
     anim.total = m_numTimesteps;
@@ -477,6 +579,7 @@ void RhrServer::resize(size_t viewNum, int w, int h)
 
         vd.rgba.resize(w * h * 4);
         vd.depth.resize(w * h);
+        vd.tileHashes.clear();
     }
 }
 
@@ -651,6 +754,9 @@ bool RhrServer::handleVariant(std::shared_ptr<RhrServer::socket> sock, const var
 //! this is called before every frame, used for polling for RFB messages
 void RhrServer::preFrame()
 {
+    if (m_sendFailed)
+        resetClient();
+
     m_io.poll();
     if (!isConnected())
         return;
@@ -753,6 +859,9 @@ void RhrServer::preFrame()
 void RhrServer::invalidate(int viewNum, int x, int y, int w, int h, const RhrServer::ViewParameters &param,
                            bool lastView)
 {
+    if (m_sendFailed)
+        resetClient();
+
     if (isConnected())
         encodeAndSend(viewNum, x, y, w, h, param, lastView);
 }
@@ -799,17 +908,69 @@ tileMsg *newTileMsg(const RhrServer::ImageParameters &param, const RhrServer::Vi
     return message;
 }
 
+//! hash of a tile of 4 byte pixels within an image with line length stride
+uint64_t hashTile(const unsigned char *image, int x, int y, int w, int h, int stride, uint64_t seed)
+{
+    const uint64_t k1 = 0x9e3779b185ebca87ULL, k2 = 0xc2b2ae3d27d4eb4fULL;
+    auto mix = [k1, k2](uint64_t hash, uint64_t v) -> uint64_t {
+        hash ^= v * k2;
+        hash = (hash << 31) | (hash >> 33);
+        return hash * k1;
+    };
+
+    const size_t rowBytes = size_t(w) * 4;
+    uint64_t hash = mix(seed, rowBytes * h);
+    for (int yy = y; yy < y + h; ++yy) {
+        const unsigned char *row = image + (size_t(yy) * stride + x) * 4;
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= rowBytes; i += sizeof(uint64_t)) {
+            uint64_t v;
+            memcpy(&v, row + i, sizeof(v));
+            hash = mix(hash, v);
+        }
+        if (i < rowBytes) {
+            uint64_t v = 0;
+            memcpy(&v, row + i, rowBytes - i);
+            hash = mix(hash, v);
+        }
+    }
+    hash ^= hash >> 29;
+    hash *= k2;
+    hash ^= hash >> 32;
+    return hash;
+}
+
 } // namespace
 
+struct RhrServer::ViewData::Image {
+    std::vector<unsigned char> rgba;
+    std::vector<float> depth;
+};
+
+//! hash of tile last sent at a position, updated by encoder threads in the order in which tiles have been queued
+struct TileState {
+    std::mutex mutex;
+    std::condition_variable cond;
+    uint64_t hash = 0;
+    uint64_t queued = 0; //!< number of tasks queued for this tile
+    uint64_t done = 0; //!< number of tasks that have compared their hash
+};
+
 struct EncodeTask {
     float *depth = nullptr;
     unsigned char *rgba = nullptr;
     tileMsg *message = nullptr;
-    const RhrServer::ImageParameters &param;
+    const RhrServer::ImageParameters param;
     int viewNum;
     int x, y, w, h, stride;
     int bpp;
     bool subsamp;
+    std::shared_ptr<RhrServer::ViewData::Image> image; //!< keeps rgba and depth alive
+    std::shared_ptr<RhrServer::Frame> frame;
+    //! tile sent previously at same position, skip encoding if unchanged
+    std::shared_ptr<TileState> tile;
+    uint64_t tileSeq = 0; //!< position in sequence of tasks for this tile
+    bool forceSend = false; //!< update hash, but send even if unchanged
     RhrServer::EncodeResult result;
 
     EncodeTask() = delete;
@@ -911,6 +1072,30 @@ struct EncodeTask {
     {
         auto &msg = *message;
         RhrServer::EncodeResult result(message);
+
+        if (tile) {
+            // encoding parameters are part of the hash, so that a change of codec forces an update
+            const unsigned char *image = depth ? reinterpret_cast<const unsigned char *>(depth) : rgba;
+            const uint64_t seed = (uint64_t(msg.format) << 16) | msg.compression;
+            const uint64_t hash = hashTile(image, x, y, w, h, stride, seed);
+            bool unchanged = false;
+            {
+                // same tile of previous frame might still be encoded by another thread
+                std::unique_lock<std::mutex> locker(tile->mutex);
+                tile->cond.wait(locker, [this]() { return tile->done + 1 == tileSeq; });
+                unchanged = !forceSend && hash == tile->hash;
+                tile->hash = hash;
+                ++tile->done;
+            }
+            tile->cond.notify_all();
+            if (unchanged) {
+                msg.flags |= rfbTileUnchanged;
+                msg.unzippedsize = msg.size = 0;
+                result.rhrMessage = std::make_unique<RemoteRenderMessage>(msg, 0);
+                return result;
+            }
+        }
+
         message::CompressionMode compress = message::CompressionNone;
         if (depth) {
             compress = param.depthParam.depthCompress;
@@ -941,10 +1126,23 @@ void RhrServer::encodeAndSend(int viewNum, int x0, int y0, int w, int h, const R
                               bool lastView)
 {
     //std::cerr << "encodeAndSend: view=" << viewNum << ", c=" << (void *)rgba(viewNum) << ", d=" << depth(viewNum) << std::endl;
-    if (!m_resizeBlocked) {
-        m_firstTile = true;
+    if (!m_currentFrame) {
+        // first view of a new frame
+        auto frame = std::make_shared<Frame>();
+        frame->number = m_framecount;
+        frame->modificationCount = m_modificationCount;
+        frame->submitTime = Clock::time();
+
+        std::lock_guard<std::mutex> locker(m_taskMutex);
+        m_frames.emplace_back(frame);
+        m_currentFrame = frame;
+        if (!m_sendThread.joinable()) {
+            m_quit = false;
+            m_sendThread = std::thread([this]() { sendLoop(); });
+        }
     }
     m_resizeBlocked = true;
+    auto frame = m_currentFrame;
 
     if (m_dumpImages && viewNum >= 0 && size_t(viewNum) < m_viewData.size()) {
         std::stringstream cn, dn, dnfull;
@@ -978,22 +1176,39 @@ void RhrServer::encodeAndSend(int viewNum, int x0, int y0, int w, int h, const R
     const int tileWidth = m_tileWidth, tileHeight = m_tileHeight;
 
     if (viewNum >= 0) {
+        auto &vd = m_viewData[viewNum];
+        const bool resend = vd.resendTiles;
+        vd.resendTiles = false;
+        auto image = snapshotImage(viewNum, x0, y0, w, h);
         for (int y = y0; y < y0 + h; y += tileHeight) {
             for (int x = x0; x < x0 + w; x += tileWidth) {
+                const int tw = std::min(tileWidth, x0 + w - x), th = std::min(tileHeight, y0 + h - y);
+
                 // depth
-                auto dt =
-                    std::make_shared<EncodeTask>(viewNum, x, y, std::min(tileWidth, x0 + w - x),
-                                                 std::min(tileHeight, y0 + h - y), depth(viewNum), m_imageParam, param);
+                auto dt = std::make_shared<EncodeTask>(viewNum, x, y, tw, th, image->depth.data(), m_imageParam, param);
+                auto &dtile = vd.tileHashes[{x, y, tw, th, 1}];
+                if (!dtile)
+                    dtile = std::make_shared<TileState>();
+                dt->tile = dtile;
+                dt->tileSeq = ++dtile->queued;
 
                 // color
-                auto ct =
-                    std::make_shared<EncodeTask>(viewNum, x, y, std::min(tileWidth, x0 + w - x),
-                                                 std::min(tileHeight, y0 + h - y), rgba(viewNum), m_imageParam, param);
+                auto ct = std::make_shared<EncodeTask>(viewNum, x, y, tw, th, image->rgba.data(), m_imageParam, param);
+                auto &ctile = vd.tileHashes[{x, y, tw, th, 0}];
+                if (!ctile)
+                    ctile = std::make_shared<TileState>();
+                ct->tile = ctile;
+                ct->tileSeq = ++ctile->queued;
+
+                for (auto &t: {dt, ct}) {
+                    t->image = image;
+                    t->frame = frame;
+                    t->forceSend = resend;
+                }
 
                 std::unique_lock locker(m_taskMutex);
-                ++m_queuedTiles;
+                frame->queuedTiles += 2;
                 m_queuedTasks.emplace_back(dt);
-                ++m_queuedTiles;
                 m_queuedTasks.emplace_back(ct);
             }
         }
@@ -1013,10 +1228,17 @@ void RhrServer::encodeAndSend(int viewNum, int x0, int y0, int w, int h, const R
                 m_queuedTasks.pop_front();
                 locker.unlock();
 
+                double start = Clock::time();
                 task->result = task->work();
+                double end = Clock::time();
 
                 locker.lock();
-                m_finishedTasks.emplace_back(task);
+                m_stats.encodeCpuTime += end - start;
+                auto &frame = task->frame;
+                frame->encodedTime = std::max(frame->encodedTime, end);
+                frame->finishedTasks.emplace_back(task);
+                task->image.reset();
+                m_frameCond.notify_all();
             }
             m_doneWorkers.emplace(std::this_thread::get_id());
             locker.unlock();
@@ -1025,64 +1247,190 @@ void RhrServer::encodeAndSend(int viewNum, int x0, int y0, int w, int h, const R
 
         locker.lock();
     }
+
+    if (lastView || viewNum < 0) {
+        frame->param = param;
+        frame->timestep = param.timestep;
+        frame->imageParam = m_imageParam;
+        frame->compositeTime = m_compositeTime;
+        frame->complete = true;
+        m_frameCond.notify_all();
+
+        double now = Clock::time();
+        if (m_lastFrameTime >= 0.)
+            m_stats.frameInterval += now - m_lastFrameTime;
+        m_lastFrameTime = now;
+    }
     locker.unlock();
 
-    finishTiles(param, lastView || viewNum < 0);
+    if (lastView || viewNum < 0) {
+        m_currentFrame.reset();
+        m_compositeTime = 0.;
+        ++m_framecount;
+
+        // images have been copied, so views may be resized while tiles are still being encoded
+        m_resizeBlocked = false;
+        deferredResize();
+
+        waitForFrames(m_maxFramesInFlight, m_latencyBudget);
+    }
     joinWorkerThreads();
 }
 
-bool RhrServer::finishTiles(const RhrServer::ViewParameters &param, bool finish, bool sendTiles)
+std::shared_ptr<RhrServer::ViewData::Image> RhrServer::snapshotImage(int viewNum, int x, int y, int w, int h)
 {
-    bool tileReady = false;
-    do {
+    auto &vd = m_viewData[viewNum];
+
+    std::shared_ptr<ViewData::Image> image;
+    for (auto &img: vd.images) {
+        // not referenced by encoder tasks anymore
+        if (img.use_count() == 1) {
+            image = img;
+            break;
+        }
+    }
+    if (!image) {
+        image = std::make_shared<ViewData::Image>();
+        vd.images.emplace_back(image);
+    }
+
+    if (x == 0 && y == 0 && w == vd.param.width && h == vd.param.height) {
+        // whole view will be rendered anew, so avoid copying
+        std::swap(image->rgba, vd.rgba);
+        std::swap(image->depth, vd.depth);
+        vd.rgba.resize(image->rgba.size());
+        vd.depth.resize(image->depth.size());
+    } else {
+        image->rgba = vd.rgba;
+        image->depth = vd.depth;
+    }
+
+    return image;
+}
+
+void RhrServer::resetTileHashes()
+{
+    for (auto &vd: m_viewData)
+        vd.resendTiles = true;
+}
+
+void RhrServer::sendLoop()
+{
+    setThreadName("RHR:Send");
+
+    auto ready = [this]() {
+        if (m_frames.empty())
+            return false;
+        auto &frame = m_frames.front();
+        return !frame->finishedTasks.empty() || (frame->complete && frame->queuedTiles == 0);
+    };
+
+    std::unique_lock<std::mutex> locker(m_taskMutex);
+    for (;;) {
+        m_frameCond.wait(locker, [this, &ready]() { return m_quit || ready(); });
+        if (!ready()) {
+            assert(m_quit);
+            break;
+        }
+
+        auto frame = m_frames.front();
         buffer payload;
-        tileReady = false;
         std::unique_ptr<RemoteRenderMessage> msg;
-        if (m_queuedTiles == 0 && finish) {
-            auto *tm = newTileMsg(m_imageParam, param, -1, 0, 0, 0, 0);
+        if (!frame->finishedTasks.empty()) {
+            auto task = frame->finishedTasks.front();
+            frame->finishedTasks.pop_front();
+            --frame->queuedTiles;
+            auto &result = task->result;
+            msg = std::move(result.rhrMessage);
+            payload = std::move(result.payload);
+        } else {
+            // all tiles have been sent before last view was submitted: terminate frame with an empty tile
+            auto *tm = newTileMsg(frame->imageParam, frame->param, -1, 0, 0, 0, 0);
             msg = std::make_unique<RemoteRenderMessage>(*tm);
             delete tm;
-        } else {
-            std::lock_guard<std::mutex> locker(m_taskMutex);
-            if (!m_finishedTasks.empty()) {
-                auto &task = m_finishedTasks.front();
-                auto &result = task->result;
-                msg = std::move(result.rhrMessage);
-                payload = std::move(result.payload);
-                m_finishedTasks.pop_front();
-                --m_queuedTiles;
-                tileReady = true;
-            }
         }
-        if (msg) {
-            tileMsg &tm = static_cast<tileMsg &>(msg->rhr());
-            tm.timestep = param.timestep;
-            if (m_firstTile) {
-                tm.flags |= rfbTileFirst;
-                //std::cerr << "first tile: req=" << msg.requestNumber << std::endl;
-            }
-            m_firstTile = false;
-            if (m_queuedTiles == 0 && finish) {
-                tm.flags |= rfbTileLast;
-                //std::cerr << "last tile: req=" << msg.requestNumber << std::endl;
+
+        const bool first = !frame->firstSent;
+        frame->firstSent = true;
+        const bool last = frame->complete && frame->queuedTiles == 0;
+        const bool discard = frame->discard;
+        locker.unlock();
+
+        tileMsg &tm = static_cast<tileMsg &>(msg->rhr());
+        if (first) {
+            tm.flags |= rfbTileFirst;
+            //std::cerr << "first tile: req=" << tm.requestNumber << std::endl;
+        }
+        if (last) {
+            tm.flags |= rfbTileLast;
+            tm.timestep = frame->timestep;
+            //std::cerr << "last tile: req=" << tm.requestNumber << std::endl;
+        }
+        tm.frameNumber = frame->number;
+        double start = Clock::time();
+        if (!discard && !m_sendFailed)
+            sendTile(*msg, frame->modificationCount, &payload);
+        double end = Clock::time();
+
+        bool report = false;
+        locker.lock();
+        m_stats.sendTime += end - start;
+        if (tm.viewNum >= 0) {
+            ++m_stats.tiles;
+            if (tm.flags & rfbTileUnchanged)
+                ++m_stats.tilesUnchanged;
+            m_stats.bytes += payload.size();
+        }
+        if (last) {
+            assert(m_frames.front() == frame);
+            m_frames.pop_front();
+            if (!discard) {
+                ++m_stats.frames;
+                m_stats.compositeTime += frame->compositeTime;
+                m_stats.encodeTime += std::max(0., frame->encodedTime - frame->submitTime);
+                const double latency = end - frame->submitTime;
+                m_stats.latency += latency;
+                m_stats.maxLatency = std::max(m_stats.maxLatency, latency);
+                report = m_reportStats > 0 && m_stats.frames % m_reportStats == 0;
             }
-            tm.frameNumber = m_framecount;
-            if (sendTiles)
-                send(*msg, &payload);
+            m_frameCond.notify_all();
         }
-        if (m_queuedTiles > 0 && finish && !tileReady)
-            usleep(100);
-    } while (m_queuedTiles > 0 && (tileReady || finish));
 
-    if (finish) {
-        assert(m_queuedTiles == 0);
-        m_resizeBlocked = false;
-        deferredResize();
+        if (report) {
+            locker.unlock();
+            printFrameStats();
+            locker.lock();
+        }
+    }
+}
 
-        ++m_framecount;
+void RhrServer::waitForFrames(size_t maxFrames, double latencyBudget)
+{
+    double start = Clock::time();
+    std::unique_lock<std::mutex> locker(m_taskMutex);
+    m_frameCond.wait(locker, [this, maxFrames, latencyBudget]() {
+        if (m_frames.size() >= maxFrames)
+            return false;
+        if (latencyBudget > 0. && !m_frames.empty() && Clock::time() - m_frames.front()->submitTime > latencyBudget)
+            return false;
+        return true;
+    });
+    m_stats.waitTime += Clock::time() - start;
+}
+
+void RhrServer::discardFrames()
+{
+    std::unique_lock<std::mutex> locker(m_taskMutex);
+    for (auto &frame: m_frames) {
+        frame->discard = true;
+        frame->complete = true;
     }
+    m_frameCond.notify_all();
+    m_frameCond.wait(locker, [this]() { return m_frames.empty(); });
+    locker.unlock();
 
-    return m_queuedTiles == 0;
+    m_currentFrame.reset();
+    m_compositeTime = 0.;
 }
 
 bool RhrServer::joinWorkerThreads()
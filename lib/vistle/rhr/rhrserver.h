@@ -10,11 +10,17 @@
 #ifndef RHR_SERVER_H
 #define RHR_SERVER_H
 
+#include <array>
 #include <vector>
 #include <deque>
 #include <string>
 #include <map>
 #include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
 
 #include <boost/asio.hpp>
 
@@ -33,6 +39,7 @@ namespace asio = boost::asio;
 using message::RemoteRenderMessage;
 class MessageSender;
 struct EncodeTask;
+struct TileState;
 
 //! Implement remote hybrid rendering server
 class V_RHREXPORT RhrServer {
@@ -84,6 +91,29 @@ public:
     void setZfpMode(CompressionParameters::ZfpMode mode);
     void setLinearDepth(bool linear);
     void setDumpImages(bool enable);
+    //! number of frames that may be encoded and sent while rendering proceeds, 1 for sending each frame before the next one
+    void setMaxFramesInFlight(unsigned num);
+    //! block rendering while the oldest frame in flight has been submitted more than seconds ago, 0 for no limit
+    void setLatencyBudget(double seconds);
+    //! account time spent for compositing to the frame currently being submitted
+    void addCompositeTime(double seconds);
+
+    struct FrameStats {
+        size_t frames = 0; //!< number of frames sent completely
+        size_t tiles = 0; //!< number of color and depth tiles sent
+        size_t tilesUnchanged = 0; //!< tiles skipped because they did not change
+        size_t bytes = 0; //!< tile payload sent
+        double frameInterval = 0.; //!< accumulated time between submission of last views of consecutive frames
+        double compositeTime = 0.; //!< accumulated time reported by addCompositeTime
+        double encodeTime = 0.; //!< accumulated time from submission of first view until all tiles were encoded
+        double encodeCpuTime = 0.; //!< accumulated time spent by encoder threads
+        double sendTime = 0.; //!< accumulated time spent writing tiles to the client
+        double latency = 0.; //!< accumulated time from submission of first view until last tile was sent
+        double maxLatency = 0.;
+        double waitTime = 0.; //!< accumulated time rendering was blocked by frames in flight
+    };
+    FrameStats frameStats() const;
+    void printFrameStats() const;
 
     int timestep() const;
     void setNumTimesteps(unsigned num);
@@ -232,6 +262,12 @@ public:
         int newWidth, newHeight; //!< in case resizing was blocked while message was received
         std::vector<unsigned char> rgba;
         std::vector<float> depth;
+        //! hashes of tiles last sent, indexed by x, y, width, height and whether it is a depth tile
+        std::map<std::array<int, 5>, std::shared_ptr<TileState>> tileHashes;
+        bool resendTiles = false; //!< send all tiles of next frame, even if unchanged
+        struct Image;
+        //! copies of rgba and depth handed to encoder threads, reused once all tiles have been encoded
+        std::vector<std::shared_ptr<Image>> images;
 
         ViewData(): newWidth(-1), newHeight(-1) {}
     };
@@ -271,7 +307,10 @@ private:
     void sendBoundsMessage(std::shared_ptr<socket> sock);
 
     void encodeAndSend(int viewNum, int x, int y, int w, int h, const ViewParameters &param, bool lastView);
-    bool finishTiles(const ViewParameters &param, bool wait, bool sendTiles = true);
+    //! force sending all tiles with the next frame
+    void resetTileHashes();
+    //! take over rgba and depth of a view for encoding, so that rendering of the next frame can proceed
+    std::shared_ptr<ViewData::Image> snapshotImage(int viewNum, int x, int y, int w, int h);
 
     struct EncodeResult {
         EncodeResult() = default;
@@ -284,14 +323,50 @@ private:
 
     friend struct EncodeTask;
 
-    std::mutex m_taskMutex;
+    mutable std::mutex m_taskMutex; //!< protects task queue, frames in flight and statistics
+    std::condition_variable m_frameCond; //!< signalled when a tile has been encoded or sent
     typedef std::deque<std::shared_ptr<EncodeTask>> TaskQueue;
-    TaskQueue m_queuedTasks, m_finishedTasks;
+    TaskQueue m_queuedTasks;
     std::map<std::thread::id, std::thread> m_workers;
     std::set<std::thread::id> m_doneWorkers;
     bool joinWorkerThreads();
-    size_t m_queuedTiles;
-    bool m_firstTile;
+
+    //! state of a frame from submission of its first view until its last tile has been sent
+    struct Frame {
+        int number = 0;
+        int timestep = -1;
+        ViewParameters param; //!< parameters of view submitted last, used for terminating empty tile
+        ImageParameters imageParam;
+        size_t modificationCount = 0;
+        bool complete = false; //!< all views have been submitted
+        bool discard = false; //!< client has been reset, don't send remaining tiles
+        bool firstSent = false;
+        size_t queuedTiles = 0; //!< tiles not yet sent
+        TaskQueue finishedTasks; //!< tiles encoded, but not yet sent
+        double submitTime = 0.; //!< time of submission of first view
+        double encodedTime = 0.; //!< time last tile was encoded
+        double compositeTime = 0.;
+    };
+    std::deque<std::shared_ptr<Frame>> m_frames; //!< frames in flight, in order of submission
+    std::shared_ptr<Frame> m_currentFrame; //!< frame whose views are being submitted
+    unsigned m_maxFramesInFlight = 2;
+    double m_latencyBudget = 0.;
+    double m_compositeTime = 0.; //!< composite time accumulated for current frame
+    double m_lastFrameTime = -1.;
+    FrameStats m_stats;
+    int m_reportStats = 0; //!< print statistics after so many frames, from VISTLE_RHR_STATS
+
+    //! send encoded tiles of frames in flight in order
+    std::thread m_sendThread;
+    bool m_quit = false;
+    std::mutex m_sendMutex; //!< serializes writes to client socket and modifications of m_clientSocket
+    std::atomic<bool> m_sendFailed{false}; //!< sending tiles failed, client has to be reset from main thread
+    void sendLoop();
+    bool sendTile(const RemoteRenderMessage &msg, size_t modificationCount, const buffer *payload);
+    //! block until less than maxFrames frames are in flight and the oldest one is within the latency budget
+    void waitForFrames(size_t maxFrames, double latencyBudget);
+    //! drop tiles of all frames in flight and wait until they have been drained
+    void discardFrames();
 
     void deferredResize();
 
@@ -0,0 +1,146 @@
+#include "simd.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if defined(VISTLE_RHR_SIMD) && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace vistle {
+namespace simd {
+
+namespace {
+
+#if defined(VISTLE_RHR_SIMD) && defined(_MSC_VER)
+bool cpuHas(Isa isa)
+{
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    if (maxLeaf < 1)
+        return false;
+
+    __cpuidex(info, 1, 0);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (isa == SSE4)
+        return sse41;
+    if (!osxsave || !avx || maxLeaf < 7)
+        return false;
+
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    const bool ymm = (xcr0 & 0x6) == 0x6;
+    const bool zmm = (xcr0 & 0xe6) == 0xe6;
+    if (isa == AVX2)
+        return ymm && (info[1] & (1 << 5)) != 0;
+    if (isa == AVX512)
+        return zmm && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+    return false;
+}
+#elif defined(VISTLE_RHR_SIMD)
+bool cpuHas(Isa isa)
+{
+    __builtin_cpu_init();
+    switch (isa) {
+    case SSE4:
+        return __builtin_cpu_supports("sse4.1");
+    case AVX2:
+        return __builtin_cpu_supports("avx2");
+    case AVX512:
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    default:
+        break;
+    }
+    return false;
+}
+#else
+bool cpuHas(Isa isa)
+{
+    return false;
+}
+#endif
+
+Isa initialIsa()
+{
+    Isa isa = bestIsa();
+    if (const char *env = getenv("VISTLE_RHR_ISA")) {
+        bool found = false;
+        for (int i = Scalar; i < NumIsa; ++i) {
+            if (strcmp(env, toString(Isa(i))) == 0) {
+                found = true;
+                if (isSupported(Isa(i))) {
+                    isa = Isa(i);
+                } else {
+                    std::cerr << "VISTLE_RHR_ISA: " << env << " not supported, using " << toString(isa) << std::endl;
+                }
+            }
+        }
+        if (!found)
+            std::cerr << "VISTLE_RHR_ISA: unknown instruction set " << env << std::endl;
+    }
+    return isa;
+}
+
+std::atomic<int> &selectedIsa()
+{
+    static std::atomic<int> isa(initialIsa());
+    return isa;
+}
+
+} // namespace
+
+const char *toString(Isa isa)
+{
+    switch (isa) {
+    case Scalar:
+        return "scalar";
+    case SSE4:
+        return "sse4";
+    case AVX2:
+        return "avx2";
+    case AVX512:
+        return "avx512";
+    case NumIsa:
+        break;
+    }
+    return "invalid";
+}
+
+bool isSupported(Isa isa)
+{
+    static const bool supported[NumIsa] = {true, cpuHas(SSE4), cpuHas(AVX2), cpuHas(AVX512)};
+    if (isa < Scalar || isa >= NumIsa)
+        return false;
+    return supported[isa];
+}
+
+Isa bestIsa()
+{
+    for (int i = NumIsa - 1; i > Scalar; --i) {
+        if (isSupported(Isa(i)))
+            return Isa(i);
+    }
+    return Scalar;
+}
+
+Isa currentIsa()
+{
+    return Isa(selectedIsa().load());
+}
+
+bool setIsa(Isa isa)
+{
+    if (!isSupported(isa))
+        return false;
+    selectedIsa() = isa;
+    return true;
+}
+
+} // namespace simd
+} // namespace vistle
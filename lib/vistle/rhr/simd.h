@@ -0,0 +1,42 @@
+#ifndef VISTLE_RHR_SIMD_H
+#define VISTLE_RHR_SIMD_H
+
+#include "export.h"
+
+// vector kernels for x86 are compiled into the library alongside their scalar counterparts,
+// the variant to use is selected at runtime depending on CPU features
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#if defined(__GNUC__) || defined(__clang__)
+#define VISTLE_RHR_SIMD
+#define V_TARGET(features) __attribute__((target(features)))
+#elif defined(_MSC_VER)
+#define VISTLE_RHR_SIMD
+#define V_TARGET(features)
+#endif
+#endif
+
+namespace vistle {
+namespace simd {
+
+//! instruction set extensions for which depth quantization and prediction kernels are available
+enum Isa {
+    Scalar, //< portable C++
+    SSE4, //< SSE4.1
+    AVX2, //< AVX2
+    AVX512, //< AVX-512F and AVX-512BW
+    NumIsa
+};
+
+V_RHREXPORT const char *toString(Isa isa);
+//! whether kernels for isa have been compiled and are supported by the CPU
+V_RHREXPORT bool isSupported(Isa isa);
+//! most capable instruction set supported by the CPU
+V_RHREXPORT Isa bestIsa();
+//! instruction set used by kernels, initialized from VISTLE_RHR_ISA (scalar, sse4, avx2 or avx512) or bestIsa()
+V_RHREXPORT Isa currentIsa();
+//! select instruction set for kernels, e.g. for benchmarking - fails if not supported
+V_RHREXPORT bool setIsa(Isa isa);
+
+} // namespace simd
+} // namespace vistle
+#endif
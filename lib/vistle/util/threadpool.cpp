@@ -0,0 +1,125 @@
+#include "threadpool.h"
+#include "threadname.h"
+
+namespace vistle {
+
+namespace {
+thread_local const ThreadPool *t_pool = nullptr;
+thread_local int t_worker = -1;
+} // namespace
+
+ThreadPool::ThreadPool(unsigned numThreads, const std::string &name)
+{
+    if (numThreads == 0)
+        numThreads = std::thread::hardware_concurrency();
+    if (numThreads == 0)
+        numThreads = 1;
+
+    for (unsigned i = 0; i < numThreads; ++i) {
+        m_queues.emplace_back(std::make_unique<Queue>());
+    }
+    for (unsigned i = 0; i < numThreads; ++i) {
+        m_threads.emplace_back([this, i, name]() {
+            setThreadName(name + ":" + std::to_string(i));
+            t_pool = this;
+            t_worker = i;
+            run(i);
+            t_worker = -1;
+            t_pool = nullptr;
+        });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_quit = true;
+    }
+    m_cond.notify_all();
+    for (auto &t: m_threads)
+        t.join();
+}
+
+unsigned ThreadPool::size() const
+{
+    return m_threads.size();
+}
+
+size_t ThreadPool::pending() const
+{
+    long p = m_pending;
+    return p > 0 ? p : 0;
+}
+
+int ThreadPool::currentWorker()
+{
+    return t_worker;
+}
+
+void ThreadPool::enqueue(Job job)
+{
+    unsigned idx = 0;
+    if (t_pool == this && t_worker >= 0) {
+        idx = t_worker;
+    } else {
+        idx = m_next++ % m_queues.size();
+    }
+
+    {
+        auto &q = *m_queues[idx];
+        std::lock_guard<std::mutex> guard(q.mutex);
+        q.jobs.emplace_back(std::move(job));
+    }
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ++m_pending;
+    }
+    m_cond.notify_one();
+}
+
+bool ThreadPool::pop(unsigned idx, Job &job)
+{
+    auto &q = *m_queues[idx];
+    std::lock_guard<std::mutex> guard(q.mutex);
+    if (q.jobs.empty())
+        return false;
+    job = std::move(q.jobs.back());
+    q.jobs.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(unsigned idx, Job &job)
+{
+    const unsigned n = m_queues.size();
+    for (unsigned i = 1; i < n; ++i) {
+        auto &q = *m_queues[(idx + i) % n];
+        std::unique_lock<std::mutex> guard(q.mutex, std::try_to_lock);
+        if (!guard.owns_lock() || q.jobs.empty())
+            continue;
+        job = std::move(q.jobs.front());
+        q.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run(unsigned idx)
+{
+    for (;;) {
+        Job job;
+        if (pop(idx, job) || steal(idx, job)) {
+            --m_pending;
+            job();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(m_mutex);
+        if (m_quit && m_pending <= 0)
+            break;
+        // m_pending also counts jobs skipped because of contended queue locks, so these are retried immediately
+        m_cond.wait(guard, [this]() { return m_quit || m_pending > 0; });
+    }
+}
+
+} // namespace vistle
@@ -0,0 +1,77 @@
+#ifndef VISTLE_UTIL_THREADPOOL_H
+#define VISTLE_UTIL_THREADPOOL_H
+
+#include "export.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vistle {
+
+/**
+ \class ThreadPool
+
+ \brief persistent pool of worker threads with per-worker job queues and work stealing
+
+ Jobs enqueued from a worker thread are pushed to that worker's own queue and processed LIFO,
+ jobs enqueued from other threads are distributed round-robin.
+ Idle workers steal the oldest job from the queues of other workers.
+ */
+class V_UTILEXPORT ThreadPool {
+public:
+    typedef std::function<void()> Job;
+
+    //! create pool with numThreads workers (0: std::thread::hardware_concurrency())
+    explicit ThreadPool(unsigned numThreads = 0, const std::string &name = "pool");
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const;
+    //! number of jobs that have been enqueued but not yet started
+    size_t pending() const;
+
+    void enqueue(Job job);
+
+    template<class F>
+    auto submit(F &&f) -> std::future<decltype(f())>
+    {
+        typedef decltype(f()) Result;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+        auto future = task->get_future();
+        enqueue([task]() { (*task)(); });
+        return future;
+    }
+
+    //! index of calling worker thread within its pool, -1 if not called from a pool thread
+    static int currentWorker();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    bool pop(unsigned idx, Job &job);
+    bool steal(unsigned idx, Job &job);
+    void run(unsigned idx);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::atomic<long> m_pending{0};
+    std::atomic<unsigned> m_next{0};
+    bool m_quit = false;
+};
+
+} // namespace vistle
+#endif
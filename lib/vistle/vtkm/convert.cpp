@@ -2,6 +2,8 @@
 #include <vtkm/cont/ArrayCopy.h>
 #include <vtkm/cont/ArrayExtractComponent.h>
 #include <vtkm/cont/ArrayHandleExtractComponent.h>
+#include <vtkm/cont/ArrayHandleSOA.h>
+#include <vtkm/cont/Invoker.h>
 #include <vtkm/cont/DataSetBuilderExplicit.h>
 #include <vtkm/cont/CellSetExplicit.h>
 
@@ -29,6 +31,69 @@
 
 namespace vistle {
 
+namespace {
+
+struct SplitVec2Worklet: vtkm::worklet::WorkletMapField {
+    using ControlSignature = void(FieldIn vecs, FieldOut x, FieldOut y);
+    using ExecutionSignature = void(_1, _2, _3);
+    using InputDomain = _1;
+
+    template<typename VecType, typename C>
+    VTKM_EXEC void operator()(const VecType &v, C &x, C &y) const
+    {
+        x = static_cast<C>(v[0]);
+        y = static_cast<C>(v[1]);
+    }
+};
+
+struct SplitVec3Worklet: vtkm::worklet::WorkletMapField {
+    using ControlSignature = void(FieldIn vecs, FieldOut x, FieldOut y, FieldOut z);
+    using ExecutionSignature = void(_1, _2, _3, _4);
+    using InputDomain = _1;
+
+    template<typename VecType, typename C>
+    VTKM_EXEC void operator()(const VecType &v, C &x, C &y, C &z) const
+    {
+        x = static_cast<C>(v[0]);
+        y = static_cast<C>(v[1]);
+        z = static_cast<C>(v[2]);
+    }
+};
+
+// store components of a VTK-m array of vectors in the component arrays of a vistle::Vec:
+// SoA arrays are adopted as they are, other layouts are split in a single pass directly into vistle memory
+template<class Data, typename T, typename S>
+void setComponents(Data *data, const vtkm::cont::ArrayHandle<T, S> &array)
+{
+    constexpr vtkm::IdComponent Dim = vtkm::VecTraits<T>::NUM_COMPONENTS;
+    static_assert(Dim == 2 || Dim == 3, "only 2 and 3 components supported");
+
+    if constexpr (std::is_same<S, vtkm::cont::StorageTagSOA>::value) {
+        vtkm::cont::ArrayHandleSOA<T> soa(array);
+        for (vtkm::IdComponent d = 0; d < Dim; ++d) {
+            data->x[d]->setHandle(soa.GetArray(d));
+        }
+    } else {
+        const auto n = array.GetNumberOfValues();
+        vtkm::cont::Invoker invoke;
+        auto x = data->x[0]->writeHandle(n);
+        auto y = data->x[1]->writeHandle(n);
+        if constexpr (Dim == 2) {
+            invoke(SplitVec2Worklet{}, array, x, y);
+            x.SyncControlArray();
+            y.SyncControlArray();
+        } else {
+            auto z = data->x[2]->writeHandle(n);
+            invoke(SplitVec3Worklet{}, array, x, y, z);
+            x.SyncControlArray();
+            y.SyncControlArray();
+            z.SyncControlArray();
+        }
+    }
+}
+
+} // namespace
+
 VtkmTransformStatus vtkmSetGrid(vtkm::cont::DataSet &vtkmDataset, vistle::Object::const_ptr grid)
 {
     if (auto coords = Coords::as(grid)) {
@@ -279,14 +344,6 @@ Object::ptr vtkmGetGeometry(vtkm::cont::DataSet &dataset)
 {
     Object::ptr result;
 
-    // get vertices that make up the dataset grid
-    auto uPointCoordinates = dataset.GetCoordinateSystem().GetData();
-
-    // we expect point coordinates to be stored as vtkm::Vec3 array handle
-    assert((uPointCoordinates.CanConvert<vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>>>() == true));
-
-    auto pointCoordinates =
-        uPointCoordinates.AsArrayHandle<vtkm::cont::ArrayHandle<vtkm::Vec<vtkm::FloatDefault, 3>>>();
     auto numPoints = dataset.GetNumberOfPoints();
 
     auto cellset = dataset.GetCellSet();
@@ -371,15 +428,13 @@ Object::ptr vtkmGetGeometry(vtkm::cont::DataSet &dataset)
     }
 
     if (auto coords = Coords::as(result)) {
-        vtkm::cont::UnknownArrayHandle unknown(pointCoordinates);
-        if (unknown.CanConvert<vtkm::cont::ArrayHandle<vtkm::Vec<Scalar, 3>>>()) {
-            auto vtkmCoord = unknown.AsArrayHandle<vtkm::cont::ArrayHandle<vtkm::Vec<Scalar, 3>>>();
-            for (int d = 0; d < 3; ++d) {
-                auto x = make_ArrayHandleExtractComponent(vtkmCoord, d);
-                coords->d()->x[d]->setHandle(x);
-            }
-        } else {
-            std::cerr << "cannot convert point coordinates" << std::endl;
+        // get vertices that make up the dataset grid
+        auto uPointCoordinates = dataset.GetCoordinateSystem().GetData();
+        try {
+            uPointCoordinates.CastAndCallForTypes<vtkm::TypeListFieldVec3, vtkm::cont::StorageListCommon>(
+                [&coords](const auto &array) { setComponents(coords->d(), array); });
+        } catch (vtkm::cont::ErrorBadType &err) {
+            std::cerr << "cannot convert point coordinates: " << err.what() << std::endl;
         }
 
         if (auto normals = vtkmGetField(dataset, "normals")) {
@@ -484,20 +539,18 @@ struct GetArrayContents {
             break;
         }
         case 2: {
-            auto data = std::make_shared<vistle::Vec<V, 2>>(array.GetNumberOfValues());
-            result = data;
-            for (int i = 0; i < numComponents; ++i) {
-                auto x = make_ArrayHandleExtractComponent(array, i);
-                data->d()->x[i]->setHandle(x);
+            if constexpr (VTraits::NUM_COMPONENTS == 2) {
+                auto data = std::make_shared<vistle::Vec<V, 2>>(0);
+                result = data;
+                setComponents(data->d(), array);
             }
             break;
         }
         case 3: {
-            auto data = std::make_shared<vistle::Vec<V, 3>>(array.GetNumberOfValues());
-            result = data;
-            for (int i = 0; i < numComponents; ++i) {
-                auto x = make_ArrayHandleExtractComponent(array, i);
-                data->d()->x[i]->setHandle(x);
+            if constexpr (VTraits::NUM_COMPONENTS == 3) {
+                auto data = std::make_shared<vistle::Vec<V, 3>>(0);
+                result = data;
+                setComponents(data->d(), array);
             }
             break;
         }
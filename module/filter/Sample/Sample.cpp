@@ -61,14 +61,16 @@ int Sample::SampleToGrid(const vistle::GeometryInterface *target, vistle::DataBa
     Vec<Scalar>::ptr dataOut(new Vec<Scalar>(numVert));
     Scalar *ptrOnData = dataOut->x().data();
 
+    std::vector<Vector3> vertices(numVert);
     for (Index i = 0; i < numVert; ++i) {
-        Vector3 v = target->getVertex(i);
-        Index cellIdxIn =
-            inGrid->findCell(v, InvalidIndex, m_useCelltree ? GridInterface::NoFlags : GridInterface::NoCelltree);
-        if (cellIdxIn != InvalidIndex) {
-            GridInterface::Interpolator interp = inGrid->getInterpolator(cellIdxIn, v, DataBase::Vertex, mode);
-            Scalar p = interp(data);
-            ptrOnData[i] = p;
+        vertices[i] = target->getVertex(i);
+    }
+    std::vector<Index> cells(numVert);
+    auto interp = inGrid->findCellsAndInterpolators(numVert, vertices.data(), cells.data(), DataBase::Vertex, mode,
+                                                    m_useCelltree ? GridInterface::NoFlags : GridInterface::NoCelltree);
+    for (Index i = 0; i < numVert; ++i) {
+        if (interp.valid(i)) {
+            ptrOnData[i] = interp(i, data);
             found = 1;
         } else {
             ptrOnData[i] = NO_VALUE;
@@ -16,6 +16,12 @@
 #include <vistle/module/resultcache.h>
 #include <vistle/alg/objalg.h>
 
+#include <boost/mpi/datatype.hpp>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
 #include "Color.h"
 
 #ifndef COLOR_RANDOM
@@ -365,97 +371,151 @@ Color::~Color()
 {}
 
 namespace {
-template<class V>
-void updateMinMax(typename V::const_ptr &v, Scalar &min, Scalar &max)
+
+#ifdef USE_OPENMP
+int numThreads()
 {
-    auto mmv = v->getMinMax();
-    std::tuple<Scalar, Scalar> mm{mmv.first[0], mmv.second[0]};
-    if (min > std::get<0>(mm))
-        min = std::get<0>(mm);
-    if (max < std::get<1>(mm))
-        max = std::get<1>(mm);
+    return omp_get_max_threads();
 }
-} // namespace
+int threadNum()
+{
+    return omp_get_thread_num();
+}
+#else
+int numThreads()
+{
+    return 1;
+}
+int threadNum()
+{
+    return 0;
+}
+#endif
 
-void Color::getMinMax(vistle::DataBase::const_ptr object, vistle::Scalar &min, vistle::Scalar &max)
+// value to be mapped for element i: scalar component or magnitude of vector
+template<typename T>
+struct ScalarValue {
+    const T *x;
+    Scalar operator()(ssize_t i) const { return x[i]; }
+};
+
+struct VectorMagnitude {
+    const Scalar *x, *y, *z;
+    Scalar operator()(ssize_t i) const { return std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]); }
+};
+
+// call func with accessor to the values of object to be mapped, returns false for unsupported types
+template<class Func>
+bool withValues(vistle::DataBase::const_ptr object, Func func)
 {
-    const ssize_t numElements = object->getSize();
+    if (Vec<Scalar>::const_ptr f = Vec<Scalar>::as(object)) {
+        func(ScalarValue<Scalar>{&f->x()[0]});
+    } else if (Vec<Index>::const_ptr f = Vec<Index>::as(object)) {
+        func(ScalarValue<Index>{&f->x()[0]});
+    } else if (Vec<Byte>::const_ptr f = Vec<Byte>::as(object)) {
+        func(ScalarValue<Byte>{&f->x()[0]});
+    } else if (Vec<Scalar, 3>::const_ptr f = Vec<Scalar, 3>::as(object)) {
+        func(VectorMagnitude{&f->x()[0], &f->y()[0], &f->z()[0]});
+    } else {
+        return false;
+    }
+    return true;
+}
 
-    if (Vec<Byte>::const_ptr scal = Vec<Byte>::as(object)) {
-        updateMinMax<Vec<Byte>>(scal, min, max);
-    } else if (Vec<Index>::const_ptr scal = Vec<Index>::as(object)) {
-        updateMinMax<Vec<Index>>(scal, min, max);
-    } else if (Vec<Scalar>::const_ptr scal = Vec<Scalar>::as(object)) {
-        updateMinMax<Vec<Scalar>>(scal, min, max);
-    } else if (Vec<Scalar, 3>::const_ptr vec = Vec<Scalar, 3>::as(object)) {
-        const vistle::Scalar *x = &vec->x()[0];
-        const vistle::Scalar *y = &vec->y()[0];
-        const vistle::Scalar *z = &vec->z()[0];
+// per-thread partial results are merged after the parallel region, inner loops are free of branches for vectorization
+template<class Values>
+void minMax(const Values &values, ssize_t numElements, Scalar &min, Scalar &max)
+{
+    std::vector<Scalar> tmin(numThreads(), min), tmax(numThreads(), max);
 #ifdef USE_OPENMP
 #pragma omp parallel
 #endif
-        {
-            Scalar tmin = std::numeric_limits<Scalar>::max();
-            Scalar tmax = -std::numeric_limits<Scalar>::max();
+    {
+        Scalar lmin = std::numeric_limits<Scalar>::max();
+        Scalar lmax = std::numeric_limits<Scalar>::lowest();
 #ifdef USE_OPENMP
 #pragma omp for
 #endif
-            for (ssize_t index = 0; index < numElements; index++) {
-                Scalar v = Vector3(x[index], y[index], z[index]).norm();
-                if (v < tmin)
-                    tmin = v;
-                if (v > tmax)
-                    tmax = v;
-            }
+        for (ssize_t index = 0; index < numElements; index++) {
+            const Scalar v = values(index);
+            lmin = v < lmin ? v : lmin;
+            lmax = v > lmax ? v : lmax;
+        }
+        tmin[threadNum()] = lmin;
+        tmax[threadNum()] = lmax;
+    }
+    for (size_t t = 0; t < tmin.size(); ++t) {
+        min = std::min(min, tmin[t]);
+        max = std::max(max, tmax[t]);
+    }
+}
+
+template<class V>
+bool cachedMinMax(vistle::DataBase::const_ptr object, Scalar &min, Scalar &max)
+{
+    auto v = V::as(object);
+    if (!v || !v->d()->x[0]->bounds_valid())
+        return false;
+    auto mm = v->getMinMax();
+    min = std::min(min, Scalar(mm.first[0]));
+    max = std::max(max, Scalar(mm.second[0]));
+    return true;
+}
+
+template<class Values>
+void histogram(const Values &values, ssize_t numElements, Scalar min, Scalar max, std::vector<unsigned long> &bins)
+{
+    const int numBins = bins.size();
+    const Scalar scale = numBins / (max - min);
+    std::vector<std::vector<unsigned long>> tbins(numThreads());
 #ifdef USE_OPENMP
-#pragma omp critical
+#pragma omp parallel
 #endif
-            {
-                if (tmin < min)
-                    min = tmin;
-                if (tmax > max)
-                    max = tmax;
-            }
+    {
+        auto &lbins = tbins[threadNum()];
+        lbins.resize(numBins);
+#ifdef USE_OPENMP
+#pragma omp for
+#endif
+        for (ssize_t index = 0; index < numElements; index++) {
+            const int bin = clamp<int>((values(index) - min) * scale, 0, numBins - 1);
+            ++lbins[bin];
         }
     }
+    for (const auto &lbins: tbins) {
+        for (size_t i = 0; i < lbins.size(); ++i)
+            bins[i] += lbins[i];
+    }
 }
 
-void Color::binData(vistle::DataBase::const_ptr object, std::vector<unsigned long> &binsVec)
+template<class Values>
+void texCoords(const Values &values, ssize_t numElements, Scalar min, Scalar max, Scalar *tc)
 {
-    const int numBins = binsVec.size();
+    const Scalar invRange = 1.f / (max - min);
+#ifdef USE_OPENMP
+#pragma omp parallel for
+#endif
+    for (ssize_t index = 0; index < numElements; index++)
+        tc[index] = (values(index) - min) * invRange;
+}
+
+} // namespace
 
+void Color::getMinMax(vistle::DataBase::const_ptr object, vistle::Scalar &min, vistle::Scalar &max)
+{
     const ssize_t numElements = object->getSize();
-    const Scalar w = m_max - m_min;
-    unsigned long *bins = binsVec.data();
 
-    if (Vec<Byte>::const_ptr scal = Vec<Byte>::as(object)) {
-        const vistle::Byte *x = &scal->x()[0];
-        for (ssize_t index = 0; index < numElements; index++) {
-            const int bin = clamp<int>((x[index] - m_min) / w * numBins, 0, numBins - 1);
-            ++bins[bin];
-        }
-    } else if (Vec<Index>::const_ptr scal = Vec<Index>::as(object)) {
-        const vistle::Index *x = &scal->x()[0];
-        for (ssize_t index = 0; index < numElements; index++) {
-            const int bin = clamp<int>((x[index] - m_min) / w * numBins, 0, numBins - 1);
-            ++bins[bin];
-        }
-    } else if (Vec<Scalar>::const_ptr scal = Vec<Scalar>::as(object)) {
-        const vistle::Scalar *x = &scal->x()[0];
-        for (ssize_t index = 0; index < numElements; index++) {
-            const int bin = clamp<int>((x[index] - m_min) / w * numBins, 0, numBins - 1);
-            ++bins[bin];
-        }
-    } else if (Vec<Scalar, 3>::const_ptr vec = Vec<Scalar, 3>::as(object)) {
-        const vistle::Scalar *x = &vec->x()[0];
-        const vistle::Scalar *y = &vec->y()[0];
-        const vistle::Scalar *z = &vec->z()[0];
-        for (ssize_t index = 0; index < numElements; index++) {
-            const Scalar v = Vector3(x[index], y[index], z[index]).norm();
-            const int bin = clamp<int>((v - m_min) / w * numBins, 0, numBins - 1);
-            ++bins[bin];
-        }
-    }
+    if (cachedMinMax<Vec<Scalar>>(object, min, max) || cachedMinMax<Vec<Index>>(object, min, max) ||
+        cachedMinMax<Vec<Byte>>(object, min, max))
+        return;
+
+    withValues(object, [&](const auto &values) { minMax(values, numElements, min, max); });
+}
+
+void Color::binData(vistle::DataBase::const_ptr object, std::vector<unsigned long> &binsVec)
+{
+    const ssize_t numElements = object->getSize();
+    withValues(object, [&](const auto &values) { histogram(values, numElements, m_min, m_max, binsVec); });
 }
 
 
@@ -604,54 +664,15 @@ bool Color::changeParameter(const Parameter *p)
 vistle::Texture1D::ptr Color::addTexture(vistle::DataBase::const_ptr object, const vistle::Scalar min,
                                          const vistle::Scalar max, const ColorMap &cmap)
 {
-    const Scalar invRange = 1.f / (max - min);
-
     vistle::Texture1D::ptr tex(new vistle::Texture1D(cmap.width, min, max));
     unsigned char *pix = &tex->pixels()[0];
-    for (size_t index = 0; index < cmap.width * 4; index++)
-        pix[index] = cmap.data[index];
+    std::copy(cmap.data.begin(), cmap.data.begin() + cmap.width * 4, pix);
 
     const ssize_t numElem = object->getSize();
     tex->coords().resize(numElem);
     auto tc = tex->coords().data();
 
-    if (Vec<Scalar>::const_ptr f = Vec<Scalar>::as(object)) {
-        const vistle::Scalar *x = &f->x()[0];
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-        for (ssize_t index = 0; index < numElem; index++)
-            tc[index] = (x[index] - min) * invRange;
-    } else if (Vec<Index>::const_ptr f = Vec<Index>::as(object)) {
-        const vistle::Index *x = &f->x()[0];
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-        for (ssize_t index = 0; index < numElem; index++)
-            tc[index] = (x[index] - min) * invRange;
-    } else if (Vec<Byte>::const_ptr f = Vec<Byte>::as(object)) {
-        const vistle::Byte *x = &f->x()[0];
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-        for (ssize_t index = 0; index < numElem; index++)
-            tc[index] = (x[index] - min) * invRange;
-    } else if (Vec<Scalar, 3>::const_ptr f = Vec<Scalar, 3>::as(object)) {
-        const vistle::Scalar *x = &f->x()[0];
-        const vistle::Scalar *y = &f->y()[0];
-        const vistle::Scalar *z = &f->z()[0];
-
-#ifdef USE_OPENMP
-#pragma omp parallel for
-#endif
-        for (ssize_t index = 0; index < numElem; index++) {
-            const Scalar v = Vector3(x[index], y[index], z[index]).norm();
-            tc[index] = (v - min) * invRange;
-        }
-    } else {
+    if (!withValues(object, [&](const auto &values) { texCoords(values, numElem, min, max, tc); })) {
         std::cerr << "Color: cannot handle input of type " << object->getType() << std::endl;
 
 #ifdef USE_OPENMP
@@ -872,13 +893,49 @@ bool Color::compute()
     return true;
 }
 
+void Color::rangeFromParameters()
+{
+    m_min = m_minPara->getValue();
+    m_max = m_maxPara->getValue();
+    if (m_min == m_max)
+        m_max = m_min + 1.;
+    m_reverse = m_min > m_max;
+    if (m_reverse)
+        std::swap(m_min, m_max);
+}
+
 bool Color::reduce(int timestep)
 {
     assert(timestep == -1);
     bool preview = getIntParameter("preview");
 
-    m_dataMin = boost::mpi::all_reduce(comm(), m_dataMin, boost::mpi::minimum<Scalar>());
-    m_dataMax = boost::mpi::all_reduce(comm(), m_dataMax, boost::mpi::maximum<Scalar>());
+    // reduce minimum and maximum in a single non-blocking operation,
+    // local data can already be binned meanwhile if the mapped range does not depend on the data range
+    Scalar localRange[2] = {-m_dataMin, m_dataMax}, globalRange[2];
+    MPI_Request rangeRequest = MPI_REQUEST_NULL;
+    MPI_Iallreduce(localRange, globalRange, 2, boost::mpi::get_mpi_datatype<Scalar>(), MPI_MAX, comm(),
+                   &rangeRequest);
+
+    const bool autoCenter = m_nest && m_autoInsetCenter;
+    std::vector<unsigned long> bins;
+    Scalar binnedRange[2] = {0, 0};
+    auto binInput = [this, &bins, &binnedRange]() {
+        bins.clear();
+        bins.resize(getIntParameter("resolution"));
+        for (auto data: m_inputQueue) {
+            binData(data, bins);
+        }
+        binnedRange[0] = m_min;
+        binnedRange[1] = m_max;
+    };
+    if (autoCenter && !m_autoRange) {
+        rangeFromParameters();
+        binInput();
+    }
+
+    MPI_Wait(&rangeRequest, MPI_STATUS_IGNORE);
+    m_dataMin = -globalRange[0];
+    m_dataMax = globalRange[1];
     m_dataRangeValid = true;
     if (m_constrain->getValue()) {
         auto diff = m_dataMax - m_dataMin;
@@ -894,22 +951,14 @@ bool Color::reduce(int timestep)
         setParameter<Float>(m_maxPara, m_dataMax);
     }
 
-    m_min = m_minPara->getValue();
-    m_max = m_maxPara->getValue();
-    if (m_min == m_max)
-        m_max = m_min + 1.;
-    m_reverse = m_min > m_max;
-    if (m_reverse)
-        std::swap(m_min, m_max);
+    rangeFromParameters();
 
-    if (m_nest && m_autoInsetCenter) {
-        std::vector<unsigned long> bins(getIntParameter("resolution"));
-        for (auto data: m_inputQueue) {
-            binData(data, bins);
-        }
-        for (size_t i = 0; i < bins.size(); ++i) {
-            bins[i] = boost::mpi::all_reduce(comm(), bins[i], std::plus<unsigned long>());
+    if (autoCenter) {
+        if (bins.empty() || binnedRange[0] != m_min || binnedRange[1] != m_max) {
+            // range has been adapted to data
+            binInput();
         }
+        MPI_Allreduce(MPI_IN_PLACE, bins.data(), bins.size(), MPI_UNSIGNED_LONG, MPI_SUM, comm());
 
         bool relative = getIntParameter("inset_relative");
         double width = getFloatParameter("inset_width");
@@ -942,7 +991,7 @@ bool Color::reduce(int timestep)
         }
     }
 
-    if (m_autoRange || (m_nest && m_autoInsetCenter)) {
+    if (m_autoRange || autoCenter) {
         computeMap();
         if (preview)
             startIteration();
@@ -37,6 +37,8 @@ private:
 
     void getMinMax(vistle::DataBase::const_ptr object, vistle::Scalar &min, vistle::Scalar &max);
     void binData(vistle::DataBase::const_ptr object, std::vector<unsigned long> &binsVec);
+    //! set m_min and m_max from parameters, ordered ascendingly
+    void rangeFromParameters();
     void computeMap();
     void sendColorMap();
 
@@ -71,6 +71,9 @@ IsoSurface::IsoSurface(const std::string &name, int moduleID, mpi::communicator
 
     m_computeNormals =
         addIntParameter("compute_normals", "compute normals (structured grids only)", 1, Parameter::Boolean);
+    m_tileSize = addIntParameter("tile_size", "number of cells to process at once, bounds temporary memory (0: all)",
+                                 1 << 18);
+    setParameterRange(m_tileSize, Integer(0), std::numeric_limits<Integer>::max());
 #ifdef ISOHEIGHTSURFACE
     m_heightmap = addStringParameter("heightmap", "height map as geotif", "", Parameter::ExistingFilename);
 #endif
@@ -78,6 +81,8 @@ IsoSurface::IsoSurface(const std::string &name, int moduleID, mpi::communicator
 
 #ifdef CUTTINGSURFACE
     addResultCache(m_gridCache);
+#elif !defined(ISOHEIGHTSURFACE)
+    addResultCache(m_rangeTreeCache);
 #endif
 }
 
@@ -255,6 +260,7 @@ Object::ptr IsoSurface::work(vistle::Object::const_ptr grid, vistle::Vec<vistle:
 {
     Leveller l(isocontrol, grid, isoValue);
     l.setComputeNormals(m_computeNormals->getValue());
+    l.setTileSize(m_tileSize->getValue());
 
 #ifdef CUTTINGSURFACE
     CachedResult cachedResult;
@@ -264,11 +270,25 @@ Object::ptr IsoSurface::work(vistle::Object::const_ptr grid, vistle::Vec<vistle:
     }
 #else
     l.setIsoData(dataS);
+#ifndef ISOHEIGHTSURFACE
+    std::shared_ptr<const Leveller::RangeTree> rangeTree;
+    auto rangeTreeEntry = m_rangeTreeCache.getOrLock(grid->getName() + ":" + dataS->getName(), rangeTree);
+    if (rangeTreeEntry) {
+        l.setBuildRangeTree(m_rangeTreeCache.enabled());
+    } else {
+        l.setRangeTree(rangeTree);
+    }
+#endif
 #endif
     if (mapdata) {
         l.addMappedData(mapdata);
     }
     l.process();
+#if !defined(CUTTINGSURFACE) && !defined(ISOHEIGHTSURFACE)
+    if (rangeTreeEntry) {
+        m_rangeTreeCache.storeAndUnlock(rangeTreeEntry, l.rangeTree());
+    }
+#endif
 
 #ifndef CUTTINGSURFACE
     auto minmax = dataS->getMinMax();
@@ -4,11 +4,9 @@
 #include <vistle/module/module.h>
 #include <vistle/core/vec.h>
 #include <vistle/core/unstr.h>
-#include "IsoDataFunctor.h"
-
-#ifdef CUTTINGSURFACE
 #include <vistle/module/resultcache.h>
-#endif
+#include "IsoDataFunctor.h"
+#include "Leveller.h"
 
 class IsoSurface: public vistle::Module {
 public:
@@ -62,6 +60,7 @@ private:
     vistle::VectorParameter *m_isopoint;
     vistle::IntParameter *m_pointOrValue;
     vistle::IntParameter *m_computeNormals;
+    vistle::IntParameter *m_tileSize;
 
     vistle::StringParameter *m_heightmap;
     vistle::Port *m_mapDataIn, *m_dataOut;
@@ -80,6 +79,10 @@ private:
         vistle::Coords::ptr grid;
     };
     mutable vistle::ResultCache<CachedResult> m_gridCache;
+#elif !defined(ISOHEIGHTSURFACE)
+    // keyed by grid and data, retained across executions for changing the isovalue
+    mutable vistle::ResultCache<std::shared_ptr<const Leveller::RangeTree>> m_rangeTreeCache{
+        vistle::ResultCacheBase::Persistent};
 #endif
 };
 
@@ -4,6 +4,8 @@
 
 #include <sstream>
 #include <iomanip>
+#include <cmath>
+#include <limits>
 #include <vistle/core/index.h>
 #include <vistle/core/scalar.h>
 #include <vistle/core/unstr.h>
@@ -757,6 +759,46 @@ struct SelectCells2D {
 };
 
 
+#ifndef CUTTINGSURFACE
+template<class Data>
+struct ComputeRangeLeaf {
+    Data &m_data;
+    Index m_numCells;
+    ComputeRangeLeaf(Data &data, Index numCells): m_data(data), m_numCells(numCells) {}
+
+    // minimum and maximum of data over all vertices of a run of cells,
+    // NaN is treated like a value below any isovalue, as by SelectCells
+    std::pair<Scalar, Scalar> operator()(const Index leaf) const
+    {
+        typedef Leveller::RangeTree RangeTree;
+        Scalar rmin = std::numeric_limits<Scalar>::max(), rmax = std::numeric_limits<Scalar>::lowest();
+        auto update = [this, &rmin, &rmax](Index v) {
+            Scalar val = m_data.m_isoFunc(v);
+            if (std::isnan(val))
+                val = std::numeric_limits<Scalar>::lowest();
+            if (val < rmin)
+                rmin = val;
+            if (val > rmax)
+                rmax = val;
+        };
+
+        const Index begin = leaf * RangeTree::LeafSize;
+        const Index end = std::min(begin + RangeTree::LeafSize, m_numCells);
+        if (m_data.m_isUnstructured) {
+            for (Index i = m_data.m_el[begin]; i < m_data.m_el[end]; ++i)
+                update(m_data.m_cl[i]);
+        } else {
+            for (Index c = begin; c < end; ++c) {
+                auto verts = vistle::StructuredGridBase::cellVertices(c, m_data.m_nvert);
+                for (int i = 0; i < 8; ++i)
+                    update(verts[i]);
+            }
+        }
+        return std::make_pair(rmin, rmax);
+    }
+};
+#endif
+
 template<class Data>
 struct ComputeOutputSizes {
     ComputeOutputSizes(Data &data): m_data(data) {}
@@ -901,54 +943,39 @@ Leveller::Leveller(const IsoController &isocontrol, Object::const_ptr grid, cons
 }
 
 template<class Data, class pol>
-Index Leveller::calculateSurface(Data &data)
+void Leveller::selectCells(Data &data, Index begin, Index end)
 {
-    Index nelem = 0;
+    thrust::counting_iterator<Index> first(begin), last(end);
+    data.m_SelectedCellVector.resize(end - begin);
+
+    typename Data::VectorIndexIterator selEnd = data.m_SelectedCellVector.begin();
     if (m_strbase) {
-        nelem = m_strbase->getNumElements();
+        selEnd = thrust::copy_if(pol(), first, last, thrust::counting_iterator<Index>(begin),
+                                 data.m_SelectedCellVector.begin(), SelectCells<Data>(data));
     } else if (m_unstr) {
-        nelem = m_unstr->getNumElements();
-    } else if (m_tri) {
-        nelem = m_tri->getNumElements();
-    } else if (m_quad) {
-        nelem = m_quad->getNumElements();
+        typedef thrust::tuple<typename Data::IndexIterator, typename Data::IndexIterator> Iteratortuple;
+        typedef thrust::zip_iterator<Iteratortuple> ZipIterator;
+        ZipIterator ElTupleVec(thrust::make_tuple(&data.m_el[begin], &data.m_el[begin + 1]));
+        selEnd = thrust::copy_if(pol(), first, last, ElTupleVec, data.m_SelectedCellVector.begin(),
+                                 SelectCells<Data>(data));
     } else if (m_poly) {
-        nelem = m_poly->getNumElements();
+        typedef thrust::tuple<typename Data::IndexIterator, typename Data::IndexIterator> Iteratortuple;
+        typedef thrust::zip_iterator<Iteratortuple> ZipIterator;
+        ZipIterator ElTupleVec(thrust::make_tuple(&data.m_el[begin], &data.m_el[begin + 1]));
+        selEnd = thrust::copy_if(pol(), first, last, ElTupleVec, data.m_SelectedCellVector.begin(),
+                                 SelectCells2D<Data>(data));
+    } else if (m_tri || m_quad) {
+        selEnd = thrust::copy_if(pol(), first, last, thrust::counting_iterator<Index>(begin),
+                                 data.m_SelectedCellVector.begin(), SelectCells2D<Data>(data));
     }
-    thrust::counting_iterator<Index> first(0), last = first + nelem;
-    ;
-    size_t numSelectedCells = 0;
-    if (data.m_SelectedCellVectorValid) {
-        numSelectedCells = data.m_SelectedCellVector.size();
-    } else {
-        data.m_SelectedCellVector.resize(nelem);
-
 
-        typename Data::VectorIndexIterator end;
-        if (m_strbase) {
-            end = thrust::copy_if(pol(), first, last, thrust::counting_iterator<Index>(0),
-                                  data.m_SelectedCellVector.begin(), SelectCells<Data>(data));
-        } else if (m_unstr) {
-            typedef thrust::tuple<typename Data::IndexIterator, typename Data::IndexIterator> Iteratortuple;
-            typedef thrust::zip_iterator<Iteratortuple> ZipIterator;
-            ZipIterator ElTupleVec(thrust::make_tuple(&data.m_el[0], &data.m_el[1]));
-            end = thrust::copy_if(pol(), first, last, ElTupleVec, data.m_SelectedCellVector.begin(),
-                                  SelectCells<Data>(data));
-        } else if (m_poly) {
-            typedef thrust::tuple<typename Data::IndexIterator, typename Data::IndexIterator> Iteratortuple;
-            typedef thrust::zip_iterator<Iteratortuple> ZipIterator;
-            ZipIterator ElTupleVec(thrust::make_tuple(&data.m_el[0], &data.m_el[1]));
-            end = thrust::copy_if(pol(), first, last, ElTupleVec, data.m_SelectedCellVector.begin(),
-                                  SelectCells2D<Data>(data));
-        } else if (m_tri || m_quad) {
-            end = thrust::copy_if(pol(), first, last, thrust::counting_iterator<Index>(0),
-                                  data.m_SelectedCellVector.begin(), SelectCells2D<Data>(data));
-        }
+    data.m_SelectedCellVector.resize(selEnd - data.m_SelectedCellVector.begin());
+}
 
-        numSelectedCells = end - data.m_SelectedCellVector.begin();
-        data.m_SelectedCellVector.resize(numSelectedCells);
-        data.m_SelectedCellVectorValid = true;
-    }
+template<class Data, class pol>
+Index Leveller::computeOutputSizes(Data &data, Index offset)
+{
+    const size_t numSelectedCells = data.m_SelectedCellVector.size();
     data.m_caseNums.resize(numSelectedCells);
     data.m_numVertices.resize(numSelectedCells);
     data.m_LocationList.resize(numSelectedCells);
@@ -956,12 +983,16 @@ Index Leveller::calculateSurface(Data &data)
         pol(), data.m_SelectedCellVector.begin(), data.m_SelectedCellVector.end(),
         thrust::make_zip_iterator(thrust::make_tuple(data.m_caseNums.begin(), data.m_numVertices.begin())),
         ComputeOutputSizes<Data>(data));
-    thrust::exclusive_scan(pol(), data.m_numVertices.begin(), data.m_numVertices.end(), data.m_LocationList.begin());
-    Index totalNumVertices = 0;
-    if (!data.m_numVertices.empty())
-        totalNumVertices += data.m_numVertices.back();
-    if (!data.m_LocationList.empty())
-        totalNumVertices += data.m_LocationList.back();
+    thrust::exclusive_scan(pol(), data.m_numVertices.begin(), data.m_numVertices.end(), data.m_LocationList.begin(),
+                           offset);
+    if (numSelectedCells == 0)
+        return 0;
+    return data.m_LocationList.back() + data.m_numVertices.back() - offset;
+}
+
+template<class Data>
+void Leveller::resizeOutput(Data &data, Index totalNumVertices)
+{
     for (int i = (m_computeNormals || !m_strbase ? 0 : 3); i < data.m_numInVertData; i++) {
         data.m_outVertData[i]->resize(totalNumVertices);
     }
@@ -980,8 +1011,170 @@ Index Leveller::calculateSurface(Data &data)
     for (int i = 0; i < data.m_numInCellDataB; ++i) {
         data.m_outCellDataB[i]->resize(totalNumVertices / 3);
     }
-    thrust::counting_iterator<Index> start(0), finish(numSelectedCells);
-    thrust::for_each(pol(), start, finish, ComputeOutput<Data>(data));
+}
+
+#ifndef CUTTINGSURFACE
+void Leveller::RangeTree::findRanges(Scalar isovalue, std::vector<std::pair<Index, Index>> &result) const
+{
+    if (levels.empty())
+        return;
+
+    // depth-first, children in ascending order, so that adjacent leaves can be merged
+    std::vector<std::pair<size_t, Index>> stack;
+    const size_t top = levels.size() - 1;
+    for (Index n = levels[top].size(); n > 0; --n)
+        stack.emplace_back(top, n - 1);
+    while (!stack.empty()) {
+        const size_t level = stack.back().first;
+        const Index node = stack.back().second;
+        stack.pop_back();
+
+        // same criterion as for selecting a single cell: at least one value above and one not above isovalue
+        const auto &range = levels[level][node];
+        if (!(range.first <= isovalue && range.second > isovalue))
+            continue;
+
+        if (level > 0) {
+            const Index begin = node * Fanout;
+            const Index end = std::min(begin + Fanout, Index(levels[level - 1].size()));
+            for (Index c = end; c > begin; --c)
+                stack.emplace_back(level - 1, c - 1);
+            continue;
+        }
+
+        const Index begin = node * LeafSize;
+        const Index end = std::min(begin + LeafSize, numCells);
+        if (!result.empty() && result.back().second == begin)
+            result.back().second = end;
+        else
+            result.emplace_back(begin, end);
+    }
+}
+
+template<class Data, class pol>
+void Leveller::buildRangeTree(Data &data, Index numCells)
+{
+    auto tree = std::make_shared<RangeTree>();
+    tree->numCells = numCells;
+
+    Index numLeaves = (numCells + RangeTree::LeafSize - 1) / RangeTree::LeafSize;
+    tree->levels.emplace_back(numLeaves);
+    thrust::counting_iterator<Index> first(0), last(numLeaves);
+    thrust::transform(pol(), first, last, tree->levels[0].begin(), ComputeRangeLeaf<Data>(data, numCells));
+
+    while (tree->levels.back().size() > 1) {
+        const auto &lower = tree->levels.back();
+        std::vector<std::pair<Scalar, Scalar>> upper((lower.size() + RangeTree::Fanout - 1) / RangeTree::Fanout);
+        for (Index i = 0; i < lower.size(); ++i) {
+            auto &u = upper[i / RangeTree::Fanout];
+            if (i % RangeTree::Fanout == 0) {
+                u = lower[i];
+                continue;
+            }
+            u.first = std::min(u.first, lower[i].first);
+            u.second = std::max(u.second, lower[i].second);
+        }
+        tree->levels.emplace_back(std::move(upper));
+    }
+
+    m_rangeTree = tree;
+}
+
+template<class Data, class pol>
+void Leveller::selectCellsInRanges(Data &data)
+{
+    std::vector<std::pair<Index, Index>> ranges;
+    m_rangeTree->findRanges(m_isoValue, ranges);
+
+    std::vector<Index> selected;
+    for (const auto &r: ranges) {
+        selectCells<Data, pol>(data, r.first, r.second);
+        selected.insert(selected.end(), data.m_SelectedCellVector.begin(), data.m_SelectedCellVector.end());
+    }
+    std::swap(data.m_SelectedCellVector, selected);
+    data.m_SelectedCellVectorValid = true;
+}
+#endif
+
+template<class Data, class pol>
+Index Leveller::calculateSurface(Data &data)
+{
+    Index nelem = 0;
+    if (m_strbase) {
+        nelem = m_strbase->getNumElements();
+    } else if (m_unstr) {
+        nelem = m_unstr->getNumElements();
+    } else if (m_tri) {
+        nelem = m_tri->getNumElements();
+    } else if (m_quad) {
+        nelem = m_quad->getNumElements();
+    } else if (m_poly) {
+        nelem = m_poly->getNumElements();
+    }
+
+    const bool precomputed = data.m_SelectedCellVectorValid;
+    const Index numCells = precomputed ? data.m_SelectedCellVector.size() : nelem;
+    const Index tileSize = m_tileSize > 0 ? m_tileSize : std::max(numCells, Index(1));
+    const Index numTiles = (numCells + tileSize - 1) / tileSize;
+
+    if (numTiles <= 1) {
+        if (!precomputed) {
+            selectCells<Data, pol>(data, 0, nelem);
+            data.m_SelectedCellVectorValid = true;
+        }
+        Index totalNumVertices = computeOutputSizes<Data, pol>(data, 0);
+        resizeOutput(data, totalNumVertices);
+        thrust::counting_iterator<Index> start(0), finish(data.m_SelectedCellVector.size());
+        thrust::for_each(pol(), start, finish, ComputeOutput<Data>(data));
+        return totalNumVertices;
+    }
+
+    // process cells in tiles, so that temporary memory does not grow with the size of the block:
+    // a first pass determines the output size of each tile, so that output arrays are allocated only once,
+    // the second pass generates the surface for each tile
+#ifdef CUTTINGSURFACE
+    const bool keepSelection = true; // allow for reusing selected cells for other data on same grid
+#else
+    const bool keepSelection = false;
+#endif
+    std::vector<Index> allSelected;
+    if (precomputed)
+        std::swap(allSelected, data.m_SelectedCellVector);
+    auto loadTile = [this, &data, &allSelected, precomputed, tileSize, numCells](Index tile) {
+        const Index begin = tile * tileSize;
+        const Index end = std::min(begin + tileSize, numCells);
+        if (precomputed) {
+            data.m_SelectedCellVector.assign(allSelected.begin() + begin, allSelected.begin() + end);
+        } else {
+            selectCells<Data, pol>(data, begin, end);
+        }
+    };
+
+    std::vector<Index> tileOffset(numTiles);
+    Index totalNumVertices = 0;
+    for (Index t = 0; t < numTiles; ++t) {
+        loadTile(t);
+        tileOffset[t] = totalNumVertices;
+        totalNumVertices += computeOutputSizes<Data, pol>(data, totalNumVertices);
+        if (keepSelection && !precomputed) {
+            allSelected.insert(allSelected.end(), data.m_SelectedCellVector.begin(), data.m_SelectedCellVector.end());
+        }
+    }
+    resizeOutput(data, totalNumVertices);
+
+    for (Index i = 0; i < numTiles; ++i) {
+        // last tile is still loaded from first pass
+        const Index t = (i + numTiles - 1) % numTiles;
+        if (t != numTiles - 1) {
+            loadTile(t);
+            computeOutputSizes<Data, pol>(data, tileOffset[t]);
+        }
+        thrust::counting_iterator<Index> start(0), finish(data.m_SelectedCellVector.size());
+        thrust::for_each(pol(), start, finish, ComputeOutput<Data>(data));
+    }
+
+    std::swap(data.m_SelectedCellVector, allSelected);
+    data.m_SelectedCellVectorValid = precomputed || keepSelection;
 
     return totalNumVertices;
 }
@@ -992,11 +1185,16 @@ bool Leveller::process()
     Vec<Scalar>::const_ptr dataobj = Vec<Scalar>::as(m_data);
     if (!dataobj)
         return false;
+    bool outOfRange = false;
     auto bounds = dataobj->getMinMax();
     if (bounds.first[0] <= bounds.second[0]) {
         if (m_isoValue < bounds.first[0] || m_isoValue > bounds.second[0])
-            return true;
+            outOfRange = true;
     }
+    // still build the range tree, so that it is available for subsequent isovalues
+    const bool needRangeTree = m_buildRangeTree && !m_rangeTree && (m_unstr || m_strbase);
+    if (outOfRange && !needRangeTree)
+        return true;
 #else
 #endif
 
@@ -1095,6 +1293,18 @@ bool Leveller::process()
         HD.m_SelectedCellVector = *m_candidateCells;
         HD.m_SelectedCellVectorValid = true;
     }
+#else
+    if (m_unstr || m_strbase) {
+        Index numCells = m_unstr ? m_unstr->getNumElements() : m_strbase->getNumElements();
+        if (needRangeTree) {
+            buildRangeTree<HostData, thrust::detail::host_t>(HD, numCells);
+        }
+        if (outOfRange)
+            return true;
+        if (m_rangeTree && m_rangeTree->numCells == numCells) {
+            selectCellsInRanges<HostData, thrust::detail::host_t>(HD);
+        }
+    }
 #endif
 
     for (size_t i = 0; i < m_vertexdata.size(); ++i) {
@@ -1256,8 +1466,28 @@ void Leveller::setIsoData(Vec<Scalar>::const_ptr obj)
 {
     m_data = obj;
 }
+
+void Leveller::setRangeTree(std::shared_ptr<const RangeTree> tree)
+{
+    m_rangeTree = tree;
+}
+
+void Leveller::setBuildRangeTree(bool build)
+{
+    m_buildRangeTree = build;
+}
+
+std::shared_ptr<const Leveller::RangeTree> Leveller::rangeTree() const
+{
+    return m_rangeTree;
+}
 #endif
 
+void Leveller::setTileSize(Index numCells)
+{
+    m_tileSize = numCells;
+}
+
 void Leveller::setComputeNormals(bool value)
 {
     m_computeNormals = value;
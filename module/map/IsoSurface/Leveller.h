@@ -1,6 +1,7 @@
 #ifndef LEVELLER_H
 #define LEVELLER_H
 
+#include <memory>
 #include <vector>
 #include <vistle/core/index.h>
 #include <vistle/core/vec.h>
@@ -29,6 +30,23 @@
 DEFINE_ENUM_WITH_STRING_CONVERSIONS(ThrustBackend, (Host)(Device))
 
 class Leveller {
+public:
+#ifndef CUTTINGSURFACE
+    //! hierarchy of data ranges over runs of consecutive cells for skipping cells that cannot intersect an isosurface
+    struct RangeTree {
+        static const vistle::Index LeafSize = 256; //!< number of consecutive cells summarized by a leaf
+        static const vistle::Index Fanout = 8; //!< number of nodes summarized by a node on the next level
+
+        vistle::Index numCells = 0;
+        //! minimum and maximum of data over the vertices of a node's cells, leaves are on level 0
+        std::vector<std::vector<std::pair<vistle::Scalar, vistle::Scalar>>> levels;
+
+        //! append ranges of cells [first, second) that might intersect the isosurface to result
+        void findRanges(vistle::Scalar isovalue, std::vector<std::pair<vistle::Index, vistle::Index>> &result) const;
+    };
+#endif
+
+private:
     const IsoController &m_isocontrol;
     vistle::Object::const_ptr m_grid;
     vistle::UniformGrid::const_ptr m_uni;
@@ -45,6 +63,8 @@ class Leveller {
     const std::vector<vistle::Index> *m_candidateCells = nullptr;
 #else
     vistle::Vec<vistle::Scalar>::const_ptr m_data;
+    std::shared_ptr<const RangeTree> m_rangeTree;
+    bool m_buildRangeTree = false;
 #endif
     std::vector<vistle::Object::const_ptr> m_vertexdata;
     std::vector<vistle::DataBase::const_ptr> m_celldata;
@@ -57,13 +77,28 @@ class Leveller {
     vistle::Scalar gmin, gmax;
     vistle::Matrix4 m_objectTransform;
     bool m_computeNormals;
+    vistle::Index m_tileSize = 0;
 
     template<class Data, class pol>
     vistle::Index calculateSurface(Data &data);
+    template<class Data, class pol>
+    void selectCells(Data &data, vistle::Index begin, vistle::Index end);
+    template<class Data, class pol>
+    vistle::Index computeOutputSizes(Data &data, vistle::Index offset);
+    template<class Data>
+    void resizeOutput(Data &data, vistle::Index numVertices);
+#ifndef CUTTINGSURFACE
+    template<class Data, class pol>
+    void buildRangeTree(Data &data, vistle::Index numCells);
+    template<class Data, class pol>
+    void selectCellsInRanges(Data &data);
+#endif
 
 public:
     Leveller(const IsoController &isocontrol, vistle::Object::const_ptr grid, const vistle::Scalar isovalue);
     void setComputeNormals(bool value);
+    //! process at most this many cells at once in order to bound temporary memory (0: all cells at once)
+    void setTileSize(vistle::Index numCells);
     void addMappedData(vistle::DataBase::const_ptr mapobj);
 
     bool process();
@@ -72,6 +107,11 @@ public:
     const std::vector<vistle::Index> *candidateCells();
 #else
     void setIsoData(vistle::Vec<vistle::Scalar>::const_ptr obj);
+    //! only consider cells within ranges of tree straddling the isovalue, tree has to match grid and data
+    void setRangeTree(std::shared_ptr<const RangeTree> tree);
+    //! build a range tree for volume grids while processing, if none has been set
+    void setBuildRangeTree(bool build);
+    std::shared_ptr<const RangeTree> rangeTree() const;
 #endif
     vistle::Coords::ptr result();
     vistle::Normals::ptr normresult();
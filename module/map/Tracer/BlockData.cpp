@@ -22,6 +22,16 @@ BlockData::BlockData(Index i, Object::const_ptr grid, Vec<Scalar, 3>::const_ptr
     m_invTransform = m_transform.inverse();
     m_velocityTransform = m_transform.block<3, 3>(0, 0);
 
+    auto b = m_gridInterface->getBounds();
+    m_bounds.first = m_bounds.second = transformPoint(m_transform, b.first);
+    for (int i = 1; i < 8; ++i) {
+        Vector3 corner((i & 1) ? b.second[0] : b.first[0], (i & 2) ? b.second[1] : b.first[1],
+                       (i & 4) ? b.second[2] : b.first[2]);
+        corner = transformPoint(m_transform, corner);
+        m_bounds.first = m_bounds.first.cwiseMin(corner);
+        m_bounds.second = m_bounds.second.cwiseMax(corner);
+    }
+
     if (m_vecfld) {
         m_vx = &m_vecfld->x()[0];
         m_vy = &m_vecfld->y()[0];
@@ -82,3 +92,8 @@ const Matrix3 &BlockData::velocityTransform() const
 {
     return m_velocityTransform;
 }
+
+const std::pair<Vector3, Vector3> &BlockData::bounds() const
+{
+    return m_bounds;
+}
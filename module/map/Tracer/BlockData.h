@@ -21,6 +21,7 @@ private:
     const vistle::Scalar *m_vx, *m_vy, *m_vz, *m_p;
     vistle::Matrix4 m_transform, m_invTransform;
     vistle::Matrix3 m_velocityTransform;
+    std::pair<vistle::Vector3, vistle::Vector3> m_bounds;
 
 public:
     BlockData(vistle::Index i, vistle::Object::const_ptr grid, vistle::Vec<vistle::Scalar, 3>::const_ptr vdata,
@@ -38,6 +39,8 @@ public:
     const vistle::Matrix4 &transform() const;
     const vistle::Matrix4 &invTransform() const;
     const vistle::Matrix3 &velocityTransform() const;
+    //! bounding box of grid in world coordinates
+    const std::pair<vistle::Vector3, vistle::Vector3> &bounds() const;
 
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
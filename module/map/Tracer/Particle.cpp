@@ -1,6 +1,5 @@
 #include <limits>
 #include <algorithm>
-#include <boost/mpi/collectives/broadcast.hpp>
 #include <boost/serialization/vector.hpp>
 #include <vistle/core/vec.h>
 #include <vistle/util/math.h>
@@ -69,25 +68,42 @@ void Particle::enableCelltree(bool value)
     m_integrator.enableCelltree(value);
 }
 
-int Particle::searchRank(boost::mpi::communicator mpi_comm)
+bool Particle::searchCell()
 {
     assert(!m_tracing);
     assert(!m_currentSegment);
     m_progress = false;
 
-    int rank = -1;
-
     if (findCell(m_time)) {
         m_integrator.hInit();
-        rank = mpi_comm.rank();
+        return true;
     }
 
-    rank = boost::mpi::all_reduce(mpi_comm, rank, boost::mpi::maximum<int>());
+    return false;
+}
+
+void Particle::discardSearch()
+{
+    m_currentSegment.reset();
+    UpdateBlock(nullptr);
+}
+
+void Particle::setRank(int rank)
+{
     if (m_rank == -1) {
         m_rank = rank;
     }
+}
 
-    return rank;
+Index Particle::timestep() const
+{
+    return m_timestep;
+}
+
+Vector3 Particle::position() const
+{
+    assert(!m_block);
+    return m_x;
 }
 
 void Particle::startTracing()
@@ -98,7 +114,10 @@ void Particle::startTracing()
         std::string tname =
             std::to_string(m_global.module->id()) + "p" + std::to_string(id()) + ":" + m_global.module->name();
         setThreadName(tname);
-        return trace();
+        bool traced = trace();
+        if (m_global.traceFinished)
+            m_global.traceFinished(id());
+        return traced;
     });
 }
 
@@ -579,9 +598,16 @@ Scalar Particle::time() const
 }
 
 
-void Particle::broadcast(boost::mpi::communicator mpi_comm, int root)
+void Particle::pack(boost::mpi::packed_oarchive &ar)
 {
-    boost::mpi::broadcast(mpi_comm, *this, root);
+    assert(!m_tracing);
+    ar << *this;
+}
+
+void Particle::unpack(boost::mpi::packed_iarchive &ar)
+{
+    assert(!m_tracing);
+    ar >> *this;
     m_integrator.m_hact = m_integrator.m_h;
     m_progress = false;
 }
@@ -5,6 +5,8 @@
 #include <future>
 
 #include <boost/mpi/communicator.hpp>
+#include <boost/mpi/packed_iarchive.hpp>
+#include <boost/mpi/packed_oarchive.hpp>
 
 #include <boost/serialization/split_free.hpp>
 
@@ -43,14 +45,19 @@ public:
     void Deactivate(StopReason reason);
     void EmitData();
     bool Step();
-    void broadcast(boost::mpi::communicator mpi_comm, int root);
+    void pack(boost::mpi::packed_oarchive &ar); //< serialize state for handing particle over to another rank
+    void unpack(boost::mpi::packed_iarchive &ar); //< restore state received from another rank
     void startSendData(boost::mpi::communicator mpi_comm);
     void finishSendData();
     void receiveData(boost::mpi::communicator mpi_comm, int rank);
     void UpdateBlock(BlockData *block);
     StopReason stopReason() const;
     void enableCelltree(bool value);
-    int searchRank(boost::mpi::communicator mpi_comm); //< returns MPI rank of node where tracing occurs
+    bool searchCell(); //< find cell containing particle on this rank in preparation of tracing
+    void discardSearch(); //< undo successful searchCell, if particle is traced on another rank
+    void setRank(int rank); //< set MPI rank where resulting geometry is assembled, if not yet assigned
+    vistle::Index timestep() const;
+    vistle::Vector3 position() const;
     void startTracing();
     bool isTracing(bool wait);
     bool madeProgress() const;
@@ -5,10 +5,17 @@
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <deque>
+#include <array>
+#include <mpi.h>
 #include <boost/mpi/collectives/all_reduce.hpp>
 #include <boost/mpi/collectives/all_gather.hpp>
+#include <boost/mpi/collectives/all_to_all.hpp>
 #include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/mpi/environment.hpp>
 #include <boost/mpi/operations.hpp>
+#include <boost/mpi/packed_iarchive.hpp>
+#include <boost/mpi/packed_oarchive.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/map.hpp>
 #include <vistle/core/vec.h>
@@ -23,7 +30,8 @@
 #include <vistle/alg/objalg.h>
 #include <vistle/util/threadname.h>
 
-MODULE_MAIN(Tracer)
+// tracing threads notify the rank's tracing loop through MPI
+MODULE_MAIN_THREAD(Tracer, boost::mpi::threading::multiple)
 
 
 using namespace vistle;
@@ -161,6 +169,11 @@ Tracer::~Tracer()
 
 bool Tracer::prepare()
 {
+    if (mpi::environment::thread_level() != mpi::threading::multiple) {
+        sendError("MPI does not provide MPI_THREAD_MULTIPLE, which is required for tracing");
+        return false;
+    }
+
     m_havePressure = true;
     m_haveTimeSteps = false;
 
@@ -380,7 +393,6 @@ bool Tracer::reduce(int timestep)
     if (maxNumActive <= 0) {
         maxNumActive = std::thread::hardware_concurrency();
     }
-    Index maxNumActiveGlobal = mpi::all_reduce(comm(), maxNumActive, mpi::maximum<Index>());
     auto taskType = (TraceType)getIntParameter("taskType");
     TraceDirection traceDirection = (TraceDirection)getIntParameter("tdirection");
     if (taskType != Streamlines) {
@@ -541,126 +553,342 @@ bool Tracer::reduce(int timestep)
         }
     }
 
-    Index nextParticleToStart = 0;
-    auto startParticles = [this, &nextParticleToStart, &allParticles, &activeParticles, &localParticles,
-                           maxNumActive](int toStart) -> int {
-        int started = 0;
-        while (nextParticleToStart < allParticles.size()) {
-            if (started >= toStart)
-                break;
+    const int mpisize = comm().size();
 
-            Index idx = nextParticleToStart;
-            ++nextParticleToStart;
-            auto particle = allParticles[idx];
-            int r = particle->searchRank(comm());
-            if (r >= 0) {
-                ++started;
-                if (rank() == r) {
-                    if (activeParticles.size() < maxNumActive) {
-                        activeParticles.emplace(particle);
-                        particle->startTracing();
-                    } else {
-                        localParticles.emplace(particle);
-                    }
-                }
-            } else {
+    // assign particles to the rank where they start, with a single reduction for all of them
+    {
+        std::vector<int> foundOnRank(allParticles.size(), -1), startRank(allParticles.size(), -1);
+        for (size_t i = 0; i < allParticles.size(); ++i) {
+            if (allParticles[i]->searchCell())
+                foundOnRank[i] = rank();
+        }
+        mpi::all_reduce(comm(), foundOnRank.data(), foundOnRank.size(), startRank.data(), mpi::maximum<int>());
+        for (size_t i = 0; i < allParticles.size(); ++i) {
+            auto &particle = allParticles[i];
+            const int r = startRank[i];
+            if (r < 0) {
                 particle->Deactivate(Particle::InitiallyOutOfDomain);
+                continue;
+            }
+            particle->setRank(r);
+            if (r == rank()) {
+                localParticles.emplace(particle);
+            } else if (foundOnRank[i] >= 0) {
+                particle->discardSearch();
             }
         }
-        return started;
+    }
+
+    // world space bounds of all blocks on all ranks: particles leaving a rank are only offered to ranks
+    // with a block that might contain their exit point
+    struct BlockBounds {
+        int rank;
+        Index timestep;
+        Vector3 min, max;
+    };
+    std::vector<BlockBounds> blockBounds;
+    {
+        std::vector<Scalar> localBounds;
+        for (int t = 0; t < numtime; ++t) {
+            for (const auto &block: global.blocks[t]) {
+                const auto &b = block->bounds();
+                const Vector3 eps = (b.second - b.first) * Scalar(1e-5);
+                localBounds.push_back(t);
+                for (int c = 0; c < 3; ++c)
+                    localBounds.push_back(b.first[c] - eps[c]);
+                for (int c = 0; c < 3; ++c)
+                    localBounds.push_back(b.second[c] + eps[c]);
+            }
+        }
+        std::vector<std::vector<Scalar>> allBounds;
+        mpi::all_gather(comm(), localBounds, allBounds);
+        for (int r = 0; r < mpisize; ++r) {
+            const auto &bounds = allBounds[r];
+            for (size_t i = 0; i + 7 <= bounds.size(); i += 7) {
+                blockBounds.push_back(BlockBounds{r, Index(bounds[i]), Vector3(bounds[i + 1], bounds[i + 2], bounds[i + 3]),
+                                                  Vector3(bounds[i + 4], bounds[i + 5], bounds[i + 6])});
+            }
+        }
+    }
+    auto candidateRanks = [this, &blockBounds](const Particle &particle) -> std::vector<int> {
+        std::vector<int> ranks;
+        const Vector3 x = particle.position();
+        for (const auto &b: blockBounds) {
+            if (b.timestep != particle.timestep())
+                continue;
+            if (x[0] < b.min[0] || x[1] < b.min[1] || x[2] < b.min[2] || x[0] > b.max[0] || x[1] > b.max[1] ||
+                x[2] > b.max[2])
+                continue;
+            ranks.push_back(b.rank);
+        }
+        std::sort(ranks.begin(), ranks.end());
+        ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+        return ranks;
     };
 
-    std::vector<Index> datasendlist;
+    // particle hand-off protocol:
+    // a rank that finished tracing a particle continues tracing it itself, if one of its blocks contains it,
+    // otherwise it offers it to all other candidate ranks,
+    // these reply whether they can continue tracing it,
+    // and the offering rank decides which of them continues (the highest one)
+    // every message is announced by a doorbell message, so that the tracing loop can block in MPI_Waitany
+    enum ExchangeTag {
+        TagTraced = 0, //< doorbell only: tracing thread of a particle on this rank finished
+        TagOffer,
+        TagReply,
+        TagDecision,
+        TagDoorbell,
+    };
+    struct Handoff {
+        size_t pending = 0; //< number of outstanding replies
+        std::vector<int> found; //< ranks which could continue tracing
+    };
+    std::map<Index, Handoff> handoffs; // particles offered to other ranks
+    Index numReserved = 0; // particles located on this rank after an offer, waiting for a decision
+    struct PendingSend {
+        std::shared_ptr<mpi::packed_oarchive> ar;
+        mpi::request req;
+        std::array<long, 2> bell; //< doorbell announcing tag of message
+        mpi::request bellReq;
+    };
+    std::deque<PendingSend> pendingSends;
+    long numSent = 0, numReceived = 0;
+    std::set<Index> datasendlist; // particles for which this rank holds trajectory segments
     std::vector<std::pair<Index, int>> datarecvlist; // particle id, source mpi rank
-    const int mpisize = comm().size();
-    Index numActiveMax = 0, numActiveMin = std::numeric_limits<Index>::max();
-    do {
-        std::vector<Index> sendlist;
-        Index numStart = maxNumActiveGlobal > numActiveMin ? maxNumActiveGlobal - numActiveMin : 0;
-        startParticles(numStart);
-
-        bool first = true;
-        int numDeactivated = 0;
-        // build list of particles to send to their owner
+
+    auto send = [this, &pendingSends, &numSent](int dest, int tag, const std::shared_ptr<mpi::packed_oarchive> &ar) {
+        pendingSends.emplace_back();
+        auto &s = pendingSends.back();
+        s.ar = ar;
+        s.req = comm().isend(dest, tag, *ar);
+        s.bell = {tag, 0};
+        s.bellReq = comm().isend(dest, TagDoorbell, s.bell.data(), s.bell.size());
+        ++numSent;
+    };
+
+    auto handOff = [this, &candidateRanks, &send, &handoffs, &datasendlist,
+                    &localParticles](const std::shared_ptr<Particle> &particle) {
+        particle->finishSegment();
+        datasendlist.insert(particle->id());
+        if (!particle->inGrid())
+            return;
+
+        auto ranks = candidateRanks(*particle);
+        auto self = std::find(ranks.begin(), ranks.end(), rank());
+        if (self != ranks.end()) {
+            if (particle->searchCell()) {
+                localParticles.emplace(particle);
+                return;
+            }
+            ranks.erase(self);
+        }
+        if (ranks.empty()) {
+            particle->Deactivate(Particle::OutOfDomain);
+            return;
+        }
+        Index id = particle->id();
+        auto ar = std::make_shared<mpi::packed_oarchive>(comm());
+        *ar << id;
+        particle->pack(*ar);
+        for (int r: ranks)
+            send(r, TagOffer, ar);
+        handoffs[id].pending = ranks.size();
+    };
+
+    auto receive = [this, &allParticles, &send, &handoffs, &numReserved, &numReceived,
+                    &localParticles](int source, int tag) {
+        mpi::packed_iarchive ar(comm());
+        comm().recv(source, tag, ar);
+        ++numReceived;
+        Index id = InvalidIndex;
+        ar >> id;
+        auto &particle = allParticles[id];
+        switch (tag) {
+        case TagOffer: {
+            particle->unpack(ar);
+            int found = particle->searchCell() ? 1 : 0;
+            if (found)
+                ++numReserved;
+            auto reply = std::make_shared<mpi::packed_oarchive>(comm());
+            *reply << id << found;
+            send(source, TagReply, reply);
+            break;
+        }
+        case TagReply: {
+            int found = 0;
+            ar >> found;
+            auto it = handoffs.find(id);
+            assert(it != handoffs.end());
+            auto &handoff = it->second;
+            --handoff.pending;
+            if (found)
+                handoff.found.push_back(source);
+            if (handoff.pending == 0) {
+                if (handoff.found.empty()) {
+                    particle->Deactivate(Particle::OutOfDomain);
+                } else {
+                    int winner = *std::max_element(handoff.found.begin(), handoff.found.end());
+                    auto decision = std::make_shared<mpi::packed_oarchive>(comm());
+                    *decision << id << winner;
+                    for (int r: handoff.found)
+                        send(r, TagDecision, decision);
+                }
+                handoffs.erase(it);
+            }
+            break;
+        }
+        case TagDecision: {
+            int winner = -1;
+            ar >> winner;
+            assert(numReserved > 0);
+            --numReserved;
+            if (winner == rank()) {
+                localParticles.emplace(particle);
+            } else {
+                particle->discardSearch();
+            }
+            break;
+        }
+        default:
+            std::cerr << "Tracer: unexpected message with tag " << tag << " from " << source << std::endl;
+            break;
+        }
+    };
+
+    // tracing threads ring the doorbell of this rank when they finish, so that it does not have to poll them
+    Index numTracing = 0; // particles for which the doorbell has not yet been received
+    std::array<long, 2> bell;
+    MPI_Request bellRequest = MPI_REQUEST_NULL;
+    auto postBell = [this, &bell, &bellRequest]() {
+        MPI_Irecv(bell.data(), bell.size(), MPI_LONG, MPI_ANY_SOURCE, TagDoorbell, comm(), &bellRequest);
+    };
+    auto ringBell = [&postBell, &bell, &numTracing, &allParticles, &receive](const MPI_Status &status) {
+        const auto tag = bell[0];
+        const auto id = bell[1];
+        postBell();
+        if (tag == TagTraced) {
+            assert(numTracing > 0);
+            --numTracing;
+            // thread has already notified, but might not yet have returned
+            auto &particle = allParticles[id];
+            while (particle->isTracing(true))
+                ;
+        } else {
+            receive(status.MPI_SOURCE, tag);
+        }
+    };
+    global.traceFinished = [this](Index id) {
+        long traced[2] = {TagTraced, long(id)};
+        MPI_Send(traced, 2, MPI_LONG, rank(), TagDoorbell, comm());
+    };
+    postBell();
+
+    // termination detection: when idle, ranks contribute their message counts to non-blocking reductions,
+    // tracing is finished once two consecutive reductions yield identical counts of sent and received messages
+    long counts[2] = {0, 0}, totals[2] = {0, 0}, prevTotals[2] = {-1, -1};
+    MPI_Request termination = MPI_REQUEST_NULL;
+    bool finished = false;
+    auto reduced = [&totals, &prevTotals, &finished]() {
+        if (totals[0] == totals[1] && totals[0] == prevTotals[0] && totals[1] == prevTotals[1]) {
+            finished = true;
+        }
+        prevTotals[0] = totals[0];
+        prevTotals[1] = totals[1];
+    };
+    while (!finished) {
+        bool progress = false;
         for (auto it = activeParticles.begin(), next = it; it != activeParticles.end(); it = next) {
             next = it;
             ++next;
 
-            auto particle = it->get();
-
-            bool wait = mpisize == 1 && first;
-            first = false;
-            if (!particle->isTracing(wait)) {
-                if (mpisize == 1) {
-                    particle->Deactivate(Particle::OutOfDomain);
-                } else if (particle->madeProgress()) {
-                    sendlist.push_back(particle->id());
+            auto particle = *it;
+            if (!particle->isTracing(false)) {
+                if (particle->madeProgress()) {
+                    handOff(particle);
                 }
                 activeParticles.erase(it);
-                ++numDeactivated;
+                progress = true;
             }
         }
 
-        while (numDeactivated > 0 && !localParticles.empty()) {
-            --numDeactivated;
+        while (activeParticles.size() < maxNumActive && !localParticles.empty()) {
             auto p = *localParticles.begin();
             activeParticles.emplace(p);
+            ++numTracing;
             p->startTracing();
             localParticles.erase(localParticles.begin());
+            progress = true;
         }
 
-        if (mpisize == 1) {
-            numActiveMax = numActiveMin = activeParticles.size() + localParticles.size();
-            continue;
+        for (;;) {
+            int flag = 0;
+            MPI_Status status;
+            MPI_Test(&bellRequest, &flag, &status);
+            if (!flag)
+                break;
+            ringBell(status);
+            progress = true;
         }
 
-        // communicate
-        Index num_send = sendlist.size();
-        std::vector<Index> num_transmit(mpisize);
-        mpi::all_gather(comm(), num_send, num_transmit);
-        for (int mpirank = 0; mpirank < mpisize; mpirank++) {
-            Index num_recv = num_transmit[mpirank];
-            if (num_recv > 0) {
-                std::vector<Index> recvlist;
-                auto &curlist = rank() == mpirank ? sendlist : recvlist;
-                mpi::broadcast(comm(), curlist, mpirank);
-                assert(curlist.size() == num_recv);
-                for (Index i = 0; i < num_recv; i++) {
-                    Index p_index = curlist[i];
-                    auto p = allParticles[p_index];
-                    assert(!p->isTracing(false));
-                    p->broadcast(comm(), mpirank);
-                    if (p->rank() == rank() && rank() != mpirank) {
-                        datarecvlist.emplace_back(p->id(), mpirank);
-                    }
-                    p->finishSegment();
-                    int r = p->searchRank(comm());
-                    if (r < 0) {
-                        p->Deactivate(Particle::OutOfDomain);
-                    } else if (r == rank()) {
-                        if (activeParticles.size() < maxNumActive) {
-                            activeParticles.emplace(p);
-                            p->startTracing();
-                        } else {
-                            localParticles.emplace(p);
-                        }
-                    }
-                }
-            }
+        while (!pendingSends.empty() && pendingSends.front().req.test() && pendingSends.front().bellReq.test()) {
+            pendingSends.pop_front();
         }
 
-        std::copy(sendlist.begin(), sendlist.end(), std::back_inserter(datasendlist));
+        if (termination != MPI_REQUEST_NULL) {
+            int flag = 0;
+            MPI_Test(&termination, &flag, MPI_STATUS_IGNORE);
+            if (flag)
+                reduced();
+        } else if (activeParticles.empty() && localParticles.empty() && handoffs.empty() && numReserved == 0 &&
+                   numTracing == 0) {
+            counts[0] = numSent;
+            counts[1] = numReceived;
+            MPI_Iallreduce(counts, totals, 2, MPI_LONG, MPI_SUM, comm(), &termination);
+            progress = true;
+        }
 
-        numActiveMin = mpi::all_reduce(comm(), activeParticles.size() + localParticles.size(), mpi::minimum<Index>());
-        numActiveMax = mpi::all_reduce(comm(), activeParticles.size() + localParticles.size(), mpi::maximum<Index>());
-        //std::cerr << "recvlist: " << datarecvlist.size() << ", sendlist: " << sendlist.size() << ", #active="<<activeParticles.size() << std::endl;
-    } while (numActiveMax > 0 || nextParticleToStart < allParticles.size());
+        if (!progress && !finished) {
+            // block until a tracing thread finishes, a message arrives or the termination check completes
+            MPI_Request requests[2] = {bellRequest, termination};
+            MPI_Status status;
+            int index = MPI_UNDEFINED;
+            MPI_Waitany(2, requests, &index, &status);
+            bellRequest = requests[0];
+            termination = requests[1];
+            if (index == 0)
+                ringBell(status);
+            else if (index == 1)
+                reduced();
+        }
+    }
+    MPI_Cancel(&bellRequest);
+    MPI_Wait(&bellRequest, MPI_STATUS_IGNORE);
+    global.traceFinished = nullptr;
+    for (auto &s: pendingSends) {
+        s.req.wait();
+        s.bellReq.wait();
+    }
+    pendingSends.clear();
 
     if (mpisize == 1) {
         for (auto p: allParticles) {
             p->finishSegment();
         }
     } else {
+        // tell owning ranks from which ranks to expect trajectory segments
+        std::vector<std::vector<Index>> sendIds(mpisize), recvIds;
+        for (auto id: datasendlist) {
+            auto p = allParticles[id];
+            if (p->rank() != rank())
+                sendIds[p->rank()].push_back(id);
+        }
+        mpi::all_to_all(comm(), sendIds, recvIds);
+        for (int src = 0; src < mpisize; ++src) {
+            for (auto id: recvIds[src]) {
+                datarecvlist.emplace_back(id, src);
+            }
+        }
+
         // iterate over all other ranks
         for (int i = 1; i < mpisize; ++i) {
             // start sending particles to owning rank
@@ -700,6 +928,19 @@ bool Tracer::reduce(int timestep)
         }
     }
 
+    if (mpisize > 1) {
+        // particles are deactivated on the rank where they stop, make stop reasons known everywhere
+        std::vector<int> reasons(allParticles.size()), globalReasons(allParticles.size());
+        for (size_t i = 0; i < allParticles.size(); ++i) {
+            reasons[i] = allParticles[i]->stopReason();
+        }
+        mpi::all_reduce(comm(), reasons.data(), reasons.size(), globalReasons.data(), mpi::maximum<int>());
+        for (size_t i = 0; i < allParticles.size(); ++i) {
+            if (globalReasons[i] != Particle::StillActive)
+                allParticles[i]->Deactivate((Particle::StopReason)globalReasons[i]);
+        }
+    }
+
     Scalar maxTime = 0;
     for (auto &p: allParticles) {
         maxTime = std::max(p->time(), maxTime);
@@ -1,6 +1,7 @@
 #ifndef TRACER_H
 #define TRACER_H
 
+#include <functional>
 #include <future>
 #include <vector>
 #include <map>
@@ -66,6 +67,8 @@ private:
     std::vector<vistle::Vec<vistle::Scalar>::ptr> timeField, distField, stepWidthField;
     std::mutex mutex;
 
+    std::function<void(vistle::Index)> traceFinished; //!< called from tracing thread when a particle stops
+
     Tracer *module = nullptr;
 };
 
@@ -109,6 +109,8 @@ ReadFOAM::ReadFOAM(const std::string &name, int moduleId, mpi::communicator comm
 
     observeParameter(m_casedir);
     //observeParameter(m_patchSelection);
+
+    setReadAhead(1);
 }
 
 
@@ -204,7 +206,97 @@ bool ReadFOAM::read(Reader::Token &token, int time, int part)
         return readConstant(casedir);
     }
 
-    return readTime(casedir, token.meta().timeStep());
+    bool ok = readTime(casedir, time, token.meta().timeStep());
+
+    // drop contents of files that have been prefetched but not been used, e.g. if a port has been disconnected
+    std::lock_guard<std::mutex> guard(m_prefetchMutex);
+    for (const auto &f: prefetchFiles(time))
+        m_prefetched.erase(f);
+
+    return ok;
+}
+
+std::map<double, std::string>::const_iterator ReadFOAM::timeDirectory(int time) const
+{
+    if (time < 0 || size_t(time) >= m_case.timedirs.size())
+        return m_case.timedirs.end();
+    auto ts = m_case.timedirs.begin();
+    std::advance(ts, time);
+    return ts;
+}
+
+std::vector<std::pair<std::string, std::string>> ReadFOAM::prefetchFiles(int time) const
+{
+    std::vector<std::pair<std::string, std::string>> files;
+    auto ts = timeDirectory(time);
+    if (ts == m_case.timedirs.end())
+        return files;
+
+    std::vector<std::string> fields;
+    for (int i = 0; i < NumPorts; ++i) {
+        if (m_volumeDataOut[i]->isConnected())
+            fields.push_back(m_fieldOut[i]->getValue());
+    }
+    for (int i = 0; i < NumBoundaryPorts; ++i) {
+        if (m_boundaryDataOut[i]->isConnected())
+            fields.push_back(m_boundaryOut[i]->getValue());
+    }
+
+    for (int i = -1; i < m_case.numblocks; ++i) {
+        if (rankForBlock(i) != rank())
+            continue;
+        std::string dir;
+        if (i >= 0)
+            dir = "processor" + std::to_string(i) + "/";
+        dir += ts->second + "/";
+        if (m_readGrid->getValue() && (m_case.varyingGrid || m_case.varyingCoords))
+            files.emplace_back(dir + "polyMesh", "points");
+        for (const auto &field: fields) {
+            if (m_case.varyingFields.find(field) != m_case.varyingFields.end())
+                files.emplace_back(dir, field);
+        }
+    }
+    return files;
+}
+
+bool ReadFOAM::prefetch(int time, int part)
+{
+    // members of archives are not read concurrently with reading a timestep
+    if (time < 0 || m_case.archived)
+        return true;
+    assert(part == -1);
+    (void)part;
+
+    for (const auto &f: prefetchFiles(time)) {
+        {
+            std::lock_guard<std::mutex> guard(m_prefetchMutex);
+            if (m_prefetched.find(f) != m_prefetched.end())
+                continue;
+        }
+        auto stream = m_case.getStreamForFile(f.first, f.second);
+        if (!stream)
+            continue;
+        auto contents = std::make_shared<std::stringstream>();
+        *contents << stream->rdbuf();
+        std::lock_guard<std::mutex> guard(m_prefetchMutex);
+        m_prefetched[f] = contents;
+    }
+
+    return true;
+}
+
+std::shared_ptr<std::istream> ReadFOAM::getStreamForFile(const std::string &dir, const std::string &file)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_prefetchMutex);
+        auto it = m_prefetched.find(std::make_pair(dir, file));
+        if (it != m_prefetched.end()) {
+            auto contents = it->second;
+            m_prefetched.erase(it);
+            return contents;
+        }
+    }
+    return m_case.getStreamForFile(dir, file);
 }
 
 bool ReadFOAM::prepareRead()
@@ -249,12 +341,15 @@ bool ReadFOAM::finishRead()
     m_procGhostCellCandidates.clear();
     m_verticesMappings.clear();
 
+    std::lock_guard<std::mutex> guard(m_prefetchMutex);
+    m_prefetched.clear();
+
     return true;
 }
 
 bool ReadFOAM::loadCoords(const std::string &meshdir, Coords::ptr grid)
 {
-    std::shared_ptr<std::istream> pointsIn = m_case.getStreamForFile(meshdir, "points");
+    std::shared_ptr<std::istream> pointsIn = getStreamForFile(meshdir, "points");
     if (!pointsIn)
         return false;
     HeaderInfo pointsH = readFoamHeader(*pointsIn);
@@ -297,7 +392,7 @@ GridDataContainer ReadFOAM::loadGrid(const std::string &meshdir, std::string top
     }
 
     //read mesh files
-    std::shared_ptr<std::istream> ownersIn = m_case.getStreamForFile(topologyDir, "owner");
+    std::shared_ptr<std::istream> ownersIn = getStreamForFile(topologyDir, "owner");
     if (!ownersIn)
         return result;
     HeaderInfo ownerH = readFoamHeader(*ownersIn);
@@ -309,7 +404,7 @@ GridDataContainer ReadFOAM::loadGrid(const std::string &meshdir, std::string top
     }
 
     {
-        std::shared_ptr<std::istream> facesIn = m_case.getStreamForFile(topologyDir, "faces");
+        std::shared_ptr<std::istream> facesIn = getStreamForFile(topologyDir, "faces");
         if (!facesIn)
             return result;
         HeaderInfo facesH = readFoamHeader(*facesIn);
@@ -319,7 +414,7 @@ GridDataContainer ReadFOAM::loadGrid(const std::string &meshdir, std::string top
             return result;
         }
 
-        std::shared_ptr<std::istream> neighboursIn = m_case.getStreamForFile(topologyDir, "neighbour");
+        std::shared_ptr<std::istream> neighboursIn = getStreamForFile(topologyDir, "neighbour");
         if (!neighboursIn)
             return result;
         HeaderInfo neighbourH = readFoamHeader(*neighboursIn);
@@ -651,7 +746,7 @@ GridDataContainer ReadFOAM::loadGrid(const std::string &meshdir, std::string top
 
 DataBase::ptr ReadFOAM::loadField(const std::string &meshdir, const std::string &field)
 {
-    std::shared_ptr<std::istream> stream = m_case.getStreamForFile(meshdir, field);
+    std::shared_ptr<std::istream> stream = getStreamForFile(meshdir, field);
     if (!stream) {
         std::cerr << "failed to open " << meshdir << "/" << field << std::endl;
         return DataBase::ptr();
@@ -712,7 +807,7 @@ std::vector<DataBase::ptr> ReadFOAM::loadBoundaryField(const std::string &meshdi
         }
     }
 
-    std::shared_ptr<std::istream> stream = m_case.getStreamForFile(meshdir, field);
+    std::shared_ptr<std::istream> stream = getStreamForFile(meshdir, field);
     if (!stream) {
         std::cerr << "failed to open " << meshdir << "/" << field << std::endl;
     }
@@ -862,7 +957,7 @@ bool ReadFOAM::loadFields(const std::string &meshdir, const std::map<std::string
 }
 
 
-bool ReadFOAM::readDirectory(const std::string &casedir, int processor, int timestep)
+bool ReadFOAM::readDirectory(const std::string &casedir, int processor, int time, int timestep)
 {
     std::string dir;
 
@@ -891,25 +986,17 @@ bool ReadFOAM::readDirectory(const std::string &casedir, int processor, int time
         return true;
     }
 
-    Index i = 0;
-    Index skipfactor = timeIncrement();
-    std::string completeMeshDir;
-    for (auto &ts: m_case.timedirs) {
-        if (i == timestep * skipfactor) {
-            completeMeshDir = dir;
-            auto it = m_case.completeMeshDirs.find(ts.first);
-            if (it != m_case.completeMeshDirs.end()) {
-                completeMeshDir = dir + it->second + "/";
-            }
-            dir += ts.second + "/";
-            break;
-        }
-        ++i;
-    }
-    if (i == m_case.timedirs.size()) {
-        std::cerr << "no directory for timestep " << timestep << " found" << std::endl;
+    auto ts = timeDirectory(time);
+    if (ts == m_case.timedirs.end()) {
+        std::cerr << "no directory for timestep " << time << " found" << std::endl;
         return false;
     }
+    std::string completeMeshDir = dir;
+    auto it = m_case.completeMeshDirs.find(ts->first);
+    if (it != m_case.completeMeshDirs.end()) {
+        completeMeshDir = dir + it->second + "/";
+    }
+    dir += ts->second + "/";
     if (m_case.varyingGrid || m_case.varyingCoords) {
         UnstructuredGrid::ptr grid;
         std::vector<Polygons::ptr> polygons;
@@ -1365,7 +1452,7 @@ bool ReadFOAM::readConstant(const std::string &casedir)
 {
     for (int i = -1; i < m_case.numblocks; ++i) {
         if (rankForBlock(i) == rank()) {
-            if (!readDirectory(casedir, i, -1))
+            if (!readDirectory(casedir, i, -1, -1))
                 return false;
         }
     }
@@ -1405,11 +1492,11 @@ bool ReadFOAM::readConstant(const std::string &casedir)
     return true;
 }
 
-bool ReadFOAM::readTime(const std::string &casedir, int timestep)
+bool ReadFOAM::readTime(const std::string &casedir, int time, int timestep)
 {
     for (int i = -1; i < m_case.numblocks; ++i) {
         if (rankForBlock(i) == rank()) {
-            if (!readDirectory(casedir, i, timestep))
+            if (!readDirectory(casedir, i, time, timestep))
                 return false;
         }
     }
@@ -1463,6 +1550,7 @@ bool ReadFOAM::readTime(const std::string &casedir, int timestep)
 
     m_GhostDataIn.clear();
     m_currentvolumedata.clear();
+
     return true;
 }
 
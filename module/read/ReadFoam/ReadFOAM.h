@@ -18,6 +18,8 @@
 
 #include <vector>
 #include <map>
+#include <mutex>
+#include <sstream>
 
 #include <vistle/core/polygons.h>
 #include <vistle/core/unstr.h>
@@ -121,12 +123,17 @@ private:
     // Reader interface
     bool examine(const vistle::Parameter *p) override;
     bool read(vistle::Reader::Token &token, int time, int part) override;
+    bool prefetch(int time, int part) override;
     bool prepareRead() override;
     bool finishRead() override;
 
     //! return MPI rank on which a block should be processed, takes OpenFOAM case, especially no. of blocks, into account
     int rankForBlock(int processor) const;
-    bool readDirectory(const std::string &dir, int processor, int timestep);
+    //! time directory for (absolute) time index, used for reading as well as for prefetching
+    std::map<double, std::string>::const_iterator timeDirectory(int time) const;
+    //! (directory, file) pairs varying for time that may be prefetched
+    std::vector<std::pair<std::string, std::string>> prefetchFiles(int time) const;
+    bool readDirectory(const std::string &dir, int processor, int time, int timestep);
     bool buildGhostCells(int processor, GhostMode mode);
     bool buildGhostCellData(int processor);
     void processAllRequests();
@@ -135,7 +142,7 @@ private:
     bool addGridToPorts(int processor);
     bool addVolumeDataToPorts(int processor);
     bool readConstant(const std::string &dir);
-    bool readTime(const std::string &dir, int timestep);
+    bool readTime(const std::string &dir, int time, int timestep);
     std::vector<vistle::Index> getAdjacentCells(const vistle::Index &cell, const DimensionInfo &dim,
                                                 const std::vector<std::vector<vistle::Index>> &cellfacemap,
                                                 const std::vector<vistle::Index> &owners,
@@ -147,6 +154,8 @@ private:
                    const std::vector<std::vector<vistle::Index>> &faces, const std::vector<vistle::Index> &owners,
                    const std::vector<vistle::Index> &neighbours);
 
+    //! stream for file contents loaded by prefetch, otherwise for file in case
+    std::shared_ptr<std::istream> getStreamForFile(const std::string &dir, const std::string &file);
     bool loadCoords(const std::string &meshdir, vistle::Coords::ptr grid);
     GridDataContainer loadGrid(const std::string &dir, std::string topologyDir = std::string());
     vistle::DataBase::ptr loadField(const std::string &dir, const std::string &field);
@@ -170,5 +179,8 @@ private:
     std::map<int, std::map<int, std::map<int, std::shared_ptr<GhostData>>>> m_GhostDataIn;
     std::vector<boost::mpi::request> m_requests;
     std::map<int, std::map<int, std::map<vistle::Index, vistle::SIndex>>> m_verticesMappings;
+
+    std::mutex m_prefetchMutex;
+    std::map<std::pair<std::string, std::string>, std::shared_ptr<std::stringstream>> m_prefetched; // (directory, file) -> contents
 };
 #endif // READFOAM_H
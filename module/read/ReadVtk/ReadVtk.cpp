@@ -379,6 +379,7 @@ ReadVtk::ReadVtk(const std::string &name, int moduleID, mpi::communicator comm):
     }
 
     setParallelizationMode(ParallelizeTimeAndBlocks);
+    setReadAhead(1);
     observeParameter(m_filename);
     observeParameter(m_readPieces);
 }
@@ -477,64 +478,91 @@ bool ReadVtk::finishRead()
     delete m_d;
     m_d = nullptr;
 
+    // data sets prefetched for blocks that have not been read
+    for (auto &p: m_prefetched) {
+        if (p.second.dataset)
+            p.second.dataset->Delete();
+    }
+    m_prefetched.clear();
+
     return true;
 }
 
-bool ReadVtk::read(Token &token, int timestep, int block)
+template<class Func>
+bool ReadVtk::forEachFile(int timestep, int block, Func func)
 {
     const bool readPieces = m_readPieces->getValue();
-    const bool ghostCells = m_ghostCells->getValue();
-
-    vistle::Meta m;
-    m.setBlock(block);
-    m.setNumBlocks(token.meta().numBlocks());
-    m.setTimeStep(timestep);
-    m.setNumTimesteps(token.meta().numTimesteps());
 
     if (m_d->timesteps.empty()) {
         const std::string filename = m_filename->getValue();
-        if (readPieces) {
-            return load(token, filename, m, block, ghostCells);
-        } else {
-            return load(token, filename);
-        }
-    } else {
-        bool constant = true;
-        double t = ConstantTime;
-        if (timestep >= 0) {
-            if (size_t(timestep) >= m_d->times.size())
-                return false;
-
-            constant = false;
-            t = m_d->times[timestep];
-        }
-
-        //std::cerr << "Reading t=" << timestep << " (#=" << token.meta().numTimesteps() << ") , block=" << block << " (#=" << token.meta().numBlocks() << ")" << std::endl;
-
-        auto it = m_d->timesteps.find(t);
-        if (it != m_d->timesteps.end()) {
-            int b = 0;
-            for (auto f: it->second) {
-                if (!constant)
-                    m.setRealTime(f.realtime);
+        return func(filename, readPieces ? block : -1, std::string());
+    }
 
-                if (b <= block && block < b + f.pieces) {
-                    if (!load(token, f.filename, m, readPieces ? block - b : -1, ghostCells, f.part))
-                        return false;
-                }
+    double t = ConstantTime;
+    if (timestep >= 0) {
+        if (size_t(timestep) >= m_d->times.size())
+            return false;
+        t = m_d->times[timestep];
+    }
 
-                b += f.pieces;
+    auto it = m_d->timesteps.find(t);
+    if (it != m_d->timesteps.end()) {
+        int b = 0;
+        for (const auto &f: it->second) {
+            if (b <= block && block < b + f.pieces) {
+                if (!func(f.filename, readPieces ? block - b : -1, f.part))
+                    return false;
             }
+            b += f.pieces;
         }
     }
 
     return true;
 }
 
+bool ReadVtk::read(Token &token, int timestep, int block)
+{
+    const bool ghostCells = m_ghostCells->getValue();
+
+    //std::cerr << "Reading t=" << timestep << " (#=" << token.meta().numTimesteps() << ") , block=" << block << " (#=" << token.meta().numBlocks() << ")" << std::endl;
+
+    return forEachFile(timestep, block, [this, &token, ghostCells](const std::string &filename, int piece,
+                                                                    const std::string &part) {
+        return load(token, filename, vistle::Meta(), piece, ghostCells, part);
+    });
+}
+
+bool ReadVtk::prefetch(int timestep, int block)
+{
+    const bool ghostCells = m_ghostCells->getValue();
+
+    // parse files into VTK data sets, conversion to Vistle objects is left to read
+    return forEachFile(timestep, block, [this, ghostCells](const std::string &filename, int piece,
+                                                           const std::string &) {
+        auto fileinfo = getDataSet(filename, piece, ghostCells);
+        std::lock_guard<std::mutex> guard(m_prefetchMutex);
+        auto &prefetched = m_prefetched[std::make_pair(filename, piece)];
+        if (prefetched.dataset)
+            prefetched.dataset->Delete();
+        prefetched = fileinfo;
+        return true;
+    });
+}
+
 bool ReadVtk::load(Token &token, const std::string &filename, const vistle::Meta &meta, int piece, bool ghost,
-                   const std::string &part) const
+                   const std::string &part)
 {
-    auto ds_pieces = getDataSet(filename, piece, ghost);
+    VtkFile ds_pieces;
+    {
+        std::lock_guard<std::mutex> guard(m_prefetchMutex);
+        auto it = m_prefetched.find(std::make_pair(filename, piece));
+        if (it != m_prefetched.end()) {
+            ds_pieces = it->second;
+            m_prefetched.erase(it);
+        }
+    }
+    if (!ds_pieces.dataset)
+        ds_pieces = getDataSet(filename, piece, ghost);
     auto dobj = ds_pieces.dataset;
     if (!dobj) {
         sendError("could not read data set '%s'", filename.c_str());
@@ -5,6 +5,8 @@
 
 #include <vector>
 #include <string>
+#include <map>
+#include <mutex>
 
 class vtkDataSet;
 class vtkDataObject;
@@ -33,6 +35,7 @@ public:
     // reader interface
     bool examine(const vistle::Parameter *param) override;
     bool read(vistle::Reader::Token &token, int timestep = -1, int block = -1) override;
+    bool prefetch(int timestep = -1, int block = -1) override;
     bool prepareRead() override;
     bool finishRead() override;
 
@@ -43,7 +46,10 @@ private:
     //bool compute() override;
 
     bool load(Token &token, const std::string &filename, const vistle::Meta &meta = vistle::Meta(), int piece = -1,
-              bool ghost = false, const std::string &part = std::string()) const;
+              bool ghost = false, const std::string &part = std::string());
+    //! call func with file name, piece and part of every file contributing to timestep and block
+    template<class Func>
+    bool forEachFile(int timestep, int block, Func func);
     void setChoices(const VtkFile &fileinfo);
 
     VtkFile getDataSetMeta(const std::string &filename);
@@ -57,6 +63,9 @@ private:
 
     ReadVtkData *m_d = nullptr;
     std::map<std::string, VtkFile> m_files;
+
+    std::mutex m_prefetchMutex;
+    std::map<std::pair<std::string, int>, VtkFile> m_prefetched; // (filename, piece) -> data set read by prefetch
 };
 
 #endif
@@ -579,7 +579,7 @@ std::shared_ptr<vistle::RenderObject> COVER::addObject(int senderId, const std::
 
     if (VistleGeometryGenerator::isSupported(objType)) {
         auto vgr = VistleGeometryGenerator(pro, geometry, normals, texture);
-        auto cache = getOrCreateGeometryCache<GeometryCache>(senderId, senderPort);
+        auto cache = getOrCreateGeometryCache<GeometryCache>(senderId, senderPort, ResultCacheBase::Persistent);
         vgr.setGeometryCache(*cache);
         auto species = vgr.species();
         if (!species.empty()) {
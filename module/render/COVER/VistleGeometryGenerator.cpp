@@ -3,6 +3,7 @@
 #include <cmath>
 #include <algorithm>
 #include <type_traits>
+#include <sstream>
 
 #include <osg/Geode>
 #include <osg/Geometry>
@@ -232,6 +233,19 @@ std::vector<PrimitiveBin> binPrimitives(typename Geo::const_ptr geo, size_t numP
     return binPrimitivesRec(0, adp, bounds.first, bounds.second, bin, numPrimitives);
 }
 
+// OSG arrays derived from geometry and normals only depend on these and on how they are laid out,
+// so they can be shared between all render objects with the same geometry, regardless of mapped data
+std::string geometryCacheKey(vistle::Object::const_ptr geo, vistle::Object::const_ptr normals, bool indexGeom,
+                             size_t numPrimitives)
+{
+    std::stringstream key;
+    key << geo->getName() << ":" << geo->getGeneration();
+    if (normals)
+        key << "/n=" << normals->getName();
+    key << "/i=" << indexGeom << "/p=" << numPrimitives;
+    return key.str();
+}
+
 VistleGeometryGenerator::VistleGeometryGenerator(std::shared_ptr<vistle::RenderObject> ro,
                                                  vistle::Object::const_ptr geo, vistle::Object::const_ptr normal,
                                                  vistle::Object::const_ptr mapped)
@@ -958,7 +972,7 @@ osg::Geode *VistleGeometryGenerator::operator()(osg::ref_ptr<osg::StateSet> defa
     bool cached = false;
     ResultCache<GeometryCache>::Entry *cacheEntry = nullptr;
     if (m_cache) {
-        cacheEntry = m_cache->getOrLock(m_geo->getName(), cache);
+        cacheEntry = m_cache->getOrLock(geometryCacheKey(m_geo, normals, indexGeom, numPrimitives), cache);
         if (!cacheEntry)
             cached = true;
         if (cached)
@@ -1017,12 +1031,18 @@ osg::Geode *VistleGeometryGenerator::operator()(osg::ref_ptr<osg::StateSet> defa
 #ifdef COVER_PLUGIN
             if (radius) {
                 haveSpheres = true;
-                const vistle::Scalar *r = &radius->x()[0];
-
-                osg::ref_ptr<osg::FloatArray> rad = new osg::FloatArray();
-                rad->reserve(numVertices);
-                for (Index v = 0; v < numVertices; v++)
-                    rad->push_back(r[v]);
+                osg::ref_ptr<osg::FloatArray> rad;
+                if (cached) {
+                    std::unique_lock<GeometryCache> guard(cache);
+                    rad = cache.radii.front();
+                } else {
+                    const vistle::Scalar *r = &radius->x()[0];
+                    rad = new osg::FloatArray();
+                    rad->reserve(numVertices);
+                    for (Index v = 0; v < numVertices; v++)
+                        rad->push_back(r[v]);
+                    cache.radii.push_back(rad);
+                }
                 geom->setVertexAttribArray(RadiusAttrib, rad, osg::Array::BIND_PER_VERTEX);
 
                 geom->setUseDisplayList(false);
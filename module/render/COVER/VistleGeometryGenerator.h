@@ -43,6 +43,8 @@ struct OsgColorMap {
 
 typedef std::map<std::string, OsgColorMap> OsgColorMapMap;
 
+//! OSG arrays depending only on geometry and normals, shared between render objects using the same shm objects:
+//! only per-vertex data and texture coordinates are generated for every render object
 struct GeometryCache {
     GeometryCache(): mutex(std::make_shared<std::mutex>()) {}
     void lock()
@@ -60,6 +62,7 @@ struct GeometryCache {
     std::vector<osg::ref_ptr<osg::Vec3Array>> vertices;
     std::vector<osg::ref_ptr<osg::Vec3Array>> normals;
     std::vector<osg::ref_ptr<osg::PrimitiveSet>> primitives;
+    std::vector<osg::ref_ptr<osg::FloatArray>> radii;
 };
 
 class VistleGeometryGenerator {
@@ -499,6 +499,8 @@ bool RemoteConnection::handleRemoteRenderMessage(message::RemoteRenderMessage &m
 
 void RemoteConnection::connectionEstablished()
 {
+    m_tileCache.clear();
+
     setVisibleTimestep(m_visibleTimestep);
     if (m_requestedTimestep != -1) {
         requestTimestep(m_requestedTimestep);
@@ -520,7 +522,9 @@ void RemoteConnection::connectionEstablished()
 }
 
 void RemoteConnection::connectionClosed()
-{}
+{
+    m_tileCache.clear();
+}
 
 bool RemoteConnection::requestTimestep(int t, int numTime)
 {
@@ -772,6 +776,7 @@ bool RemoteConnection::handleTile(const RemoteRenderMessage &msg, const tileMsg
     assert(payload);
     assert(payload->size() == msg.payloadSize());
     auto m = std::make_shared<RemoteRenderMessage>(msg);
+    resolveUnchangedTile(m, payload);
     if (m_handleTilesAsync) {
         m_receivedTiles.push_back(TileMessage(m, payload));
         if (tile.flags & rfbTileLast)
@@ -813,6 +818,56 @@ bool RemoteConnection::handleTile(const RemoteRenderMessage &msg, const tileMsg
     return true;
 }
 
+// substitute tiles marked as unchanged with the tile received previously for the same position,
+// remember all other tiles
+bool RemoteConnection::resolveUnchangedTile(std::shared_ptr<RemoteRenderMessage> &msg, std::shared_ptr<buffer> &payload)
+{
+    auto &tile = static_cast<tileMsg &>(msg->rhr());
+    if (tile.width == 0 || tile.height == 0)
+        return true;
+
+    auto &vt = m_tileCache[tile.viewNum];
+    if (vt.width != tile.totalwidth || vt.height != tile.totalheight) {
+        vt.tiles.clear();
+        vt.width = tile.totalwidth;
+        vt.height = tile.totalheight;
+    }
+    const std::array<int, 5> key{tile.x, tile.y, tile.width, tile.height, tile.format != rfbColorRGBA};
+
+    if (!(tile.flags & rfbTileUnchanged)) {
+        vt.tiles[key] = std::make_pair(msg, payload);
+        return true;
+    }
+
+    tile.flags &= ~rfbTileUnchanged;
+    auto it = vt.tiles.find(key);
+    if (it == vt.tiles.end()) {
+        CERR << "no previous data for unchanged tile: view=" << tile.viewNum << ", " << tile.width << "x"
+             << tile.height << "@" << tile.x << "+" << tile.y << std::endl;
+        return false;
+    }
+
+    // keep payload description from previous tile, take everything else from current one
+    auto resolved = std::make_shared<RemoteRenderMessage>(*it->second.first);
+    auto &rt = static_cast<tileMsg &>(resolved->rhr());
+    rt.modificationCount = tile.modificationCount;
+    rt.flags = tile.flags;
+    rt.eye = tile.eye;
+    rt.frameNumber = tile.frameNumber;
+    rt.requestNumber = tile.requestNumber;
+    rt.timestep = tile.timestep;
+    rt.requestTime = tile.requestTime;
+    for (int i = 0; i < 16; ++i) {
+        rt.head[i] = tile.head[i];
+        rt.view[i] = tile.view[i];
+        rt.proj[i] = tile.proj[i];
+        rt.model[i] = tile.model[i];
+    }
+    msg = resolved;
+    payload = it->second.second;
+    return true;
+}
+
 void RemoteConnection::gatherTileStats(const RemoteRenderMessage &remote, const tileMsg &msg)
 {
     if (msg.flags & rfbTileFirst) {
@@ -1,6 +1,7 @@
 #ifndef REMOTECONNECTION_H
 #define REMOTECONNECTION_H
 
+#include <array>
 #include <deque>
 #include <map>
 #include <memory>
@@ -80,6 +81,16 @@ public:
     bool m_initialized = false;
     std::deque<TileMessage> m_receivedTiles;
     std::deque<size_t> m_lastTileAt;
+    //! tiles last received for a view, for substituting tiles that the server reports as unchanged
+    struct ViewTiles {
+        int width = 0, height = 0;
+        std::map<std::array<int, 5>, std::pair<std::shared_ptr<vistle::message::RemoteRenderMessage>,
+                                               std::shared_ptr<vistle::buffer>>>
+            tiles;
+    };
+    std::map<int, ViewTiles> m_tileCache;
+    bool resolveUnchangedTile(std::shared_ptr<vistle::message::RemoteRenderMessage> &msg,
+                              std::shared_ptr<vistle::buffer> &payload);
     std::map<std::string, vistle::RenderObject::InitialVariantVisibility> m_variantsToAdd;
     std::set<std::string> m_variantsToRemove;
     std::map<std::string, std::shared_ptr<VariantRenderObject>> m_variants;
@@ -109,6 +109,25 @@ public:
                                             vistle::Object::const_ptr texture) override;
 
     void removeObject(std::shared_ptr<RenderObject> ro) override;
+    std::shared_ptr<RenderObject> addLevelOfDetail(std::shared_ptr<RenderObject> ro, vistle::Object::const_ptr geometry,
+                                                   vistle::Object::const_ptr texture) override;
+
+    std::shared_ptr<RayRenderObject> createRenderObject(int sender, const std::string &senderPort,
+                                                        vistle::Object::const_ptr container,
+                                                        vistle::Object::const_ptr geometry,
+                                                        vistle::Object::const_ptr normals,
+                                                        vistle::Object::const_ptr texture);
+    void destroyRenderObject(std::shared_ptr<RayRenderObject> ro);
+    //! enable ro or its simplified version
+    void showObject(const std::shared_ptr<RayRenderObject> &ro, bool visible);
+    bool m_useLod = false;
+
+    // Embree scenes are shared among objects with the same geometry object (e.g. for time-varying mapped data),
+    // scenes of removed objects are kept for a while for refitting to new objects with the same topology
+    std::shared_ptr<RayGeometry> getGeometry(vistle::Object::const_ptr geometry);
+    void expireRetiredGeometry();
+    std::map<std::string, std::weak_ptr<RayGeometry>> m_geometryCache;
+    std::multimap<std::string, std::pair<double, std::shared_ptr<RayGeometry>>> m_retiredGeometry;
 
     std::vector<ispc::RenderObjectData *> instances;
 
@@ -158,6 +177,8 @@ DisCOVERay::DisCOVERay(const std::string &name, int moduleId, mpi::communicator
     m_pointSizeParam = addFloatParameter("point_size", "size of points", RayRenderObject::pointSize);
     setParameterRange(m_pointSizeParam, (Float)0, (Float)1e6);
 
+    enableLevelOfDetail();
+
     m_device = rtcNewDevice("verbose=0");
     if (!m_device) {
         CERR << "failed to create device" << std::endl;
@@ -166,13 +187,15 @@ DisCOVERay::DisCOVERay(const std::string &name, int moduleId, mpi::communicator
     rtcSetDeviceErrorFunction(m_device, rtcErrorCallback, nullptr);
     m_scene = rtcNewScene(m_device);
     rtcSetSceneFlags(m_scene, RTC_SCENE_FLAG_DYNAMIC);
-    rtcSetSceneBuildQuality(m_scene, RTC_BUILD_QUALITY_MEDIUM);
+    // top-level scene only holds instances and is re-committed whenever objects are added or time steps switched
+    rtcSetSceneBuildQuality(m_scene, RTC_BUILD_QUALITY_LOW);
     rtcCommitScene(m_scene);
 }
 
 
 DisCOVERay::~DisCOVERay()
 {
+    m_retiredGeometry.clear();
     rtcReleaseScene(m_scene);
     rtcReleaseDevice(m_device);
 }
@@ -388,6 +411,8 @@ bool DisCOVERay::render()
     // ensure that previous frame is completed
     bool immed_resched = m_renderManager.finishFrame(m_timestep);
 
+    expireRetiredGeometry();
+
     //vistle::StopWatch timer("render");
 
     const size_t numTimesteps = anim_geometry.size();
@@ -395,35 +420,24 @@ bool DisCOVERay::render()
         return immed_resched;
     }
 
-    // switch time steps in embree scene
-    if (m_timestep != m_renderManager.timestep() || m_renderManager.sceneChanged()) {
+    // switch time steps and level of detail in embree scene
+    const bool useLod = levelOfDetailEnabled() && m_renderManager.interacting();
+    const bool lodChanged = useLod != m_useLod;
+    if (m_timestep != m_renderManager.timestep() || m_renderManager.sceneChanged() || lodChanged) {
+        m_useLod = useLod;
         if (m_timestep >= 0 && anim_geometry.size() > unsigned(m_timestep) &&
             m_timestep != m_renderManager.timestep()) {
             for (auto &ro: anim_geometry[m_timestep])
-                if (ro->data->scene)
-                    rtcDisableGeometry(ro->data->geom);
+                showObject(ro, false);
         }
         m_timestep = m_renderManager.timestep();
         if (m_timestep >= 0 && anim_geometry.size() > unsigned(m_timestep)) {
             for (auto &ro: anim_geometry[m_timestep])
-                if (ro->data->scene) {
-                    if (m_renderManager.isVariantVisible(ro->variant)) {
-                        rtcEnableGeometry(ro->data->geom);
-                    } else {
-                        rtcDisableGeometry(ro->data->geom);
-                    }
-                }
+                showObject(ro, m_renderManager.isVariantVisible(ro->variant));
         }
-        if (m_renderManager.sceneChanged()) {
-            for (auto &ro: static_geometry) {
-                if (ro->data->scene) {
-                    if (m_renderManager.isVariantVisible(ro->variant)) {
-                        rtcEnableGeometry(ro->data->geom);
-                    } else {
-                        rtcDisableGeometry(ro->data->geom);
-                    }
-                }
-            }
+        if (m_renderManager.sceneChanged() || lodChanged) {
+            for (auto &ro: static_geometry)
+                showObject(ro, m_renderManager.isVariantVisible(ro->variant));
         }
         rtcCommitScene(m_scene);
     }
@@ -570,9 +584,27 @@ void DisCOVERay::renderRect(const vistle::Matrix4 &P, const vistle::Matrix4 &MV,
 }
 
 
-void DisCOVERay::removeObject(std::shared_ptr<RenderObject> vro)
+void DisCOVERay::showObject(const std::shared_ptr<RayRenderObject> &ro, bool visible)
+{
+    auto enable = [](ispc::RenderObjectData *rod, bool on) {
+        if (!rod->scene)
+            return;
+        if (on) {
+            rtcEnableGeometry(rod->geom);
+        } else {
+            rtcDisableGeometry(rod->geom);
+        }
+    };
+
+    auto lod = std::static_pointer_cast<RayRenderObject>(ro->lod);
+    const bool showLod = visible && m_useLod && lod;
+    enable(ro->data.get(), visible && !showLod);
+    if (lod)
+        enable(lod->data.get(), showLod);
+}
+
+void DisCOVERay::destroyRenderObject(std::shared_ptr<RayRenderObject> ro)
 {
-    auto ro = std::static_pointer_cast<RayRenderObject>(vro);
     auto *rod = ro->data.get();
 
     if (rod->instID != RTC_INVALID_GEOMETRY_ID) {
@@ -586,6 +618,22 @@ void DisCOVERay::removeObject(std::shared_ptr<RenderObject> vro)
         rtcCommitScene(m_scene);
     }
 
+    // keep geometry for refitting if this was its last user
+    auto &geo = ro->rayGeometry;
+    if (geo && geo.use_count() == 1 && !geo->topology.empty()) {
+        m_retiredGeometry.emplace(geo->topology, std::make_pair(Clock::time(), geo));
+    }
+}
+
+void DisCOVERay::removeObject(std::shared_ptr<RenderObject> vro)
+{
+    auto ro = std::static_pointer_cast<RayRenderObject>(vro);
+    if (ro->lod) {
+        destroyRenderObject(std::static_pointer_cast<RayRenderObject>(ro->lod));
+        ro->lod.reset();
+    }
+    destroyRenderObject(ro);
+
     const int t = ro->timestep;
     auto &objlist = t >= 0 ? anim_geometry[t] : static_geometry;
 
@@ -609,13 +657,79 @@ void DisCOVERay::removeObject(std::shared_ptr<RenderObject> vro)
 }
 
 
-std::shared_ptr<RenderObject> DisCOVERay::addObject(int sender, const std::string &senderPort,
-                                                    vistle::Object::const_ptr container,
-                                                    vistle::Object::const_ptr geometry,
-                                                    vistle::Object::const_ptr normals,
-                                                    vistle::Object::const_ptr texture)
+std::shared_ptr<RayGeometry> DisCOVERay::getGeometry(vistle::Object::const_ptr geometry)
+{
+    if (!geometry || geometry->isEmpty())
+        return nullptr;
+
+    auto it = m_geometryCache.find(geometry->getName());
+    if (it != m_geometryCache.end()) {
+        auto geo = it->second.lock();
+        if (geo && (geo->pointSize < 0 || geo->pointSize == RayRenderObject::pointSize)) {
+            // in use again after all its previous users have been removed
+            auto range = m_retiredGeometry.equal_range(geo->topology);
+            for (auto r = range.first; r != range.second; ++r) {
+                if (r->second.second == geo) {
+                    m_retiredGeometry.erase(r);
+                    break;
+                }
+            }
+            return geo;
+        }
+        m_geometryCache.erase(it);
+    }
+
+    auto topology = RayGeometry::topologyKey(geometry);
+    if (!topology.empty()) {
+        auto retired = m_retiredGeometry.find(topology);
+        if (retired != m_retiredGeometry.end()) {
+            auto geo = retired->second.second;
+            m_retiredGeometry.erase(retired);
+            m_geometryCache.erase(geo->geometry->getName());
+            if (geo->refit(geometry)) {
+                m_geometryCache[geometry->getName()] = geo;
+                return geo;
+            }
+        }
+    }
+
+    auto geo = std::make_shared<RayGeometry>(m_device, geometry);
+    m_geometryCache[geometry->getName()] = geo;
+    return geo;
+}
+
+void DisCOVERay::expireRetiredGeometry()
+{
+    // objects of a new generation arrive over several frames after all old ones have been removed
+    const double RetiredGeometryTimeout = 10.;
+    const double now = Clock::time();
+    bool expired = false;
+    for (auto it = m_retiredGeometry.begin(); it != m_retiredGeometry.end();) {
+        if (now - it->second.first > RetiredGeometryTimeout) {
+            it = m_retiredGeometry.erase(it);
+            expired = true;
+        } else {
+            ++it;
+        }
+    }
+    if (!expired)
+        return;
+    for (auto it = m_geometryCache.begin(); it != m_geometryCache.end();) {
+        if (it->second.expired())
+            it = m_geometryCache.erase(it);
+        else
+            ++it;
+    }
+}
+
+std::shared_ptr<RayRenderObject> DisCOVERay::createRenderObject(int sender, const std::string &senderPort,
+                                                                vistle::Object::const_ptr container,
+                                                                vistle::Object::const_ptr geometry,
+                                                                vistle::Object::const_ptr normals,
+                                                                vistle::Object::const_ptr texture)
 {
-    auto ro = std::make_shared<RayRenderObject>(m_device, sender, senderPort, container, geometry, normals, texture);
+    auto ro = std::make_shared<RayRenderObject>(m_device, getGeometry(geometry), sender, senderPort, container,
+                                                geometry, normals, texture);
 
     std::string species = container->getAttribute("_species");
     if (!species.empty() && !ro->data->cmap) {
@@ -631,15 +745,6 @@ std::shared_ptr<RenderObject> DisCOVERay::addObject(int sender, const std::strin
         ro->data->cmap = cmap.cmap.get();
     }
 
-    const int t = ro->timestep;
-    if (t == -1) {
-        static_geometry.push_back(ro);
-    } else {
-        if (anim_geometry.size() <= size_t(t))
-            anim_geometry.resize(t + 1);
-        anim_geometry[t].push_back(ro);
-    }
-
     auto rod = ro->data.get();
     if (rod->scene) {
         rod->geom = rtcNewGeometry(m_device, RTC_GEOMETRY_TYPE_INSTANCE);
@@ -664,11 +769,33 @@ std::shared_ptr<RenderObject> DisCOVERay::addObject(int sender, const std::strin
         }
         rtcSetGeometryTransform(rod->geom, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, transform);
         rtcCommitGeometry(rod->geom);
+        rtcDisableGeometry(rod->geom);
+    }
+
+    return ro;
+}
+
+std::shared_ptr<RenderObject> DisCOVERay::addObject(int sender, const std::string &senderPort,
+                                                    vistle::Object::const_ptr container,
+                                                    vistle::Object::const_ptr geometry,
+                                                    vistle::Object::const_ptr normals,
+                                                    vistle::Object::const_ptr texture)
+{
+    auto ro = createRenderObject(sender, senderPort, container, geometry, normals, texture);
+
+    const int t = ro->timestep;
+    if (t == -1) {
+        static_geometry.push_back(ro);
+    } else {
+        if (anim_geometry.size() <= size_t(t))
+            anim_geometry.resize(t + 1);
+        anim_geometry[t].push_back(ro);
+    }
+
+    if (ro->data->scene) {
         if (t == -1 || t == m_timestep) {
-            rtcEnableGeometry(rod->geom);
+            rtcEnableGeometry(ro->data->geom);
             m_renderManager.setModified();
-        } else {
-            rtcDisableGeometry(rod->geom);
         }
         rtcCommitScene(m_scene);
     }
@@ -678,6 +805,27 @@ std::shared_ptr<RenderObject> DisCOVERay::addObject(int sender, const std::strin
     return ro;
 }
 
+std::shared_ptr<RenderObject> DisCOVERay::addLevelOfDetail(std::shared_ptr<RenderObject> vro,
+                                                           vistle::Object::const_ptr geometry,
+                                                           vistle::Object::const_ptr texture)
+{
+    auto ro = std::static_pointer_cast<RayRenderObject>(vro);
+    auto lod = createRenderObject(ro->senderId, ro->senderPort, ro->container, geometry, nullptr, texture);
+    if (!lod->data->scene)
+        return nullptr;
+    ro->lod = lod;
+
+    const int t = ro->timestep;
+    if (t == -1 || t == m_timestep) {
+        showObject(ro, m_renderManager.isVariantVisible(ro->variant));
+        if (m_useLod)
+            m_renderManager.setModified();
+    }
+    rtcCommitScene(m_scene);
+
+    return lod;
+}
+
 bool DisCOVERay::handleMessage(const vistle::message::Message *message, const vistle::MessagePayload &payload)
 {
     if (m_renderManager.handleMessage(message, payload)) {
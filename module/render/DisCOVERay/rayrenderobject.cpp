@@ -5,6 +5,7 @@
 #include <vistle/core/points.h>
 #include <vistle/core/vec.h>
 #include <vistle/core/celltypes.h>
+#include <vistle/core/coords.h>
 
 #include <cassert>
 
@@ -40,16 +41,31 @@ Index getGhost(typename Geo::const_ptr &geo, const vistle::Byte *&ghost)
     }
     return numGhost;
 }
-} // namespace
 
+void copyVertices(Vertex *vertices, vistle::Coords::const_ptr coords)
+{
+    const Scalar *x = &coords->x()[0], *y = &coords->y()[0], *z = &coords->z()[0];
+    for (Index i = 0; i < coords->getNumCoords(); ++i) {
+        vertices[i].x = x[i];
+        vertices[i].y = y[i];
+        vertices[i].z = z[i];
+    }
+}
 
-RayRenderObject::RayRenderObject(RTCDevice device, int senderId, const std::string &senderPort,
-                                 Object::const_ptr container, Object::const_ptr geometry, Object::const_ptr normals,
-                                 Object::const_ptr texture)
-: vistle::RenderObject(senderId, senderPort, container, geometry, normals, texture), data(new ispc::RenderObjectData)
+template<class Array>
+std::string arrayKey(const Array &array)
 {
-    updateBounds();
+    // empty arrays are not shared between objects
+    if (!array.valid() || array->size() == 0)
+        return "-";
+    return array.name();
+}
+} // namespace
+
 
+RayGeometry::RayGeometry(RTCDevice device, Object::const_ptr geometry)
+: geometry(geometry), topology(topologyKey(geometry)), data(new ispc::RenderObjectData())
+{
     data->device = device;
     data->scene = nullptr;
     data->geomID = RTC_INVALID_GEOMETRY_ID;
@@ -58,65 +74,7 @@ RayRenderObject::RayRenderObject(RTCDevice device, int senderId, const std::stri
     data->primitiveFlags = nullptr;
     data->indexBuffer = nullptr;
     data->triangles = 1;
-    data->texCoords = nullptr;
     data->lighted = 1;
-    data->hasSolidColor = hasSolidColor;
-    data->perPrimitiveMapping = 0;
-    data->normalsPerPrimitiveMapping = 0;
-    data->cmap = nullptr;
-    for (int c = 0; c < 3; ++c) {
-        data->normalTransform[c].x = c == 0 ? 1 : 0;
-        data->normalTransform[c].y = c == 1 ? 1 : 0;
-        data->normalTransform[c].z = c == 2 ? 1 : 0;
-    }
-    for (int c = 0; c < 3; ++c) {
-        data->normals[c] = nullptr;
-    }
-    for (int c = 0; c < 4; ++c) {
-        data->solidColor[c] = solidColor[c];
-    }
-    if (this->mapdata) {
-        if (this->mapdata->guessMapping(geometry) == DataBase::Element)
-            data->perPrimitiveMapping = 1;
-    }
-    if (auto t = Texture1D::as(this->mapdata)) {
-        data->texCoords = &t->coords()[0];
-
-        cmap.reset(new ispc::ColorMapData);
-        data->cmap = cmap.get();
-        data->cmap->texData = t->pixels().data();
-        data->cmap->texWidth = t->getWidth();
-        // texcoords as computed by Color module are between 0 and 1
-        data->cmap->min = 0.;
-        data->cmap->max = 1.;
-        data->cmap->blendWithMaterial = 0;
-
-        std::cerr << "texcoords from texture" << std::endl;
-    } else if (auto s = Vec<Scalar, 1>::as(this->mapdata)) {
-        data->texCoords = &s->x()[0];
-
-        std::cerr << "texcoords from scalar field" << std::endl;
-
-    } else if (auto vec = Vec<Scalar, 3>::as(this->mapdata)) {
-        tcoord.resize(vec->getSize());
-        data->texCoords = tcoord.data();
-        const Scalar *x = &vec->x()[0];
-        const Scalar *y = &vec->y()[0];
-        const Scalar *z = &vec->z()[0];
-        for (auto it = tcoord.begin(); it != tcoord.end(); ++it) {
-            *it = sqrtf(*x * *x + *y * *y + *z * *z);
-            ++x;
-            ++y;
-            ++z;
-        }
-    } else if (auto iscal = Vec<Index>::as(this->mapdata)) {
-        tcoord.resize(iscal->getSize());
-        data->texCoords = tcoord.data();
-        vistle::Scalar *d = tcoord.data();
-        for (const Index *i = &iscal->x()[0], *end = i + iscal->getSize(); i < end; ++i) {
-            *d++ = *i;
-        }
-    }
 
     if (!geometry || geometry->isEmpty()) {
         return;
@@ -126,8 +84,6 @@ RayRenderObject::RayRenderObject(RTCDevice device, int senderId, const std::stri
     rtcSetSceneFlags(data->scene, RTC_SCENE_FLAG_NONE);
     rtcSetSceneBuildQuality(data->scene, RTC_BUILD_QUALITY_MEDIUM);
 
-    RTCGeometry geom = 0;
-    bool useNormals = true;
     const vistle::Byte *ghost = nullptr;
 
     if (auto quads = Quads::as(geometry)) {
@@ -141,11 +97,7 @@ RayRenderObject::RayRenderObject(RTCDevice device, int senderId, const std::stri
 
         Vertex *vertices = (Vertex *)rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
                                                              4 * sizeof(float), quads->getNumCoords());
-        for (Index i = 0; i < quads->getNumCoords(); ++i) {
-            vertices[i].x = quads->x()[i];
-            vertices[i].y = quads->y()[i];
-            vertices[i].z = quads->z()[i];
-        }
+        copyVertices(vertices, quads);
 
 
         //data->indexBuffer = new Triangle[numElem];
@@ -190,11 +142,7 @@ RayRenderObject::RayRenderObject(RTCDevice device, int senderId, const std::stri
 
         Vertex *vertices = (Vertex *)rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
                                                              4 * sizeof(float), tri->getNumCoords());
-        for (Index i = 0; i < tri->getNumCoords(); ++i) {
-            vertices[i].x = tri->x()[i];
-            vertices[i].y = tri->y()[i];
-            vertices[i].z = tri->z()[i];
-        }
+        copyVertices(vertices, tri);
 
 
         //data->indexBuffer = new Triangle[numElem];
@@ -235,11 +183,7 @@ RayRenderObject::RayRenderObject(RTCDevice device, int senderId, const std::stri
 
         Vertex *vertices = (Vertex *)rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
                                                              4 * sizeof(float), poly->getNumCoords());
-        for (Index i = 0; i < poly->getNumCoords(); ++i) {
-            vertices[i].x = poly->x()[i];
-            vertices[i].y = poly->y()[i];
-            vertices[i].z = poly->z()[i];
-        }
+        copyVertices(vertices, poly);
 
         Index ntri = 0;
         for (Index i = 0; i < poly->getNumElements(); ++i) {
@@ -295,12 +239,13 @@ RayRenderObject::RayRenderObject(RTCDevice device, int senderId, const std::stri
             s[i].p.x = x[i];
             s[i].p.y = y[i];
             s[i].p.z = z[i];
-            s[i].r = r ? r[i] : pointSize;
+            s[i].r = r ? r[i] : RayRenderObject::pointSize;
         }
         if (r) {
             useNormals = false;
         } else {
             data->lighted = 0;
+            pointSize = RayRenderObject::pointSize;
         }
         geom = newSpheres(data.get(), np);
     } else if (auto line = Lines::as(geometry)) {
@@ -335,7 +280,7 @@ RayRenderObject::RayRenderObject(RTCDevice device, int senderId, const std::stri
                 s[idx].p.x = x[i];
                 s[idx].p.y = y[i];
                 s[idx].p.z = z[i];
-                s[idx].r = r ? r[i] : pointSize;
+                s[idx].r = r ? r[i] : RayRenderObject::pointSize;
 
                 p[idx] = ispc::PFNone;
                 if (i == begin) {
@@ -381,22 +326,13 @@ RayRenderObject::RayRenderObject(RTCDevice device, int senderId, const std::stri
             useNormals = false;
         } else {
             data->lighted = 0;
+            pointSize = RayRenderObject::pointSize;
         }
         geom = newTubes(data.get(), nPoints - 1);
     }
 
     if (geom) {
-        if (this->normals && useNormals) {
-            if (this->normals->guessMapping(geometry) == DataBase::Element)
-                data->normalsPerPrimitiveMapping = 1;
-
-            for (int c = 0; c < 3; ++c) {
-                data->normals[c] = &this->normals->x(c)[0];
-            }
-        }
-
         data->geomID = rtcAttachGeometry(data->scene, geom);
-        rtcReleaseGeometry(geom);
         rtcCommitGeometry(geom);
 
         std::cerr << "added geom " << (data->indexBuffer ? "with" : "without") << " indexbuffer" << std::endl;
@@ -405,17 +341,162 @@ RayRenderObject::RayRenderObject(RTCDevice device, int senderId, const std::stri
     rtcCommitScene(data->scene);
 }
 
-RayRenderObject::~RayRenderObject()
+RayGeometry::~RayGeometry()
 {
     delete[] data->spheres;
     delete[] data->primitiveFlags;
-    if (data->scene && data->geomID != RTC_INVALID_GEOMETRY_ID) {
-        rtcDetachGeometry(data->scene, data->geomID);
+    if (geom)
+        rtcReleaseGeometry(geom);
+    if (data->scene) {
+        if (data->geomID != RTC_INVALID_GEOMETRY_ID)
+            rtcDetachGeometry(data->scene, data->geomID);
         rtcReleaseScene(data->scene);
     }
-    //delete[] data->indexBuffer;
 }
 
+std::string RayGeometry::topologyKey(Object::const_ptr geometry)
+{
+    std::string key;
+    if (auto quads = Quads::as(geometry)) {
+        key = "quads:" + arrayKey(quads->d()->cl) + ":" + arrayKey(quads->d()->ghost);
+    } else if (auto tri = Triangles::as(geometry)) {
+        key = "triangles:" + arrayKey(tri->d()->cl) + ":" + arrayKey(tri->d()->ghost);
+    } else if (auto poly = Polygons::as(geometry)) {
+        key = "polygons:" + arrayKey(poly->d()->el) + ":" + arrayKey(poly->d()->cl) + ":" + arrayKey(poly->d()->ghost);
+    } else {
+        return key;
+    }
+    auto coords = Coords::as(geometry);
+    key += ":" + std::to_string(coords->getNumCoords());
+    return key;
+}
+
+bool RayGeometry::refit(Object::const_ptr geo)
+{
+    if (!geom || topology.empty() || topologyKey(geo) != topology)
+        return false;
+    auto coords = Coords::as(geo);
+    if (!coords)
+        return false;
+
+    auto *vertices = (Vertex *)rtcGetGeometryBufferData(geom, RTC_BUFFER_TYPE_VERTEX, 0);
+    copyVertices(vertices, coords);
+    rtcUpdateGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0);
+    rtcSetGeometryBuildQuality(geom, RTC_BUILD_QUALITY_REFIT);
+    rtcCommitGeometry(geom);
+    rtcSetSceneFlags(data->scene, RTC_SCENE_FLAG_DYNAMIC);
+    rtcSetSceneBuildQuality(data->scene, RTC_BUILD_QUALITY_LOW);
+    rtcCommitScene(data->scene);
+
+    geometry = geo;
+    return true;
+}
+
+
+RayRenderObject::RayRenderObject(RTCDevice device, std::shared_ptr<RayGeometry> rayGeometry, int senderId,
+                                 const std::string &senderPort, Object::const_ptr container, Object::const_ptr geometry,
+                                 Object::const_ptr normals, Object::const_ptr texture)
+: vistle::RenderObject(senderId, senderPort, container, geometry, normals, texture)
+, rayGeometry(rayGeometry)
+, data(new ispc::RenderObjectData)
+{
+    updateBounds();
+
+    data->device = device;
+    data->scene = nullptr;
+    data->geomID = RTC_INVALID_GEOMETRY_ID;
+    data->instID = RTC_INVALID_GEOMETRY_ID;
+    data->spheres = nullptr;
+    data->primitiveFlags = nullptr;
+    data->indexBuffer = nullptr;
+    data->triangles = 1;
+    data->texCoords = nullptr;
+    data->lighted = 1;
+    data->hasSolidColor = hasSolidColor;
+    data->perPrimitiveMapping = 0;
+    data->normalsPerPrimitiveMapping = 0;
+    data->cmap = nullptr;
+    for (int c = 0; c < 3; ++c) {
+        data->normalTransform[c].x = c == 0 ? 1 : 0;
+        data->normalTransform[c].y = c == 1 ? 1 : 0;
+        data->normalTransform[c].z = c == 2 ? 1 : 0;
+    }
+    for (int c = 0; c < 3; ++c) {
+        data->normals[c] = nullptr;
+    }
+    for (int c = 0; c < 4; ++c) {
+        data->solidColor[c] = solidColor[c];
+    }
+    if (this->mapdata) {
+        if (this->mapdata->guessMapping(geometry) == DataBase::Element)
+            data->perPrimitiveMapping = 1;
+    }
+    if (auto t = Texture1D::as(this->mapdata)) {
+        data->texCoords = &t->coords()[0];
+
+        cmap.reset(new ispc::ColorMapData);
+        data->cmap = cmap.get();
+        data->cmap->texData = t->pixels().data();
+        data->cmap->texWidth = t->getWidth();
+        // texcoords as computed by Color module are between 0 and 1
+        data->cmap->min = 0.;
+        data->cmap->max = 1.;
+        data->cmap->blendWithMaterial = 0;
+
+        std::cerr << "texcoords from texture" << std::endl;
+    } else if (auto s = Vec<Scalar, 1>::as(this->mapdata)) {
+        data->texCoords = &s->x()[0];
+
+        std::cerr << "texcoords from scalar field" << std::endl;
+
+    } else if (auto vec = Vec<Scalar, 3>::as(this->mapdata)) {
+        tcoord.resize(vec->getSize());
+        data->texCoords = tcoord.data();
+        const Scalar *x = &vec->x()[0];
+        const Scalar *y = &vec->y()[0];
+        const Scalar *z = &vec->z()[0];
+        for (auto it = tcoord.begin(); it != tcoord.end(); ++it) {
+            *it = sqrtf(*x * *x + *y * *y + *z * *z);
+            ++x;
+            ++y;
+            ++z;
+        }
+    } else if (auto iscal = Vec<Index>::as(this->mapdata)) {
+        tcoord.resize(iscal->getSize());
+        data->texCoords = tcoord.data();
+        vistle::Scalar *d = tcoord.data();
+        for (const Index *i = &iscal->x()[0], *end = i + iscal->getSize(); i < end; ++i) {
+            *d++ = *i;
+        }
+    }
+
+    if (!rayGeometry || !rayGeometry->data->scene) {
+        return;
+    }
+
+    // geometry is shared, only the mapped data is specific to this object
+    const auto *geo = rayGeometry->data.get();
+    data->scene = geo->scene;
+    data->geomID = geo->geomID;
+    data->indexBuffer = geo->indexBuffer;
+    data->spheres = geo->spheres;
+    data->primitiveFlags = geo->primitiveFlags;
+    data->triangles = geo->triangles;
+    data->lighted = geo->lighted;
+
+    if (this->normals && rayGeometry->useNormals) {
+        if (this->normals->guessMapping(geometry) == DataBase::Element)
+            data->normalsPerPrimitiveMapping = 1;
+
+        for (int c = 0; c < 3; ++c) {
+            data->normals[c] = &this->normals->x(c)[0];
+        }
+    }
+}
+
+RayRenderObject::~RayRenderObject()
+{}
+
 void RayColorMap::deinit()
 {
     if (cmap) {
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 
 #include <vistle/core/vector.h>
 #include <vistle/core/object.h>
@@ -23,15 +24,35 @@ struct RayColorMap {
     std::shared_ptr<ispc::ColorMapData> cmap;
 };
 
+//! Embree scene built for a geometry object, shared by all render objects referring to the same geometry
+struct RayGeometry {
+    RayGeometry(RTCDevice device, vistle::Object::const_ptr geometry);
+    ~RayGeometry();
+
+    //! identifies meshes sharing their connectivity, empty if geometry cannot be refitted
+    static std::string topologyKey(vistle::Object::const_ptr geometry);
+    //! take over vertices from geometry with identical topology and refit the BVH instead of rebuilding it
+    bool refit(vistle::Object::const_ptr geometry);
+
+    vistle::Object::const_ptr geometry;
+    std::string topology;
+    float pointSize = -1.f; //!< point size used for building, negative if it does not matter
+    bool useNormals = true;
+    RTCGeometry geom = nullptr;
+    std::unique_ptr<ispc::RenderObjectData> data; //!< geometry related members, user data for spheres and tubes
+};
+
 struct RayRenderObject: public vistle::RenderObject {
     static float pointSize;
 
-    RayRenderObject(RTCDevice device, int senderId, const std::string &senderPort, vistle::Object::const_ptr container,
+    RayRenderObject(RTCDevice device, std::shared_ptr<RayGeometry> rayGeometry, int senderId,
+                    const std::string &senderPort, vistle::Object::const_ptr container,
                     vistle::Object::const_ptr geometry, vistle::Object::const_ptr normals,
                     vistle::Object::const_ptr texture);
 
     ~RayRenderObject();
 
+    std::shared_ptr<RayGeometry> rayGeometry;
     std::unique_ptr<ispc::RenderObjectData> data;
     std::unique_ptr<ispc::ColorMapData> cmap;
     std::vector<vistle::Scalar> tcoord;
@@ -550,6 +550,8 @@ OSGRenderer::OSGRenderer(const std::string &name, int moduleID, mpi::communicato
     setParameterRange(m_async, (vistle::Integer)0, (vistle::Integer)MaxAsyncFrames);
     setCurrentParameterGroup("");
 
+    enableLevelOfDetail();
+
     setRealizeOperation(new EnableGLDebugOperation());
 
     displaySettings = new osg::DisplaySettings;
@@ -713,6 +715,13 @@ bool OSGRenderer::render()
     int t = m_renderManager.timestep();
     timesteps->setTimestep(t);
 
+    const bool useLod = levelOfDetailEnabled() && m_renderManager.interacting();
+    if (useLod != m_useLod) {
+        m_useLod = useLod;
+        for (auto &ro: m_lodObjects)
+            showLevelOfDetail(*ro);
+    }
+
     if (m_renderManager.numViews() != m_viewData.size()) {
         setParameterRange(m_visibleView, (vistle::Integer)-1, (vistle::Integer)(m_renderManager.numViews()) - 1);
 
@@ -849,10 +858,44 @@ std::shared_ptr<vistle::RenderObject> OSGRenderer::addObject(int senderId, const
 void OSGRenderer::removeObject(std::shared_ptr<vistle::RenderObject> ro)
 {
     auto oro = std::static_pointer_cast<OsgRenderObject>(ro);
+    if (auto lod = std::static_pointer_cast<OsgRenderObject>(oro->lod)) {
+        timesteps->removeObject(lod->node, lod->timestep);
+        m_lodObjects.erase(oro);
+        oro->lod.reset();
+    }
     timesteps->removeObject(oro->node, oro->timestep);
     m_renderManager.removeObject(ro);
 }
 
+std::shared_ptr<vistle::RenderObject> OSGRenderer::addLevelOfDetail(std::shared_ptr<vistle::RenderObject> ro,
+                                                                    vistle::Object::const_ptr geometry,
+                                                                    vistle::Object::const_ptr texture)
+{
+    auto oro = std::static_pointer_cast<OsgRenderObject>(ro);
+    VistleGeometryGenerator gen(ro, geometry, nullptr, texture);
+    auto geode = gen(defaultState);
+    if (!geode)
+        return nullptr;
+
+    auto lod = std::make_shared<OsgRenderObject>(oro->senderId, oro->senderPort, oro->container, geometry, nullptr,
+                                                 texture, geode);
+    timesteps->addObject(geode, lod->timestep);
+    oro->lod = lod;
+    m_lodObjects.insert(oro);
+    showLevelOfDetail(*oro);
+    if (m_useLod)
+        m_renderManager.setModified();
+
+    return lod;
+}
+
+void OSGRenderer::showLevelOfDetail(OsgRenderObject &ro)
+{
+    auto lod = std::static_pointer_cast<OsgRenderObject>(ro.lod);
+    ro.node->setNodeMask(m_useLod ? 0 : ~0u);
+    lod->node->setNodeMask(m_useLod ? ~0u : 0);
+}
+
 OsgRenderObject::OsgRenderObject(int senderId, const std::string &senderPort, vistle::Object::const_ptr container,
                                  vistle::Object::const_ptr geometry, vistle::Object::const_ptr normals,
                                  vistle::Object::const_ptr texture, osg::ref_ptr<osg::Node> node)
@@ -95,6 +95,10 @@ private:
                                                     vistle::Object::const_ptr normals,
                                                     vistle::Object::const_ptr texture) override;
     void removeObject(std::shared_ptr<vistle::RenderObject> ro) override;
+    std::shared_ptr<vistle::RenderObject> addLevelOfDetail(std::shared_ptr<vistle::RenderObject> ro,
+                                                           vistle::Object::const_ptr geometry,
+                                                           vistle::Object::const_ptr texture) override;
+    void showLevelOfDetail(OsgRenderObject &ro);
     bool changeParameter(const vistle::Parameter *p) override;
 
     bool render() override;
@@ -118,6 +122,8 @@ private:
     osg::ref_ptr<osg::StateSet> rootState;
 
     osg::ref_ptr<TimestepHandler> timesteps;
+    std::set<std::shared_ptr<OsgRenderObject>> m_lodObjects; //< objects with a simplified representation
+    bool m_useLod = false;
     std::vector<osg::ref_ptr<osg::LightSource>> lights;
     OpenThreads::Mutex *icetMutex;
     size_t m_numViewsToComposite, m_numFramesToComposite;
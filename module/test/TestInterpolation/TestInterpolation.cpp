@@ -5,9 +5,11 @@
 #include <vistle/core/vec.h>
 #include <vistle/core/uniformgrid.h>
 #include <vistle/core/rectilineargrid.h>
+#include <vistle/core/unstr.h>
 #include "TestInterpolation.h"
 #include <vistle/util/enum.h>
 #include <random>
+#include <cmath>
 
 MODULE_MAIN(TestInterpolation)
 
@@ -73,12 +75,15 @@ bool TestInterpolation::compute()
     Vector3 min = bounds.first, max = bounds.second;
     std::vector<Scalar> xx, yy, zz;
     const Scalar *x = nullptr, *y = nullptr, *z = nullptr;
+    Index numVertices = 0;
     if (auto v3 = Vec<Scalar, 3>::as(grid->object())) {
+        numVertices = v3->getSize();
         x = &v3->x()[0];
         y = &v3->y()[0];
         z = &v3->z()[0];
     } else if (auto uni = UniformGrid::as(grid->object())) {
         const Index nvert = uni->getNumDivisions(0) * uni->getNumDivisions(1) * uni->getNumDivisions(2);
+        numVertices = nvert;
         xx.resize(nvert);
         yy.resize(nvert);
         zz.resize(nvert);
@@ -106,6 +111,7 @@ bool TestInterpolation::compute()
         }
     } else if (auto rect = RectilinearGrid::as(grid->object())) {
         const Index nvert = rect->getNumDivisions(0) * rect->getNumDivisions(1) * rect->getNumDivisions(2);
+        numVertices = nvert;
         xx.resize(nvert);
         yy.resize(nvert);
         zz.resize(nvert);
@@ -130,6 +136,8 @@ bool TestInterpolation::compute()
 
     Index numChecked = 0;
     Scalar squaredError = 0;
+    std::vector<Vector3> points;
+    std::vector<Index> cells;
     for (Index i = 0; i < count; ++i) {
         Vector3 point(randpoint(min, max));
         Index idx = grid->findCell(point);
@@ -142,11 +150,48 @@ bool TestInterpolation::compute()
                 std::cerr << "point: " << point.transpose() << ", recons: " << p.transpose() << std::endl;
             }
             squaredError += d2;
+            points.push_back(point);
+            cells.push_back(idx);
         }
     }
     std::cerr << "block " << grid->object()->getBlock() << ", bounds: min " << min.transpose() << ", max "
               << max.transpose() << ", checked: " << numChecked << ", avg error: " << squaredError / numChecked
               << std::endl;
 
+    // batched interpolation has to reproduce affine fields: compare to analytic values instead of the per-point path,
+    // which shares the interpolation kernels
+    Index numDiffering = 0;
+    if (mode == GridInterface::Linear) {
+        const Vector3 grad(2, -3, 0.5);
+        auto affine = [&grad](const Vector3 &p) -> Scalar { return grad.dot(p) + Scalar(1); };
+        std::vector<Scalar> f(numVertices);
+        for (Index v = 0; v < numVertices; ++v) {
+            f[v] = affine(Vector3(x[v], y[v], z[v]));
+        }
+        const Scalar tol = Scalar(1e-4) * (max - min).norm();
+        const Scalar ftol = tol * grad.norm();
+
+        auto unstr = UnstructuredGrid::as(grid->object());
+        auto interpols = grid->getInterpolators(points.size(), cells.data(), points.data(), DataBase::Vertex, mode);
+        for (Index i = 0; i < points.size(); ++i) {
+            if (unstr && unstr->tl()[cells[i]] == UnstructuredGrid::POLYHEDRON) {
+                // not interpolated linearly
+                continue;
+            }
+            const Vector3 p = interpols(i, x, y, z);
+            const Scalar v = interpols(i, f.data());
+            if ((p - points[i]).norm() > tol || std::abs(v - affine(points[i])) > ftol) {
+                std::cerr << "point: " << points[i].transpose() << ", batched: " << p.transpose()
+                          << ", field: " << affine(points[i]) << ", batched: " << v << std::endl;
+                ++numDiffering;
+            }
+        }
+    }
+    if (numDiffering > 0) {
+        sendError("block %d: batched interpolation is wrong for %d points", (int)grid->object()->getBlock(),
+                  (int)numDiffering);
+        return false;
+    }
+
     return true;
 }
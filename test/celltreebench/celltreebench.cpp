@@ -0,0 +1,308 @@
+// compare build time and point location cost of celltree split modes and of the builder they replaced
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vistle/core/shm.h>
+#include <vistle/core/celltree.h>
+#include <vistle/core/cellalgorithm.h>
+#include <vistle/util/stopwatch.h>
+
+using namespace vistle;
+
+typedef Celltree3 CT;
+
+namespace {
+
+struct CountingLeafFunctor: public CT::LeafFunctor {
+    CountingLeafFunctor(const CT::AABB *bounds, const Vector3 &point): m_bounds(bounds), m_point(point) {}
+
+    bool operator()(Index elem)
+    {
+        ++visited;
+        const auto &b = m_bounds[elem];
+        for (int d = 0; d < 3; ++d) {
+            if (m_point[d] < b.min(d) || m_point[d] > b.max(d))
+                return true;
+        }
+        ++hits;
+        return true; // find all candidates
+    }
+
+    const CT::AABB *m_bounds = nullptr;
+    Vector3 m_point;
+    Index visited = 0;
+    Index hits = 0;
+};
+
+// celltree builder as it was before subtrees were refined as tasks on a ThreadPool:
+// up to half of the cores poll a shared queue of nodes, which are binned into 7 buckets serially
+class BaselineBuilder {
+public:
+    BaselineBuilder(CT &ct, const CT::AABB *bounds): m_ct(ct), m_bounds(bounds) {}
+
+    void build(const Vector3 &gmin, const Vector3 &gmax)
+    {
+        for (int i = 0; i < 3; ++i) {
+            m_ct.min()[i] = gmin[i];
+            m_ct.max()[i] = gmax[i];
+        }
+        m_ct.nodes().reserve(m_ct.cells().size() / MaxLeafSize);
+        m_nodesToSplit.emplace_front(0, m_ct.nodes()[0].start, m_ct.nodes()[0].size);
+
+        std::deque<std::thread> threads;
+        std::unique_lock<std::mutex> guard(m_mutex);
+        while (m_numWorking > 0 || !m_nodesToSplit.empty()) {
+            guard.unlock();
+            if (m_numRunning < (std::thread::hardware_concurrency() + 1) / 2) {
+                threads.emplace_back([this]() { work(); });
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            guard.lock();
+        }
+        guard.unlock();
+        for (auto &t: threads)
+            t.join();
+    }
+
+private:
+    static const int NumBuckets = 7;
+    static const Index MaxLeafSize = 32;
+
+    struct NodeData {
+        NodeData(Index node, Index start, Index size): node(node), start(start), size(size) {}
+        Index node, start, size;
+    };
+
+    void work()
+    {
+        const unsigned maxidlecount = 5;
+        unsigned idlecount = 0;
+        ++m_numRunning;
+        do {
+            std::unique_lock<std::mutex> guard(m_mutex);
+            while (!m_nodesToSplit.empty()) {
+                idlecount = 0;
+                auto n = m_nodesToSplit.front();
+                m_nodesToSplit.pop_front();
+                ++m_numWorking;
+                guard.unlock();
+                refine(n);
+                guard.lock();
+                --m_numWorking;
+            }
+            guard.unlock();
+            ++idlecount;
+            if (m_numWorking == 0)
+                continue;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10 * idlecount));
+        } while (idlecount < maxidlecount && m_numWorking > 0);
+        --m_numRunning;
+    }
+
+    void refine(const NodeData &nodeData)
+    {
+        const Scalar smax = std::numeric_limits<Scalar>::max();
+        const Index start = nodeData.start;
+        const Index size = nodeData.size;
+        if (size <= MaxLeafSize)
+            return;
+
+        Index *cells = m_ct.cells().data();
+        const CT::AABB *bounds = m_bounds;
+        auto center = [bounds](int d, Index cell) {
+            return Scalar(0.5) * (bounds[cell].min(d) + bounds[cell].max(d));
+        };
+
+        Vector3 cmin(smax, smax, smax), cmax(-smax, -smax, -smax);
+        for (Index i = start; i < start + size; ++i) {
+            for (int d = 0; d < 3; ++d) {
+                cmin[d] = std::min(cmin[d], center(d, cells[i]));
+                cmax[d] = std::max(cmax[d], center(d, cells[i]));
+            }
+        }
+
+        const Vector3 crange = cmax - cmin;
+        const Vector3 crangeI = crange.cwiseInverse() * NumBuckets;
+        auto getBucket = [cmin, crangeI](Scalar center, int d) -> int {
+            return std::min(int((center - cmin[d]) * crangeI[d]), NumBuckets - 1);
+        };
+
+        Index bucket[NumBuckets][3];
+        Vector3 bmin[NumBuckets], bmax[NumBuckets];
+        for (int b = 0; b < NumBuckets; ++b) {
+            for (int d = 0; d < 3; ++d)
+                bucket[b][d] = 0;
+            bmin[b].fill(smax);
+            bmax[b].fill(-smax);
+        }
+        for (Index i = start; i < start + size; ++i) {
+            const Index cell = cells[i];
+            for (int d = 0; d < 3; ++d) {
+                if (crange[d] == 0)
+                    continue;
+                const int b = getBucket(center(d, cell), d);
+                ++bucket[b][d];
+                bmin[b][d] = std::min(bmin[b][d], bounds[cell].min(d));
+                bmax[b][d] = std::max(bmax[b][d], bounds[cell].max(d));
+            }
+        }
+        for (int d = 0; d < 3; ++d) {
+            if (crange[d] == 0)
+                continue;
+            for (int b = NumBuckets - 2; b >= 0; --b)
+                bmin[b][d] = std::min(bmin[b][d], bmin[b + 1][d]);
+            for (int b = 1; b < NumBuckets; ++b)
+                bmax[b][d] = std::max(bmax[b][d], bmax[b - 1][d]);
+        }
+
+        Scalar min_weight(smax);
+        int best_dim = -1, best_bucket = -1;
+        for (int d = 0; d < 3; ++d) {
+            if (crange[d] == 0)
+                continue;
+            Index nleft = 0;
+            for (int split_b = 0; split_b < NumBuckets - 1; ++split_b) {
+                nleft += bucket[split_b][d];
+                const Index nright = size - nleft;
+                Scalar weight = std::pow(float(nleft) / float(size), 2.f) * (bmax[split_b][d] - bmin[0][d]) +
+                                std::pow(float(nright) / float(size), 2.f) *
+                                    (bmax[NumBuckets - 1][d] - bmin[split_b + 1][d]);
+                weight /= crange[d];
+                if (nleft > 0 && nright > 0 && weight < min_weight) {
+                    min_weight = weight;
+                    best_dim = d;
+                    best_bucket = split_b;
+                }
+            }
+        }
+
+        Index nleft = 0;
+        Scalar Lmax = -smax, Rmin = smax;
+        if (best_dim == -1) {
+            crange.maxCoeff(&best_dim);
+            nleft = size / 2;
+            auto less = [center, best_dim](Index a, Index b) {
+                return center(best_dim, a) < center(best_dim, b);
+            };
+            std::nth_element(&cells[start], &cells[start + nleft], &cells[start + size], less);
+            for (Index i = start; i < start + nleft; ++i)
+                Lmax = std::max(Lmax, bounds[cells[i]].max(best_dim));
+            for (Index i = start + nleft; i < start + size; ++i)
+                Rmin = std::min(Rmin, bounds[cells[i]].min(best_dim));
+        } else {
+            auto mid = std::partition(&cells[start], &cells[start + size], [&](Index c) {
+                return getBucket(center(best_dim, c), best_dim) <= best_bucket;
+            });
+            nleft = mid - &cells[start];
+            Lmax = bmax[best_bucket][best_dim];
+            Rmin = bmin[best_bucket + 1][best_dim];
+        }
+
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto &nodes = m_ct.nodes();
+        nodes[nodeData.node] = CT::Node(best_dim, Lmax, Rmin, nodes.size());
+        Index l = nodes.size();
+        nodes.push_back(CT::Node(start, nleft));
+        Index r = nodes.size();
+        nodes.push_back(CT::Node(start + nleft, size - nleft));
+        m_nodesToSplit.emplace_front(l, start, nleft);
+        m_nodesToSplit.emplace_front(r, start + nleft, size - nleft);
+    }
+
+    CT &m_ct;
+    const CT::AABB *m_bounds = nullptr;
+    std::mutex m_mutex;
+    std::deque<NodeData> m_nodesToSplit;
+    std::atomic<unsigned> m_numRunning{0}, m_numWorking{0};
+};
+
+void bench(const char *name, bool baseline, CT::SplitMode mode, const std::vector<CT::AABB> &bounds,
+           const Vector3 &gmin, const Vector3 &gmax, const std::vector<Vector3> &queries)
+{
+    CT::ptr ct(new CT(bounds.size()));
+    double start = Clock::time();
+    if (baseline) {
+        BaselineBuilder builder(*ct, bounds.data());
+        builder.build(gmin, gmax);
+    } else {
+        ct->init(bounds.data(), gmin, gmax, mode);
+    }
+    double build = Clock::time() - start;
+
+    Index visited = 0, hits = 0;
+    start = Clock::time();
+    for (const auto &q: queries) {
+        PointVisitationFunctor<Scalar, Index> nodeFunc(q);
+        CountingLeafFunctor elemFunc(bounds.data(), q);
+        ct->traverse(nodeFunc, elemFunc);
+        visited += elemFunc.visited;
+        hits += elemFunc.hits;
+    }
+    double query = Clock::time() - start;
+
+    std::cerr << name << ": build " << build << " s, " << ct->nodes().size() << " nodes; " << queries.size()
+              << " queries " << query << " s, " << double(visited) / queries.size() << " cells tested, "
+              << double(hits) / queries.size() << " hits per query" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Index numCells = 1000000;
+    if (argc > 1) {
+        numCells = atol(argv[1]);
+    }
+    Index numQueries = 100000;
+    if (argc > 2) {
+        numQueries = atol(argv[2]);
+    }
+
+    vistle::registerTypes();
+
+    std::string shmname = "vistle_celltreebench";
+    vistle::Shm::create(shmname, 1, 0, true);
+
+    {
+        // cells of a perturbed regular grid with varying cell sizes
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<Scalar> uni(0, 1);
+        const Scalar extent = std::cbrt(Scalar(numCells));
+        std::vector<CT::AABB> bounds(numCells);
+        const Scalar smax = std::numeric_limits<Scalar>::max();
+        Vector3 gmin(smax, smax, smax), gmax(-smax, -smax, -smax);
+        for (auto &b: bounds) {
+            for (int d = 0; d < 3; ++d) {
+                Scalar c = uni(gen) * extent;
+                Scalar h = Scalar(0.5) * (Scalar(0.2) + uni(gen) * uni(gen) * 4);
+                b.mmin[d] = c - h;
+                b.mmax[d] = c + h;
+                gmin[d] = std::min(gmin[d], b.mmin[d]);
+                gmax[d] = std::max(gmax[d], b.mmax[d]);
+            }
+        }
+
+        std::vector<Vector3> queries(numQueries);
+        for (auto &q: queries) {
+            for (int d = 0; d < 3; ++d)
+                q[d] = gmin[d] + uni(gen) * (gmax[d] - gmin[d]);
+        }
+
+        std::cerr << numCells << " cells" << std::endl;
+        bench("baseline", true, CT::SplitBuckets, bounds, gmin, gmax, queries);
+        bench("buckets", false, CT::SplitBuckets, bounds, gmin, gmax, queries);
+        bench("SAH", false, CT::SplitSAH, bounds, gmin, gmax, queries);
+    }
+
+    vistle::Shm::remove(shmname, 0, 0, true);
+
+    return 0;
+}
@@ -80,6 +80,8 @@ int main()
             M(FILEQUERYRESULT, FileQueryResult)
             M(COVER, Cover)
             //M(INSITU, InSitu)
+            M(SHMINFO, ShmInfo)
+            M(TRACEDATA, TraceData)
 
         default: {
             std::cerr << i << " unhandled: " << type << std::endl;
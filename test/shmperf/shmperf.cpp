@@ -9,8 +9,11 @@
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/array.hpp>
 
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <vistle/core/shm_array.h>
@@ -124,12 +127,85 @@ namespace bi = boost::interprocess;
 
 using namespace vistle;
 
+// run f(begin, end) on all hardware threads, each working on a contiguous slice
+template<class F>
+double time_parallel(Index size, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    unsigned nthreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < nthreads; ++t) {
+        threads.emplace_back(f, Index(size * t / nthreads), Index(size * (t + 1) / nthreads));
+    }
+    for (auto &t: threads)
+        t.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// measure first touch and a streaming kernel for the page placement options of the shm segment
+void time_placement(const std::string &shmname, Index size)
+{
+    struct Config {
+        const char *name;
+        const char *hugepages;
+        const char *numa;
+    };
+    const Config configs[] = {
+        {"default", "0", "default"},
+        {"huge pages", "1", "default"},
+        {"numa local", "0", "local"},
+        {"huge pages+numa local", "1", "local"},
+        {"numa interleave", "0", "interleave"},
+        {"huge pages+numa interleave", "1", "interleave"},
+    };
+
+    const int repetitions = 10;
+    for (const auto &config: configs) {
+        setenv("VISTLE_SHM_HUGEPAGES", config.hugepages, 1);
+        setenv("VISTLE_SHM_NUMA", config.numa, 1);
+        vistle::Shm::remove(shmname, 1, 0, true);
+        auto &shm = vistle::Shm::create(shmname, 1, 0, true);
+        {
+            vistle::Vec<Scalar, 3> v(size);
+            Scalar *a = v.x().data(), *b = v.y().data(), *c = v.z().data();
+            double touch = time_parallel(size, [a, b, c](Index begin, Index end) {
+                for (Index i = begin; i < end; ++i) {
+                    a[i] = 0;
+                    b[i] = i;
+                    c[i] = 2 * i;
+                }
+            });
+            double triad = 0;
+            for (int r = 0; r < repetitions; ++r) {
+                triad += time_parallel(size, [a, b, c](Index begin, Index end) {
+                    for (Index i = begin; i < end; ++i) {
+                        a[i] = b[i] + Scalar(0.5) * c[i];
+                    }
+                });
+            }
+            triad /= repetitions;
+            std::cerr << size << " " << config.name << " (huge pages: " << shm.hugePages()
+                      << ", numa: " << shm.numaPlacement() << ") first touch: " << touch << ", triad: " << triad
+                      << " (" << 3 * sizeof(Scalar) * size / triad * 1e-9 << " GB/s)" << std::endl;
+        }
+        shm.detach();
+    }
+    vistle::Shm::remove(shmname, 1, 0, true);
+}
+
 int main(int argc, char *argv[])
 {
     vistle::registerTypes();
 
     std::string shmname = "vistle_vectortest";
 
+    if (argc > 1 && std::string(argv[1]) == "placement") {
+        // vistle_shmperf placement [shift]
+        int shift = argc > 2 ? atoi(argv[2]) : 26;
+        time_placement(shmname, 1L << shift);
+        return 0;
+    }
+
     int shift = 24;
     if (argc > 1) {
         shift = atoi(argv[1]);
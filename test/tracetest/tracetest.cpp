@@ -0,0 +1,158 @@
+#include <vistle/core/pipelinetrace.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace vistle;
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string &what)
+{
+    if (!ok) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+bool near(double a, double b)
+{
+    return std::abs(a - b) < 1e-9;
+}
+
+TraceSpan span(TraceSpan::Kind kind, int module, int rank, double begin, double end, int thread = 1)
+{
+    TraceSpan s;
+    s.kind = kind;
+    s.module = module;
+    s.rank = rank;
+    s.thread = thread;
+    s.begin = begin;
+    s.end = end;
+    return s;
+}
+
+// reader (1) -> filter (2) -> renderer (3), on two ranks
+std::vector<TraceSpan> pipeline()
+{
+    std::vector<TraceSpan> spans;
+
+    spans.push_back(span(TraceSpan::Prepare, 1, 0, 0.0, 0.1));
+    spans.push_back(span(TraceSpan::Compute, 1, 0, 0.1, 1.0));
+    spans.push_back(span(TraceSpan::Reduce, 1, 0, 1.0, 1.1));
+    spans.push_back(span(TraceSpan::Prepare, 1, 1, 0.0, 0.1));
+    spans.push_back(span(TraceSpan::Compute, 1, 1, 0.1, 2.0));
+    spans.push_back(span(TraceSpan::Reduce, 1, 1, 2.0, 2.1));
+
+    spans.push_back(span(TraceSpan::Prepare, 2, 0, 2.1, 2.2));
+    spans.push_back(span(TraceSpan::Compute, 2, 0, 2.2, 3.0));
+    spans.push_back(span(TraceSpan::Block, 2, 0, 2.3, 2.8, 2));
+    spans.push_back(span(TraceSpan::Block, 2, 0, 2.4, 2.9, 3));
+    spans.push_back(span(TraceSpan::Wait, 2, 0, 3.0, 3.5));
+    spans.push_back(span(TraceSpan::Reduce, 2, 0, 3.5, 4.0));
+    spans.push_back(span(TraceSpan::Prepare, 2, 1, 2.1, 2.2));
+    spans.push_back(span(TraceSpan::Compute, 2, 1, 2.2, 2.5));
+    spans.push_back(span(TraceSpan::Reduce, 2, 1, 2.5, 3.9));
+
+    spans.push_back(span(TraceSpan::Transfer, 3, 0, 3.9, 4.05));
+    spans.push_back(span(TraceSpan::Prepare, 3, 0, 4.0, 4.1));
+    spans.push_back(span(TraceSpan::Compute, 3, 0, 4.1, 5.0));
+    spans.push_back(span(TraceSpan::Reduce, 3, 0, 5.0, 5.5));
+
+    return spans;
+}
+
+std::set<int> upstream(int module)
+{
+    if (module > 1)
+        return {module - 1};
+    return {};
+}
+
+void testCriticalPath()
+{
+    check(criticalPath(std::vector<TraceSpan>(), upstream).empty(), "no critical path without spans");
+
+    auto path = criticalPath(pipeline(), upstream);
+    check(path.size() == 3, "critical path covers all modules");
+    if (path.size() != 3)
+        return;
+
+    // reader finished last on rank 1
+    check(path[0].module == 1 && path[0].rank == 1, "reader gated by rank 1");
+    check(near(path[0].begin, 0.0) && near(path[0].end, 2.1), "reader execution interval");
+    check(near(path[0].busy, 2.1), "reader busy time");
+
+    // filter finished last on rank 0, overlapping blocks are counted once
+    check(path[1].module == 2 && path[1].rank == 0, "filter gated by rank 0");
+    check(near(path[1].begin, 2.1) && near(path[1].end, 4.0), "filter execution interval");
+    check(near(path[1].busy, 1.4), "filter busy time");
+    check(near(path[1].waiting, 0.5), "filter waiting time");
+
+    check(path[2].module == 3 && path[2].rank == 0, "renderer ends pipeline");
+    check(near(path[2].busy, 1.5), "renderer busy time");
+    check(near(path[2].transfer, 0.15), "renderer transfer time");
+
+    // cyclic dependencies must not loop forever
+    auto cycle = criticalPath(pipeline(), [](int module) { return std::set<int>{module == 1 ? 3 : module - 1}; });
+    check(cycle.size() == 3, "critical path stops at modules already visited");
+}
+
+void testChromeTrace()
+{
+    auto spans = pipeline();
+    spans[1].name = "data \"with\" quotes\n";
+    std::map<int, std::string> names{{1, "Reader"}, {2, "Filter"}};
+    std::string json = toChromeTrace(spans, names);
+
+    auto contains = [&json](const std::string &s) {
+        return json.find(s) != std::string::npos;
+    };
+    check(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0, "trace header");
+    check(contains("\"name\":\"prepare\",\"cat\":\"prepare\",\"ph\":\"X\",\"ts\":0.000,\"dur\":100000.000"),
+          "complete event relative to first span in microseconds");
+    check(contains("\"name\":\"data \\\"with\\\" quotes\\u000a\",\"cat\":\"compute\""), "escaped span name");
+    check(contains("\"args\":{\"name\":\"hub 0 rank 1\"}"), "process name per rank");
+    check(contains("\"args\":{\"name\":\"Reader_1\"}"), "thread named after module");
+    check(contains("\"args\":{\"name\":\"Filter_2 blocks\"}"), "separate track for block tasks");
+    check(contains("\"args\":{\"name\":\"Module_3 transfers\"}"), "separate track for transfers of unnamed module");
+
+    int depth = 0;
+    bool balanced = true, quoted = false, escaped = false;
+    for (char c: json) {
+        if (escaped) {
+            escaped = false;
+        } else if (c == '\\') {
+            escaped = true;
+        } else if (c == '"') {
+            quoted = !quoted;
+        } else if (!quoted && (c == '{' || c == '[')) {
+            ++depth;
+        } else if (!quoted && (c == '}' || c == ']')) {
+            if (--depth < 0)
+                balanced = false;
+        }
+    }
+    check(balanced && depth == 0 && !quoted, "balanced JSON");
+
+    check(toChromeTrace(std::vector<TraceSpan>(), names) == "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n]}\n",
+          "empty trace");
+}
+
+} // namespace
+
+int main()
+{
+    testCriticalPath();
+    testChromeTrace();
+
+    if (failures > 0) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cerr << "test succeeded" << std::endl;
+    return EXIT_SUCCESS;
+}